@@ -28,6 +28,15 @@ include $(dir)/Rules.mk
 dir := $(d)/painter_cells
 include $(dir)/Rules.mk
 
+dir := $(d)/painter_save_restore_benchmark
+include $(dir)/Rules.mk
+
+dir := $(d)/painter_program_mode_benchmark
+include $(dir)/Rules.mk
+
+dir := $(d)/glyph_cache_benchmark
+include $(dir)/Rules.mk
+
 
 
 # Begin standard footer
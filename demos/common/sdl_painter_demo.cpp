@@ -218,6 +218,11 @@ sdl_painter_demo(const std::string &about_text,
                                "image_atlas_delayed_upload",
                                "if true delay uploading of data to GL from image atlas until atlas flush",
                                *this),
+  m_image_atlas_pixel_buffer_upload(m_image_atlas_params.use_pixel_buffer_upload(),
+                                    "image_atlas_pixel_buffer_upload",
+                                    "if true and image_atlas_delayed_upload is true, stage the uploads "
+                                    "of the image atlas through pixel buffer objects",
+                                    *this),
 
   m_glyph_atlas_options("Glyph Atlas options", *this),
   m_texel_store_width(m_glyph_atlas_params.texel_store_dimensions().x(),
@@ -235,6 +240,11 @@ sdl_painter_demo(const std::string &about_text,
                                "glyph_atlas_delayed_upload",
                                "if true delay uploading of data to GL from glyph atlas until atlas flush",
                                *this),
+  m_glyph_atlas_pixel_buffer_upload(m_glyph_atlas_params.use_pixel_buffer_upload(),
+                                    "glyph_atlas_pixel_buffer_upload",
+                                    "if true and glyph_atlas_delayed_upload is true, stage the uploads "
+                                    "of the glyph atlas through pixel buffer objects",
+                                    *this),
   m_glyph_geometry_backing_store_type(glyph_geometry_backing_store_auto,
                                       enumerated_string_type<enum glyph_geometry_backing_store_t>()
                                       .add_entry("buffer",
@@ -275,6 +285,11 @@ sdl_painter_demo(const std::string &about_text,
                                     "color_stop_atlas_delayed_upload",
                                     "if true delay uploading of data to GL from color stop atlas until atlas flush",
                                     *this),
+  m_color_stop_atlas_pixel_buffer_upload(m_colorstop_atlas_params.use_pixel_buffer_upload(),
+                                         "color_stop_atlas_pixel_buffer_upload",
+                                         "if true and color_stop_atlas_delayed_upload is true, stage the "
+                                         "uploads of the color stop atlas through pixel buffer objects",
+                                         *this),
 
   m_painter_options("PainterBackendGL Options", *this),
   m_painter_attributes_per_buffer(m_painter_params.attributes_per_buffer(),
@@ -291,6 +306,12 @@ sdl_painter_demo(const std::string &about_text,
                                    "painter_break_on_shader_change",
                                    "If true, different shadings are placed into different "
                                    "entries of a call to glMultiDrawElements", *this),
+  m_painter_reorder_window(m_painter_base_params.reorder_window(),
+                           "painter_reorder_window",
+                           "Number of draws the painter may hold back to reorder "
+                           "draws with non-overlapping clipping regions so that "
+                           "draws with the same shaders are adjacent; 0 or 1 "
+                           "disables reordering", *this),
   m_uber_vert_use_switch(m_painter_params.vert_shader_use_switch(),
                          "painter_uber_vert_use_switch",
                          "If true, use a switch statement in uber vertex shader dispatch",
@@ -319,6 +340,54 @@ sdl_painter_demo(const std::string &about_text,
                  "to which the Painter will draw, the value indicates the number of samples "
                  "to use for the backing store",
                  *this),
+  m_program_binary_cache_dir("", "program_binary_cache_dir",
+                             "If non-empty, directory (which must already exist) in which to "
+                             "store the binaries of the linked GLSL programs so that later "
+                             "runs can skip compiling and linking them",
+                             *this),
+  m_async_program_rebuild(m_painter_params.async_program_rebuild(),
+                          "async_program_rebuild",
+                          "If true, GLSL programs rebuilt because of shaders registered "
+                          "after the first frame are compiled and linked asynchronously "
+                          "and the previous programs are used until the new ones are ready",
+                          *this),
+  m_specialized_program_threshold(m_painter_params.specialized_program_threshold(),
+                                  "specialized_program_threshold",
+                                  "If non-zero, build GLSL programs specialized to a single item "
+                                  "shader for those item shaders drawn in at least this many draw "
+                                  "breaks instead of drawing everything with the uber-shader",
+                                  *this),
+  m_max_specialized_programs(m_painter_params.max_specialized_programs(),
+                             "max_specialized_programs",
+                             "Maximum number of GLSL programs specialized to a single item shader",
+                             *this),
+  m_persistent_buffer_segments(m_painter_params.persistent_buffer_segments(),
+                               "persistent_buffer_segments",
+                               "Number of segments, each holding the data of one draw, "
+                               "in each allocation of the persistently mapped ring buffers",
+                               *this),
+  m_deferred_resource_release(m_painter_params.deferred_resource_release(),
+                              "deferred_resource_release",
+                              "If true, queue the deletion of GL objects and execute the "
+                              "deletions at the end of each frame",
+                              *this),
+  m_resource_release_budget(m_painter_params.resource_release_budget(),
+                            "resource_release_budget",
+                            "Maximum number of GL objects deleted at the end of each frame "
+                            "when deferred_resource_release is true, 0 means no limit",
+                            *this),
+  m_compact_indices(m_painter_params.compact_indices(),
+                    "compact_indices",
+                    "If true, send the indices of each draw as 16-bit indices "
+                    "when the number of attributes of the draw allows",
+                    *this),
+  m_glyph_disk_cache_dir("", "glyph_disk_cache_dir",
+                         "If non-empty, directory in which to store the data of scalable "
+                         "glyphs so that later runs load it instead of generating it",
+                         *this),
+  m_glyph_disk_cache_size_mb(256, "glyph_disk_cache_size_mb",
+                             "Maximum size in MB of the files in glyph_disk_cache_dir",
+                             *this),
 
   m_painter_options_affected_by_context("PainterBackendGL Options that can be overridden "
                                         "by version and extension supported by GL/GLES context",
@@ -425,6 +494,25 @@ sdl_painter_demo(const std::string &about_text,
 	       "painter_blend_type",
 	       "specifies how the painter will perform blending",
 	       *this),
+  m_persistent_mapped_buffers(m_painter_params.persistent_mapped_buffers(),
+                              "persistent_mapped_buffers",
+                              "If true, stream the attribute, index and data store data through "
+                              "persistently mapped ring buffers guarded by fences instead of "
+                              "mapping buffers with glMapBufferRange for each draw; requires "
+                              "GL 4.4 or GL_ARB_buffer_storage",
+                              *this),
+  m_multi_draw_indirect(m_painter_params.multi_draw_indirect(),
+                        "multi_draw_indirect",
+                        "If true, draw the index ranges between state changes with "
+                        "glMultiDrawElementsIndirect; requires GL 4.3 or "
+                        "GL_ARB_multi_draw_indirect",
+                        *this),
+  m_gpu_timer_queries(m_painter_params.gpu_timer_queries(),
+                      "gpu_timer_queries",
+                      "If true, issue GL_TIMESTAMP queries around the draws of each PainterDraw "
+                      "and of each item shader; requires GL 3.3, GL_ARB_timer_query or "
+                      "GL_EXT_disjoint_timer_query",
+                      *this),
   m_demo_options("Demo Options", *this),
   m_print_painter_config(default_value_for_print_painter,
                          "print_painter_config",
@@ -466,7 +554,8 @@ init_gl(int w, int h)
     .log2_index_tile_size(m_log2_index_tile_size.m_value)
     .log2_num_index_tiles_per_row_per_col(m_log2_num_index_tiles_per_row_per_col.m_value)
     .num_index_layers(m_num_index_layers.m_value)
-    .delayed(m_image_atlas_delayed_upload.m_value);
+    .delayed(m_image_atlas_delayed_upload.m_value)
+    .use_pixel_buffer_upload(m_image_atlas_pixel_buffer_upload.m_value);
   m_image_atlas = FASTUIDRAWnew fastuidraw::gl::ImageAtlasGL(m_image_atlas_params);
 
   fastuidraw::ivec3 texel_dims(m_texel_store_width.m_value, m_texel_store_height.m_value, m_texel_store_num_layers.m_value);
@@ -474,7 +563,8 @@ init_gl(int w, int h)
     .texel_store_dimensions(texel_dims)
     .number_floats(m_geometry_store_size.m_value)
     .alignment(m_geometry_store_alignment.m_value)
-    .delayed(m_glyph_atlas_delayed_upload.m_value);
+    .delayed(m_glyph_atlas_delayed_upload.m_value)
+    .use_pixel_buffer_upload(m_glyph_atlas_pixel_buffer_upload.m_value);
 
   switch(m_glyph_geometry_backing_store_type.m_value.m_value)
     {
@@ -513,7 +603,8 @@ init_gl(int w, int h)
   m_colorstop_atlas_params
     .width(m_color_stop_atlas_width.m_value)
     .num_layers(m_color_stop_atlas_layers.m_value)
-    .delayed(m_color_stop_atlas_delayed_upload.m_value);
+    .delayed(m_color_stop_atlas_delayed_upload.m_value)
+    .use_pixel_buffer_upload(m_color_stop_atlas_pixel_buffer_upload.m_value);
 
   if (m_color_stop_atlas_use_optimal_width.m_value)
     {
@@ -541,7 +632,9 @@ init_gl(int w, int h)
         }
     }
 
-  m_painter_base_params.alignment(m_painter_alignment.m_value);
+  m_painter_base_params
+    .alignment(m_painter_alignment.m_value)
+    .reorder_window(m_painter_reorder_window.m_value);
   m_painter_params
     .image_atlas(m_image_atlas)
     .glyph_atlas(m_glyph_atlas)
@@ -565,11 +658,39 @@ init_gl(int w, int h)
     .default_stroke_shader_aa_type(m_provide_auxiliary_image_buffer.m_value.m_value != fastuidraw::glsl::PainterBackendGLSL::no_auxiliary_buffer?
                                    fastuidraw::PainterStrokeShader::cover_then_draw :
                                    fastuidraw::PainterStrokeShader::draws_solid_then_fuzz)
-    .blend_type(m_blend_type.m_value.m_value);
+    .blend_type(m_blend_type.m_value.m_value)
+    .async_program_rebuild(m_async_program_rebuild.m_value)
+    .specialized_program_threshold(m_specialized_program_threshold.m_value)
+    .max_specialized_programs(m_max_specialized_programs.m_value)
+    .persistent_mapped_buffers(m_persistent_mapped_buffers.m_value)
+    .persistent_buffer_segments(m_persistent_buffer_segments.m_value)
+    .multi_draw_indirect(m_multi_draw_indirect.m_value)
+    .deferred_resource_release(m_deferred_resource_release.m_value)
+    .resource_release_budget(m_resource_release_budget.m_value)
+    .gpu_timer_queries(m_gpu_timer_queries.m_value)
+    .compact_indices(m_compact_indices.m_value);
+
+  if (!m_program_binary_cache_dir.m_value.empty())
+    {
+      m_painter_params
+        .program_binary_cache(FASTUIDRAWnew fastuidraw::gl::ProgramBinaryCache(m_program_binary_cache_dir.m_value.c_str()));
+    }
 
   m_backend = FASTUIDRAWnew fastuidraw::gl::PainterBackendGL(m_painter_params, m_painter_base_params);
   m_painter = FASTUIDRAWnew fastuidraw::Painter(m_backend);
+
+  /* build the GLSL programs for the default shaders now
+   * instead of on the first frame.
+   */
+  m_backend->warm_up();
   m_glyph_cache = FASTUIDRAWnew fastuidraw::GlyphCache(m_painter->glyph_atlas());
+  if (!m_glyph_disk_cache_dir.m_value.empty())
+    {
+      uint64_t sz;
+
+      sz = uint64_t(m_glyph_disk_cache_size_mb.m_value) * 1024u * 1024u;
+      m_glyph_cache->disk_cache(FASTUIDRAWnew fastuidraw::GlyphDiskCache(m_glyph_disk_cache_dir.m_value.c_str(), sz));
+    }
   m_glyph_selector = FASTUIDRAWnew fastuidraw::GlyphSelector(m_glyph_cache);
   m_ft_lib = FASTUIDRAWnew fastuidraw::FreeTypeLib();
 
@@ -608,8 +729,21 @@ init_gl(int w, int h)
       LAZY_ENUM(default_stroke_shader_aa_type);
       LAZY_ENUM(blend_type);
       LAZY_ENUM(provide_auxiliary_image_buffer);
+      LAZY_ENUM(async_program_rebuild);
+      LAZY(specialized_program_threshold);
+      LAZY(max_specialized_programs);
+      LAZY_ENUM(persistent_mapped_buffers);
+      LAZY(persistent_buffer_segments);
+      LAZY_ENUM(multi_draw_indirect);
+      LAZY_ENUM(deferred_resource_release);
+      LAZY(resource_release_budget);
+      LAZY_ENUM(gpu_timer_queries);
+      LAZY_ENUM(compact_indices);
       std::cout << std::setw(40) << "alignment: " << std::setw(8) << m_backend->configuration_base().alignment()
                 << "  (requested " << m_painter_base_params.alignment()
+                << ")\n";
+      std::cout << std::setw(40) << "reorder_window: " << std::setw(8) << m_backend->configuration_base().reorder_window()
+                << "  (requested " << m_painter_base_params.reorder_window()
                 << ")\n\n\n";
 
       #undef LAZY
@@ -71,6 +71,7 @@ private:
   command_line_argument_value<int> m_log2_index_tile_size, m_log2_num_index_tiles_per_row_per_col;
   command_line_argument_value<int> m_num_index_layers;
   command_line_argument_value<bool> m_image_atlas_delayed_upload;
+  command_line_argument_value<bool> m_image_atlas_pixel_buffer_upload;
 
   /* Glyph atlas parameters
    */
@@ -79,6 +80,7 @@ private:
   command_line_argument_value<int> m_texel_store_num_layers, m_geometry_store_size;
   command_line_argument_value<int> m_geometry_store_alignment;
   command_line_argument_value<bool> m_glyph_atlas_delayed_upload;
+  command_line_argument_value<bool> m_glyph_atlas_pixel_buffer_upload;
   enumerated_command_line_argument_value<enum glyph_geometry_backing_store_t> m_glyph_geometry_backing_store_type;
   command_line_argument_value<int> m_glyph_geometry_backing_texture_log2_w, m_glyph_geometry_backing_texture_log2_h;
 
@@ -89,6 +91,7 @@ private:
   command_line_argument_value<bool> m_color_stop_atlas_use_optimal_width;
   command_line_argument_value<int> m_color_stop_atlas_layers;
   command_line_argument_value<bool> m_color_stop_atlas_delayed_upload;
+  command_line_argument_value<bool> m_color_stop_atlas_pixel_buffer_upload;
 
   /* Painter params
    */
@@ -97,12 +100,23 @@ private:
   command_line_argument_value<int> m_painter_indices_per_buffer;
   command_line_argument_value<int> m_painter_number_pools;
   command_line_argument_value<bool> m_painter_break_on_shader_change;
+  command_line_argument_value<unsigned int> m_painter_reorder_window;
   command_line_argument_value<bool> m_uber_vert_use_switch;
   command_line_argument_value<bool> m_uber_frag_use_switch;
   command_line_argument_value<bool> m_uber_blend_use_switch;
   command_line_argument_value<bool> m_unpack_header_and_brush_in_frag_shader;
   command_line_argument_value<bool> m_separate_program_for_discard;
   command_line_argument_value<unsigned int> m_painter_msaa;
+  command_line_argument_value<std::string> m_program_binary_cache_dir;
+  command_line_argument_value<bool> m_async_program_rebuild;
+  command_line_argument_value<unsigned int> m_specialized_program_threshold;
+  command_line_argument_value<unsigned int> m_max_specialized_programs;
+  command_line_argument_value<unsigned int> m_persistent_buffer_segments;
+  command_line_argument_value<bool> m_deferred_resource_release;
+  command_line_argument_value<unsigned int> m_resource_release_budget;
+  command_line_argument_value<bool> m_compact_indices;
+  command_line_argument_value<std::string> m_glyph_disk_cache_dir;
+  command_line_argument_value<unsigned int> m_glyph_disk_cache_size_mb;
 
   /* Painter params that can be overridden by properties of GL context
    */
@@ -116,6 +130,9 @@ private:
   command_line_argument_value<bool> m_assign_layout_to_varyings;
   command_line_argument_value<bool> m_assign_binding_points;
   enumerated_command_line_argument_value<enum fastuidraw::PainterBlendShader::shader_type> m_blend_type;
+  command_line_argument_value<bool> m_persistent_mapped_buffers;
+  command_line_argument_value<bool> m_multi_draw_indirect;
+  command_line_argument_value<bool> m_gpu_timer_queries;
 
   command_separator m_demo_options;
   command_line_argument_value<bool> m_print_painter_config;
@@ -162,9 +162,11 @@ GlyphSetGenerator::
 GlyphSetGenerator(fastuidraw::GlyphRender r,
                   fastuidraw::reference_counted_ptr<const fastuidraw::FontFreeType> f,
                   fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeFace> face,
-                  std::vector<fastuidraw::Glyph> &dst):
+                  std::vector<fastuidraw::Glyph> &dst,
+                  fastuidraw::reference_counted_ptr<fastuidraw::GlyphCache> glyph_cache):
   m_render(r),
-  m_font(f)
+  m_font(f),
+  m_glyph_cache(glyph_cache)
 {
   dst.resize(face->face()->num_glyphs);
   m_dst = fastuidraw::c_array<fastuidraw::Glyph>(&dst[0], dst.size());
@@ -182,7 +184,12 @@ execute(void *ptr)
       idx < p->m_dst.size();
       idx = SDL_AtomicAdd(&p->m_counter, 1), ++K)
     {
-      p->m_dst[idx] = fastuidraw::Glyph::create_glyph(p->m_render, p->m_font, idx);
+      /* GlyphCache::fetch_glyph() is thread safe, so the
+       * glyphs are created directly into the cache.
+       */
+      p->m_dst[idx] = (p->m_glyph_cache) ?
+        p->m_glyph_cache->fetch_glyph(p->m_render, p->m_font, idx) :
+        fastuidraw::Glyph::create_glyph(p->m_render, p->m_font, idx);
     }
   return K;
 }
@@ -197,7 +204,7 @@ generate(unsigned int num_threads,
          fastuidraw::reference_counted_ptr<fastuidraw::GlyphCache> glyph_cache,
          std::vector<int> &cnts)
 {
-  GlyphSetGenerator generator(r, f, face, dst);
+  GlyphSetGenerator generator(r, f, face, dst, glyph_cache);
   std::vector<SDL_Thread*> threads;
 
   cnts.clear();
@@ -219,14 +226,6 @@ generate(unsigned int num_threads,
           SDL_WaitThread(threads[i], &cnts[i]);
         }
     }
-
-  if (glyph_cache)
-    {
-      for(fastuidraw::Glyph glyph : dst)
-        {
-          glyph_cache->add_glyph(glyph);
-        }
-    }
 }
 
 //////////////////////////////
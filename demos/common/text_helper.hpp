@@ -58,7 +58,8 @@ private:
   GlyphSetGenerator(fastuidraw::GlyphRender r,
                     fastuidraw::reference_counted_ptr<const fastuidraw::FontFreeType> f,
                     fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeFace> face,
-                    std::vector<fastuidraw::Glyph> &dst);
+                    std::vector<fastuidraw::Glyph> &dst,
+                    fastuidraw::reference_counted_ptr<fastuidraw::GlyphCache> glyph_cache);
 
   static
   int
@@ -67,6 +68,7 @@ private:
   fastuidraw::GlyphRender m_render;
   fastuidraw::reference_counted_ptr<const fastuidraw::FontFreeType> m_font;
   fastuidraw::c_array<fastuidraw::Glyph> m_dst;
+  fastuidraw::reference_counted_ptr<fastuidraw::GlyphCache> m_glyph_cache;
   SDL_atomic_t m_counter;
 };
 
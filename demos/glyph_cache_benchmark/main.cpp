@@ -0,0 +1,449 @@
+#include <iostream>
+#include <vector>
+#include <fastuidraw/text/glyph_cache.hpp>
+#include <fastuidraw/text/glyph_selector.hpp>
+#include <fastuidraw/text/font_freetype.hpp>
+
+#include "sdl_painter_demo.hpp"
+#include "simple_time.hpp"
+#include "text_helper.hpp"
+
+using namespace fastuidraw;
+
+/* Benchmark of glyph generation and of GlyphCache::fetch_glyph()
+ * from several threads. A glyph set of num_glyphs glyphs is made
+ * from the glyphs of a font, each at several pixel sizes if the
+ * font has fewer glyphs than num_glyphs (i.e. a CJK-sized glyph
+ * set from any font). For each thread count of 1, 2, 4, ...,
+ * max_threads, the threads first generate the glyph data of the
+ * glyph set directly from the font (without the GlyphCache) and
+ * the number of glyphs per second together with the average and
+ * maximum time to generate a single glyph is reported; for
+ * distance field glyphs the latter depends on the number of
+ * threads used per glyph (distance_field_threads). Then the glyphs
+ * are created in the GlyphCache by max_threads threads and, for
+ * each thread count, each thread fetches random glyphs of the
+ * set and the number of lookups per second is reported. Lastly,
+ * for each thread count, each thread fetches glyphs of random
+ * character codes of the font through GlyphSelector::fetch_glyph()
+ * by FontProperties, i.e. the path of text layout, and the number
+ * of lookups per second is reported.
+ */
+class glyph_cache_benchmark:public sdl_painter_demo
+{
+public:
+  glyph_cache_benchmark(void);
+
+protected:
+  void
+  derived_init(int, int);
+
+  void
+  draw_frame(void);
+
+  void
+  handle_event(const SDL_Event &ev);
+
+private:
+  class GlyphKey
+  {
+  public:
+    GlyphRender m_render;
+    uint32_t m_glyph_code;
+  };
+
+  class Worker
+  {
+  public:
+    glyph_cache_benchmark *m_benchmark;
+    unsigned int m_begin, m_end;
+    unsigned int m_lookups;
+    uint32_t m_seed;
+
+    /* time to generate glyphs in generate_glyphs() */
+    uint64_t m_total_us, m_max_us;
+  };
+
+  static
+  int
+  generate_glyphs(void *ptr);
+
+  static
+  int
+  create_glyphs(void *ptr);
+
+  static
+  int
+  lookup_glyphs(void *ptr);
+
+  static
+  int
+  select_glyphs(void *ptr);
+
+  /* runs the workers each in its own thread, returns
+   * the time in microseconds for all to finish.
+   */
+  uint64_t
+  run_threads(std::vector<Worker> &workers, SDL_ThreadFunction f);
+
+  command_separator m_benchmark_options;
+  command_line_argument_value<std::string> m_font_file;
+  command_line_argument_value<int> m_num_glyphs;
+  command_line_argument_value<int> m_pixel_size;
+  command_line_argument_value<int> m_lookups_per_thread;
+  command_line_argument_value<int> m_max_threads;
+  command_line_argument_value<int> m_face_pool_size;
+  enumerated_command_line_argument_value<enum glyph_type> m_generation_type;
+  command_line_argument_value<int> m_distance_field_pixel_size;
+  command_line_argument_value<int> m_distance_field_threads;
+
+  reference_counted_ptr<const FontFreeType> m_font;
+  std::vector<GlyphKey> m_keys;
+  std::vector<uint32_t> m_character_codes;
+  GlyphRender m_selector_render;
+};
+
+glyph_cache_benchmark::
+glyph_cache_benchmark(void):
+  sdl_painter_demo("Benchmark of GlyphCache::fetch_glyph() from multiple threads"),
+  m_benchmark_options("Benchmark Options", *this),
+  m_font_file(default_font(), "font", "File from which to take the glyphs", *this),
+  m_num_glyphs(20000, "num_glyphs",
+               "Number of glyphs in the glyph set, if the font has fewer glyphs, "
+               "the glyphs of the font are used at several pixel sizes",
+               *this),
+  m_pixel_size(16, "pixel_size", "Smallest pixel size of the glyphs", *this),
+  m_lookups_per_thread(1000000, "lookups_per_thread",
+                       "Number of glyphs each thread fetches", *this),
+  m_max_threads(32, "max_threads", "Maximum number of threads", *this),
+  m_face_pool_size(8, "face_pool_size",
+                   "Maximum number of FreeTypeFace objects the font uses "
+                   "to generate glyphs concurrently", *this),
+  m_generation_type(coverage_glyph,
+                    enumerated_string_type<enum glyph_type>()
+                    .add_entry("coverage", coverage_glyph, "coverage glyphs (i.e. alpha masks)")
+                    .add_entry("distance_field", distance_field_glyph, "distance field glyphs")
+                    .add_entry("curve_pair", curve_pair_glyph, "curve-pair glyphs"),
+                    "generation_type",
+                    "Type of the glyphs of the glyph set; distance field and curve-pair "
+                    "glyphs are scalable, so the glyph set has at most as many glyphs "
+                    "as the font",
+                    *this),
+  m_distance_field_pixel_size(48, "distance_field_pixel_size",
+                              "Pixel size at which distance field glyphs are generated",
+                              *this),
+  m_distance_field_threads(1, "distance_field_threads",
+                           "Maximum number of threads used to generate a single "
+                           "distance field glyph", *this)
+{
+  std::cout << "Usage:\n\tEscape: quit application\n";
+}
+
+int
+glyph_cache_benchmark::
+generate_glyphs(void *ptr)
+{
+  Worker *w(static_cast<Worker*>(ptr));
+  glyph_cache_benchmark *b(w->m_benchmark);
+
+  w->m_total_us = 0;
+  w->m_max_us = 0;
+  for(unsigned int i = w->m_begin; i < w->m_end; ++i)
+    {
+      const GlyphKey &key(b->m_keys[i]);
+      GlyphLayoutData layout;
+      GlyphRenderData *data;
+      Path path;
+      simple_time timer;
+      uint64_t us;
+
+      data = b->m_font->compute_rendering_data(key.m_render, key.m_glyph_code, layout, path);
+      us = timer.elapsed_us();
+      FASTUIDRAWdelete(data);
+
+      w->m_total_us += us;
+      w->m_max_us = std::max(w->m_max_us, us);
+    }
+  return 0;
+}
+
+int
+glyph_cache_benchmark::
+create_glyphs(void *ptr)
+{
+  Worker *w(static_cast<Worker*>(ptr));
+  glyph_cache_benchmark *b(w->m_benchmark);
+
+  for(unsigned int i = w->m_begin; i < w->m_end; ++i)
+    {
+      const GlyphKey &key(b->m_keys[i]);
+      b->m_glyph_cache->fetch_glyph(key.m_render, b->m_font, key.m_glyph_code);
+    }
+  return 0;
+}
+
+int
+glyph_cache_benchmark::
+lookup_glyphs(void *ptr)
+{
+  Worker *w(static_cast<Worker*>(ptr));
+  glyph_cache_benchmark *b(w->m_benchmark);
+  uint32_t seed(w->m_seed);
+  int num_valid(0);
+
+  for(unsigned int i = 0; i < w->m_lookups; ++i)
+    {
+      Glyph G;
+
+      /* LCG of Numerical Recipes */
+      seed = 1664525u * seed + 1013904223u;
+
+      const GlyphKey &key(b->m_keys[(seed >> 8u) % b->m_keys.size()]);
+      G = b->m_glyph_cache->fetch_glyph(key.m_render, b->m_font, key.m_glyph_code);
+      num_valid += G.valid() ? 1 : 0;
+    }
+  return num_valid;
+}
+
+int
+glyph_cache_benchmark::
+select_glyphs(void *ptr)
+{
+  Worker *w(static_cast<Worker*>(ptr));
+  glyph_cache_benchmark *b(w->m_benchmark);
+  uint32_t seed(w->m_seed);
+  int num_valid(0);
+
+  for(unsigned int i = 0; i < w->m_lookups; ++i)
+    {
+      Glyph G;
+      uint32_t character_code;
+
+      seed = 1664525u * seed + 1013904223u;
+      character_code = b->m_character_codes[(seed >> 8u) % b->m_character_codes.size()];
+      G = b->m_glyph_selector->fetch_glyph(b->m_selector_render, b->m_font->properties(),
+                                           character_code);
+      num_valid += G.valid() ? 1 : 0;
+    }
+  return num_valid;
+}
+
+uint64_t
+glyph_cache_benchmark::
+run_threads(std::vector<Worker> &workers, SDL_ThreadFunction f)
+{
+  std::vector<SDL_Thread*> threads;
+  simple_time timer;
+
+  for(Worker &w : workers)
+    {
+      threads.push_back(SDL_CreateThread(f, "", &w));
+    }
+
+  for(SDL_Thread *t : threads)
+    {
+      SDL_WaitThread(t, nullptr);
+    }
+  return timer.elapsed_us();
+}
+
+void
+glyph_cache_benchmark::
+derived_init(int, int)
+{
+  reference_counted_ptr<FreeTypeFace::GeneratorBase> gen;
+  reference_counted_ptr<FreeTypeFace> face;
+  unsigned int num_font_glyphs, num_glyphs, max_threads;
+  uint64_t us;
+
+  gen = FASTUIDRAWnew FreeTypeFace::GeneratorMemory(m_font_file.m_value.c_str(), 0);
+  if (gen->check_creation() != routine_success)
+    {
+      std::cerr << "Unable to load font \"" << m_font_file.m_value << "\"\n";
+      end_demo(-1);
+      return;
+    }
+
+  m_font = FASTUIDRAWnew FontFreeType(gen,
+                                      FontFreeType::RenderParams()
+                                      .number_faces(std::max(1, m_face_pool_size.m_value))
+                                      .distance_field_pixel_size(std::max(1, m_distance_field_pixel_size.m_value))
+                                      .distance_field_threads(std::max(1, m_distance_field_threads.m_value)),
+                                      m_ft_lib);
+  face = gen->create_face(m_ft_lib);
+  num_font_glyphs = std::max(1, static_cast<int>(face->face()->num_glyphs));
+  num_glyphs = std::max(1, m_num_glyphs.m_value);
+  max_threads = std::max(1, m_max_threads.m_value);
+
+  /* coverage glyphs are not scalable, so the same glyph
+   * code at a different pixel size is a different glyph
+   * of the GlyphCache; scalable glyphs do not have a pixel
+   * size, so there is only one glyph per glyph code.
+   */
+  if (m_generation_type.m_value.m_value != coverage_glyph)
+    {
+      num_glyphs = std::min(num_glyphs, num_font_glyphs);
+    }
+
+  m_keys.resize(num_glyphs);
+  for(unsigned int i = 0; i < num_glyphs; ++i)
+    {
+      m_keys[i].m_glyph_code = i % num_font_glyphs;
+      if (m_generation_type.m_value.m_value == coverage_glyph)
+        {
+          m_keys[i].m_render = GlyphRender(m_pixel_size.m_value + static_cast<int>(i / num_font_glyphs));
+        }
+      else
+        {
+          m_keys[i].m_render = GlyphRender(m_generation_type.m_value.m_value);
+        }
+    }
+
+  std::vector<Worker> workers;
+  std::cout << "Glyph generation, " << num_glyphs << " glyphs ("
+            << num_font_glyphs << " glyphs in font), face pool size "
+            << m_font->render_params().number_faces()
+            << ", threads per distance field glyph "
+            << m_font->render_params().distance_field_threads() << ":\n";
+  for(unsigned int num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+      workers.resize(num_threads);
+      for(unsigned int t = 0; t < num_threads; ++t)
+        {
+          workers[t].m_benchmark = this;
+          workers[t].m_begin = (t * num_glyphs) / num_threads;
+          workers[t].m_end = ((t + 1) * num_glyphs) / num_threads;
+          workers[t].m_lookups = 0;
+          workers[t].m_seed = t;
+        }
+
+      uint64_t total_us(0), max_us(0);
+
+      us = std::max(uint64_t(1), run_threads(workers, generate_glyphs));
+      for(const Worker &w : workers)
+        {
+          total_us += w.m_total_us;
+          max_us = std::max(max_us, w.m_max_us);
+        }
+
+      std::cout << "\t" << num_threads << " threads: "
+                << static_cast<double>(num_glyphs) * 1e6 / static_cast<double>(us)
+                << " glyphs/sec (" << us / 1000u << " ms), per glyph: average "
+                << static_cast<double>(total_us) / static_cast<double>(num_glyphs)
+                << " us, max " << max_us << " us\n";
+    }
+
+  workers.resize(max_threads);
+  for(unsigned int t = 0; t < max_threads; ++t)
+    {
+      workers[t].m_benchmark = this;
+      workers[t].m_begin = (t * num_glyphs) / max_threads;
+      workers[t].m_end = ((t + 1) * num_glyphs) / max_threads;
+      workers[t].m_lookups = 0;
+      workers[t].m_seed = t;
+    }
+  us = run_threads(workers, create_glyphs);
+  std::cout << "Created " << num_glyphs << " glyphs in GlyphCache with "
+            << max_threads << " threads in " << us / 1000u << " ms\n"
+            << "GlyphCache lookups:\n";
+
+  for(unsigned int num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+      uint64_t total_lookups;
+
+      workers.resize(num_threads);
+      for(unsigned int t = 0; t < num_threads; ++t)
+        {
+          workers[t].m_benchmark = this;
+          workers[t].m_lookups = std::max(0, m_lookups_per_thread.m_value);
+          workers[t].m_seed = 1 + t;
+        }
+
+      us = std::max(uint64_t(1), run_threads(workers, lookup_glyphs));
+      total_lookups = static_cast<uint64_t>(num_threads) * workers[0].m_lookups;
+      std::cout << "\t" << num_threads << " threads: "
+                << static_cast<double>(total_lookups) * 1e6 / static_cast<double>(us)
+                << " lookups/sec (" << us / 1000u << " ms)\n";
+    }
+
+  /* the glyphs of the character codes are created by
+   * fetching each once, so that the lookups below
+   * measure only glyph selection and GlyphCache lookup.
+   */
+  FT_ULong character_code;
+  FT_UInt glyph_code;
+  for(character_code = FT_Get_First_Char(face->face(), &glyph_code);
+      glyph_code != 0;
+      character_code = FT_Get_Next_Char(face->face(), character_code, &glyph_code))
+    {
+      m_character_codes.push_back(character_code);
+    }
+
+  if (m_character_codes.empty())
+    {
+      return;
+    }
+
+  m_selector_render = (m_generation_type.m_value.m_value == coverage_glyph) ?
+    GlyphRender(m_pixel_size.m_value) :
+    GlyphRender(m_generation_type.m_value.m_value);
+  m_glyph_selector->add_font(m_font);
+  for(uint32_t c : m_character_codes)
+    {
+      m_glyph_selector->fetch_glyph(m_selector_render, m_font->properties(), c);
+    }
+
+  std::cout << "GlyphSelector lookups (" << m_character_codes.size()
+            << " character codes):\n";
+  for(unsigned int num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+      uint64_t total_lookups;
+
+      workers.resize(num_threads);
+      for(unsigned int t = 0; t < num_threads; ++t)
+        {
+          workers[t].m_benchmark = this;
+          workers[t].m_lookups = std::max(0, m_lookups_per_thread.m_value);
+          workers[t].m_seed = 1 + t;
+        }
+
+      us = std::max(uint64_t(1), run_threads(workers, select_glyphs));
+      total_lookups = static_cast<uint64_t>(num_threads) * workers[0].m_lookups;
+      std::cout << "\t" << num_threads << " threads: "
+                << static_cast<double>(total_lookups) * 1e6 / static_cast<double>(us)
+                << " lookups/sec (" << us / 1000u << " ms)\n";
+    }
+}
+
+void
+glyph_cache_benchmark::
+draw_frame(void)
+{
+  end_demo(0);
+}
+
+void
+glyph_cache_benchmark::
+handle_event(const SDL_Event &ev)
+{
+  switch(ev.type)
+    {
+    case SDL_QUIT:
+      end_demo(0);
+      break;
+
+    case SDL_KEYUP:
+      if (ev.key.keysym.sym == SDLK_ESCAPE)
+        {
+          end_demo(0);
+        }
+      break;
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+  glyph_cache_benchmark G;
+  return G.main(argc, argv);
+}
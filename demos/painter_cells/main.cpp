@@ -569,6 +569,8 @@ draw_frame(void)
            << m_painter->query_stat(PainterPacker::num_generic_datas)
            << "\nHeaders: "
            << m_painter->query_stat(PainterPacker::num_headers)
+           << "\nDraw breaks avoided: "
+           << m_painter->query_stat(PainterPacker::num_draw_breaks_avoided)
            << "\n";
       if (!m_text_brush)
         {
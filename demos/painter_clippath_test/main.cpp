@@ -51,9 +51,11 @@ private:
       number_zoomers
     };
 
+  typedef vecN<reference_counted_ptr<PainterClip>, no_clip> clip_handles;
+
   void
   draw_element(const Path &path, unsigned int clip_mode, const vec4 &pen_color,
-               const float3x3 &matrix);
+               const float3x3 &matrix, clip_handles &clips);
 
   enum return_code
   load_path(Path &out_path, const std::string &file);
@@ -65,6 +67,8 @@ private:
   command_line_argument_value<std::string> m_path2_file;
 
   Path m_path1, m_path2;
+  clip_handles m_path1_clips, m_path2_clips;
+  bool m_use_cached_clips;
 
   unsigned int m_path1_clip_mode, m_path2_clip_mode;
   unsigned int m_active_zoomer;
@@ -83,6 +87,7 @@ painter_clip_test():
               "if non-empty read the geometry of the path1 from the specified file, "
               "otherwise use a default path",
                *this),
+  m_use_cached_clips(false),
   m_path1_clip_mode(no_clip),
   m_path2_clip_mode(no_clip),
   m_active_zoomer(view_zoomer)
@@ -90,7 +95,8 @@ painter_clip_test():
   std::cout << "Controls:\n"
             << "\t1: cycle through clip modes for path1\n"
             << "\t2: cycle through clip modes for path2\n"
-            << "\ts: cycle through active zoomer controls\n";
+            << "\ts: cycle through active zoomer controls\n"
+            << "\tc: toggle clipping with cached PainterClip objects\n";
 
   m_clip_labels[clip_in] = "clip_in";
   m_clip_labels[clip_out] = "clip_out";
@@ -147,6 +153,10 @@ handle_event(const SDL_Event &ev)
           cycle_value(m_active_zoomer, ev.key.keysym.mod & (KMOD_SHIFT|KMOD_CTRL|KMOD_ALT), number_zoomers);
           std::cout << "Active zoomer set to: " << m_zoomer_labels[m_active_zoomer] << "\n";
           break;
+        case SDLK_c:
+          m_use_cached_clips = !m_use_cached_clips;
+          std::cout << "Use cached clips set to: " << m_use_cached_clips << "\n";
+          break;
         }
       break;
     };
@@ -208,13 +218,26 @@ derived_init(int, int)
 void
 painter_clip_test::
 draw_element(const Path &path, unsigned int clip_mode, const vec4 &pen_color,
-             const float3x3 &matrix)
+             const float3x3 &matrix, clip_handles &clips)
 {
   PainterBrush brush;
 
   m_painter->save();
   m_painter->concat(matrix);
   brush.pen(pen_color);
+  if (m_use_cached_clips && clip_mode != no_clip)
+    {
+      enum PainterClip::clip_mode_t mode;
+
+      mode = (clip_mode == clip_in) ? PainterClip::clip_in : PainterClip::clip_out;
+      if (!clips[clip_mode])
+        {
+          clips[clip_mode] = m_painter->make_clip(path, PainterEnums::nonzero_fill_rule, mode);
+        }
+      m_painter->applyClip(clips[clip_mode]);
+      clip_mode = no_clip;
+    }
+
   switch(clip_mode)
     {
     default:
@@ -250,10 +273,12 @@ draw_frame(void)
   m_painter->transformation(m);
 
   draw_element(m_path1, m_path1_clip_mode, vec4(1.0f, 0.0f, 0.0f, 1.0f),
-               m_zoomers[path1_zoomer].transformation().matrix3());
+               m_zoomers[path1_zoomer].transformation().matrix3(),
+               m_path1_clips);
 
   draw_element(m_path2, m_path2_clip_mode, vec4(0.0f, 1.0f, 0.0f, 1.0f),
-               m_zoomers[path2_zoomer].transformation().matrix3());
+               m_zoomers[path2_zoomer].transformation().matrix3(),
+               m_path2_clips);
 
   m_painter->end();
   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
@@ -39,7 +39,7 @@ public:
   unsigned int
   size(void) const;
 
-  const PainterAttributeData&
+  const PainterGlyphRun&
   data(unsigned int I) const;
 
   void
@@ -93,7 +93,7 @@ private:
   void
   set_data(float pixel_size, size_t glyphs_per_painter_draw);
 
-  std::vector<PainterAttributeData*> m_data;
+  std::vector<reference_counted_ptr<PainterGlyphRun> > m_data;
   std::vector<vec2> m_glyph_positions;
   std::vector<Glyph> m_glyphs;
   std::vector<range_type<float> > m_glyph_extents;
@@ -184,10 +184,6 @@ private:
 GlyphDraws::
 ~GlyphDraws()
 {
-  for(unsigned int i = 0, endi = m_data.size(); i < endi; ++i)
-    {
-      FASTUIDRAWdelete(m_data[i]);
-    }
 }
 
 void
@@ -393,7 +389,7 @@ set_data(float pixel_size, size_t glyphs_per_painter_draw)
       c_array<const Glyph> glyphs;
       c_array<const vec2> glyph_positions;
       unsigned int cnt;
-      PainterAttributeData *data;
+      reference_counted_ptr<PainterGlyphRun> data;
 
       cnt = t_min(in_glyphs.size(), glyphs_per_painter_draw);
       glyphs = in_glyphs.sub_array(0, cnt);
@@ -402,8 +398,11 @@ set_data(float pixel_size, size_t glyphs_per_painter_draw)
       in_glyphs = in_glyphs.sub_array(cnt);
       in_glyph_positions = in_glyph_positions.sub_array(cnt);
 
-      data = FASTUIDRAWnew PainterAttributeData();
-      data->set_data(PainterAttributeDataFillerGlyphs(glyph_positions, glyphs, pixel_size));
+      /* a PainterGlyphRun breaks the glyphs into chunks so
+       * that Painter::draw_glyphs() only draws those
+       * chunks that are visible.
+       */
+      data = FASTUIDRAWnew PainterGlyphRun(glyph_positions, glyphs, pixel_size);
       m_data.push_back(data);
     }
 }
@@ -415,7 +414,7 @@ size(void) const
   return m_data.size();
 }
 
-const PainterAttributeData&
+const PainterGlyphRun&
 GlyphDraws::
 data(unsigned int I) const
 {
@@ -636,6 +635,7 @@ draw_frame(void)
 
   us = update_cts_params();
 
+  m_glyph_cache->begin_frame();
   m_painter->begin(m_surface);
 
   ivec2 wh(dimensions());
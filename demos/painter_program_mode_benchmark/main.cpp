@@ -0,0 +1,478 @@
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+#include "sdl_painter_demo.hpp"
+#include "simple_time.hpp"
+
+using namespace fastuidraw;
+
+/* Benchmark to compare drawing with the uber-shader programs
+ * against drawing with programs specialized to each item shader
+ * (see the option specialized_program_threshold). Each frame
+ * draws a grid of cells where each cell alternates between item
+ * shaders (rect fill, path fill, stroking, pixel width stroking
+ * and dashed stroking) so that the item shader changes often.
+ * The time of each frame is measured with a glFinish() so that
+ * it includes the GPU time; the number of draws and the draw
+ * breaks from item shader changes are taken from the packing
+ * statistics of the Painter, which are accumulated over the
+ * timed frames and printed at the end (draw breaks by reason,
+ * buffer fill histograms and the time spent packing). The bytes streamed to GL and the
+ * time stalled writing them (compare with and without the option
+ * persistent_mapped_buffers and compact_indices) are taken from
+ * the PainterBackendGL. With the option gpu_timer_queries, the
+ * GPU time of each item shader is also reported.
+ */
+class painter_program_mode_benchmark:public sdl_painter_demo
+{
+public:
+  painter_program_mode_benchmark(void);
+
+protected:
+  void
+  derived_init(int, int);
+
+  void
+  draw_frame(void);
+
+  void
+  handle_event(const SDL_Event &ev);
+
+private:
+  enum draw_type_t
+    {
+      draw_rect_type,
+      fill_path_type,
+      stroke_path_type,
+      stroke_path_pixel_width_type,
+      stroke_dashed_path_type,
+
+      number_draw_types
+    };
+
+  void
+  draw_cell(unsigned int cell, const vec2 &sz);
+
+  void
+  print_results(void);
+
+  void
+  add_shader_name(const reference_counted_ptr<PainterItemShader> &shader,
+                  const std::string &name);
+
+  void
+  add_stroke_shader_names(const PainterStrokeShader &shader,
+                          const std::string &name);
+
+  void
+  record_gpu_times(void);
+
+  void
+  record_packing_stats(const PainterPackingStats &st);
+
+  void
+  print_packing_stats(float num_frames);
+
+  command_separator m_benchmark_options;
+  command_line_argument_value<int> m_num_frames;
+  command_line_argument_value<int> m_num_warm_up_frames;
+  command_line_argument_value<int> m_num_cells;
+
+  Path m_path;
+  PainterPackedValue<PainterBrush> m_brush;
+  PainterStrokeParams m_stroke_params;
+  PainterDashedStrokeParams m_dashed_stroke_params;
+
+  simple_time m_benchmark_timer;
+  std::vector<uint64_t> m_frame_times;
+  PainterPackingStats m_packing_stats;
+  uint64_t m_total_bytes_streamed, m_total_stream_stall_ns;
+  uint64_t m_total_draw_calls, m_total_draw_calls_saved;
+  int m_frame;
+
+  std::map<uint32_t, std::string> m_shader_names;
+  std::map<uint32_t, uint64_t> m_total_gpu_group_ns;
+  uint64_t m_total_gpu_ns;
+  unsigned int m_gpu_timed_frames, m_last_gpu_timed_frame;
+};
+
+painter_program_mode_benchmark::
+painter_program_mode_benchmark(void):
+  sdl_painter_demo("Benchmark comparing uber-shader and specialized program drawing"),
+  m_benchmark_options("Benchmark Options", *this),
+  m_num_frames(100, "num_frames", "Number of frames to time", *this),
+  m_num_warm_up_frames(10, "num_warm_up_frames",
+                       "Number of frames to draw before timing, giving time "
+                       "for specialized programs to be built",
+                       *this),
+  m_num_cells(2000, "num_cells",
+              "Number of cells drawn per frame, each cell changes the item shader",
+              *this),
+  m_total_bytes_streamed(0),
+  m_total_stream_stall_ns(0),
+  m_total_draw_calls(0),
+  m_total_draw_calls_saved(0),
+  m_frame(0),
+  m_total_gpu_ns(0),
+  m_gpu_timed_frames(0),
+  m_last_gpu_timed_frame(0)
+{
+  std::cout << "Usage:\n\tEscape: quit application\n";
+}
+
+void
+painter_program_mode_benchmark::
+derived_init(int, int)
+{
+  std::vector<PainterDashedStrokeParams::DashPatternElement> dashes;
+
+  m_path << vec2(0.0f, 0.0f)
+         << vec2(1.0f, 0.0f)
+         << vec2(1.0f, 1.0f)
+         << Path::contour_end();
+
+  m_brush = m_painter->packed_value_pool().create_packed_value(PainterBrush()
+                                                               .pen(0.2f, 0.6f, 1.0f, 0.8f));
+
+  m_stroke_params
+    .miter_limit(-1.0f)
+    .width(0.1f);
+
+  dashes.push_back(PainterDashedStrokeParams::DashPatternElement(0.2f, 0.1f));
+  m_dashed_stroke_params
+    .miter_limit(-1.0f)
+    .width(0.1f);
+  m_dashed_stroke_params.dash_pattern(c_array<const PainterDashedStrokeParams::DashPatternElement>(&dashes[0],
+                                                                                                   dashes.size()));
+
+  m_frame_times.reserve(std::max(0, m_num_frames.m_value));
+
+  const PainterShaderSet &shaders(m_painter->default_shaders());
+  add_shader_name(shaders.fill_shader().item_shader(), "fill");
+  add_shader_name(shaders.fill_shader().aa_fuzz_shader(), "fill aa fuzz");
+  add_stroke_shader_names(shaders.stroke_shader(), "stroke");
+  add_stroke_shader_names(shaders.pixel_width_stroke_shader(), "pixel width stroke");
+  add_stroke_shader_names(shaders.dashed_stroke_shader().shader(PainterEnums::flat_caps),
+                          "dashed stroke");
+}
+
+void
+painter_program_mode_benchmark::
+add_shader_name(const reference_counted_ptr<PainterItemShader> &shader,
+                const std::string &name)
+{
+  if (!shader)
+    {
+      return;
+    }
+
+  /* the GPU time of a sub-shader is reported either under
+   * its own ID or under the ID of its parent.
+   */
+  m_shader_names[shader->ID()] = name;
+  if (shader->parent() && m_shader_names.find(shader->parent()->ID()) == m_shader_names.end())
+    {
+      m_shader_names[shader->parent()->ID()] = name;
+    }
+}
+
+void
+painter_program_mode_benchmark::
+add_stroke_shader_names(const PainterStrokeShader &shader,
+                        const std::string &name)
+{
+  add_shader_name(shader.aa_shader_pass1(), name + " aa pass1");
+  add_shader_name(shader.aa_shader_pass2(), name + " aa pass2");
+  add_shader_name(shader.non_aa_shader(), name + " non-aa");
+}
+
+void
+painter_program_mode_benchmark::
+record_gpu_times(void)
+{
+  /* the GPU timer results arrive a few frames after the
+   * frame was drawn, only record each timed frame once.
+   */
+  if (m_backend->number_gpu_timed_frames() == m_last_gpu_timed_frame)
+    {
+      return;
+    }
+  m_last_gpu_timed_frame = m_backend->number_gpu_timed_frames();
+
+  c_array<const uint32_t> groups(m_backend->last_gpu_timed_frame_shader_groups());
+  c_array<const uint64_t> times(m_backend->last_gpu_timed_frame_shader_group_times_ns());
+
+  for(unsigned int i = 0; i < groups.size(); ++i)
+    {
+      m_total_gpu_group_ns[groups[i]] += times[i];
+    }
+  m_total_gpu_ns += m_backend->last_gpu_timed_frame_time_ns();
+  ++m_gpu_timed_frames;
+}
+
+void
+painter_program_mode_benchmark::
+record_packing_stats(const PainterPackingStats &st)
+{
+  for(unsigned int i = 0; i < PainterPackingStats::number_break_reasons; ++i)
+    {
+      m_packing_stats.m_break_counts[i] += st.m_break_counts[i];
+    }
+
+  for(unsigned int b = 0; b < PainterPackingStats::number_buffers; ++b)
+    {
+      for(unsigned int i = 0; i < PainterPackingStats::number_histogram_bins; ++i)
+        {
+          m_packing_stats.m_fill_histogram[b][i] += st.m_fill_histogram[b][i];
+        }
+    }
+  m_packing_stats.m_number_draws += st.m_number_draws;
+  m_packing_stats.m_packing_time_ns += st.m_packing_time_ns;
+}
+
+void
+painter_program_mode_benchmark::
+print_packing_stats(float num_frames)
+{
+  std::cout << "\taverage packing time per frame = "
+            << static_cast<float>(m_packing_stats.m_packing_time_ns) / (1000.0f * num_frames)
+            << " us\n"
+            << "\taverage draw breaks per frame:\n";
+  for(unsigned int i = 0; i < PainterPackingStats::number_break_reasons; ++i)
+    {
+      enum PainterPackingStats::break_reason_t r;
+
+      r = static_cast<enum PainterPackingStats::break_reason_t>(i);
+      std::cout << "\t\t" << PainterPackingStats::label(r) << ": "
+                << static_cast<float>(m_packing_stats.m_break_counts[i]) / num_frames << "\n";
+    }
+
+  std::cout << "\tbuffer fill histogram on unmap (% full):\n\t\t" << std::setw(12) << "";
+  for(unsigned int i = 0; i < PainterPackingStats::number_histogram_bins; ++i)
+    {
+      std::cout << std::setw(8) << (100 * i) / PainterPackingStats::number_histogram_bins;
+    }
+  std::cout << "\n";
+  for(unsigned int b = 0; b < PainterPackingStats::number_buffers; ++b)
+    {
+      enum PainterPackingStats::buffer_t bf;
+
+      bf = static_cast<enum PainterPackingStats::buffer_t>(b);
+      std::cout << "\t\t" << std::setw(10) << PainterPackingStats::label(bf) << ": ";
+      for(unsigned int i = 0; i < PainterPackingStats::number_histogram_bins; ++i)
+        {
+          std::cout << std::setw(8) << m_packing_stats.m_fill_histogram[b][i];
+        }
+      std::cout << "\n";
+    }
+}
+
+void
+painter_program_mode_benchmark::
+draw_cell(unsigned int cell, const vec2 &sz)
+{
+  PainterData data(m_brush);
+
+  switch(cell % number_draw_types)
+    {
+    default:
+    case draw_rect_type:
+      m_painter->draw_rect(data, vec2(0.0f, 0.0f), sz, false);
+      break;
+
+    case fill_path_type:
+      m_painter->scale(sz.x());
+      m_painter->fill_path(data, m_path, PainterEnums::nonzero_fill_rule, false);
+      break;
+
+    case stroke_path_type:
+      m_painter->scale(sz.x());
+      m_painter->stroke_path(PainterData(m_brush, &m_stroke_params), m_path,
+                             true, PainterEnums::flat_caps, PainterEnums::bevel_joins,
+                             false);
+      break;
+
+    case stroke_path_pixel_width_type:
+      m_painter->scale(sz.x());
+      m_painter->stroke_path_pixel_width(PainterData(m_brush, &m_stroke_params), m_path,
+                                         true, PainterEnums::flat_caps, PainterEnums::bevel_joins,
+                                         false);
+      break;
+
+    case stroke_dashed_path_type:
+      m_painter->scale(sz.x());
+      m_painter->stroke_dashed_path(PainterData(m_brush, &m_dashed_stroke_params), m_path,
+                                    true, PainterEnums::flat_caps, PainterEnums::bevel_joins,
+                                    false);
+      break;
+    }
+}
+
+void
+painter_program_mode_benchmark::
+print_results(void)
+{
+  uint64_t total_us(0);
+  float num_frames;
+
+  for(uint64_t us : m_frame_times)
+    {
+      total_us += us;
+    }
+  num_frames = static_cast<float>(std::max(size_t(1), m_frame_times.size()));
+
+  std::cout << "Drew " << m_frame_times.size() << " frames of "
+            << m_num_cells.m_value << " cells in " << total_us << " us\n"
+            << "\tspecialized_program_threshold = "
+            << m_backend->configuration_gl().specialized_program_threshold() << "\n"
+            << "\tnumber of specialized programs built = "
+            << m_backend->number_specialized_programs() << "\n"
+            << "\taverage time per frame (including glFinish) = "
+            << static_cast<float>(total_us) / num_frames << " us\n"
+            << "\taverage PainterDraw objects per frame = "
+            << static_cast<float>(m_packing_stats.m_number_draws) / num_frames << "\n";
+  print_packing_stats(num_frames);
+  std::cout << "\tpersistent_mapped_buffers = "
+            << m_backend->configuration_gl().persistent_mapped_buffers() << "\n"
+            << "\tcompact_indices = "
+            << m_backend->configuration_gl().compact_indices() << "\n"
+            << "\taverage bytes streamed per frame = "
+            << static_cast<float>(m_total_bytes_streamed) / num_frames << "\n"
+            << "\taverage stall writing buffers per frame = "
+            << static_cast<float>(m_total_stream_stall_ns) / (1000.0f * num_frames) << " us\n"
+            << "\tmulti_draw_indirect = "
+            << m_backend->configuration_gl().multi_draw_indirect() << "\n"
+            << "\taverage GL draw calls per frame = "
+            << static_cast<float>(m_total_draw_calls) / num_frames << "\n"
+            << "\taverage GL draw calls saved per frame = "
+            << static_cast<float>(m_total_draw_calls_saved) / num_frames << "\n"
+            << "\tgpu_timer_queries = "
+            << m_backend->configuration_gl().gpu_timer_queries() << "\n";
+
+  if (m_gpu_timed_frames == 0)
+    {
+      return;
+    }
+
+  std::vector<std::pair<uint64_t, uint32_t> > groups;
+  float num_timed(static_cast<float>(m_gpu_timed_frames));
+
+  for(const auto &v : m_total_gpu_group_ns)
+    {
+      groups.push_back(std::make_pair(v.second, v.first));
+    }
+  std::sort(groups.rbegin(), groups.rend());
+
+  std::cout << "\tGPU timed frames = " << m_gpu_timed_frames
+            << " (dropped " << m_backend->number_gpu_dropped_frames() << ")\n"
+            << "\taverage GPU time per frame = "
+            << static_cast<float>(m_total_gpu_ns) / (1000.0f * num_timed) << " us\n";
+  for(const auto &g : groups)
+    {
+      std::map<uint32_t, std::string>::const_iterator iter;
+
+      iter = m_shader_names.find(g.second);
+      std::cout << "\t\t";
+      if (iter != m_shader_names.end())
+        {
+          std::cout << iter->second;
+        }
+      else if (g.second == 0u)
+        {
+          std::cout << "actions and ungrouped";
+        }
+      else
+        {
+          std::cout << "item shader #" << g.second;
+        }
+      std::cout << ": " << static_cast<float>(g.first) / (1000.0f * num_timed)
+                << " us per frame\n";
+    }
+}
+
+void
+painter_program_mode_benchmark::
+draw_frame(void)
+{
+  int num_warm_up(std::max(0, m_num_warm_up_frames.m_value));
+
+  if (m_frame >= num_warm_up + m_num_frames.m_value)
+    {
+      print_results();
+      end_demo(0);
+      return;
+    }
+
+  ivec2 wh(dimensions());
+  float3x3 proj(float_orthogonal_projection_params(0, wh.x(), wh.y(), 0));
+  int num_cells(std::max(0, m_num_cells.m_value));
+  int per_row(std::max(1, static_cast<int>(std::sqrt(static_cast<float>(num_cells)))));
+  vec2 cell(vec2(wh) / static_cast<float>(per_row));
+
+  glFinish();
+  m_benchmark_timer.restart();
+
+  m_painter->begin(m_surface);
+  m_painter->transformation(proj);
+  for(int i = 0; i < num_cells; ++i)
+    {
+      m_painter->save();
+      m_painter->translate(cell * vec2(static_cast<float>(i % per_row), static_cast<float>(i / per_row)));
+      draw_cell(i, cell * 0.8f);
+      m_painter->restore();
+    }
+  m_painter->end();
+  glFinish();
+
+  if (m_frame >= num_warm_up)
+    {
+      m_frame_times.push_back(m_benchmark_timer.elapsed_us());
+      record_packing_stats(m_painter->packing_stats());
+      m_total_bytes_streamed += m_backend->last_frame_bytes_streamed();
+      m_total_stream_stall_ns += m_backend->last_frame_stream_stall_ns();
+      m_total_draw_calls += m_backend->last_frame_draw_calls();
+      m_total_draw_calls_saved += m_backend->last_frame_draw_calls_saved();
+      record_gpu_times();
+    }
+  else
+    {
+      /* skip those timed frames that were drawn in the warm up */
+      m_last_gpu_timed_frame = m_backend->number_gpu_timed_frames();
+    }
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+  m_surface->blit_surface(GL_NEAREST);
+  ++m_frame;
+}
+
+void
+painter_program_mode_benchmark::
+handle_event(const SDL_Event &ev)
+{
+  switch(ev.type)
+    {
+    case SDL_QUIT:
+      end_demo(0);
+      break;
+
+    case SDL_KEYUP:
+      if (ev.key.keysym.sym == SDLK_ESCAPE)
+        {
+          end_demo(0);
+        }
+      break;
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+  painter_program_mode_benchmark P;
+  return P.main(argc, argv);
+}
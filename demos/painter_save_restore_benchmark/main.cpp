@@ -0,0 +1,183 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "sdl_painter_demo.hpp"
+#include "simple_time.hpp"
+
+using namespace fastuidraw;
+
+/* Micro-benchmark of Painter::save() and Painter::restore():
+ * each frame draws a grid of rects where each rect is drawn
+ * with a save(), translate(), draw_rect(), restore() sequence.
+ */
+class painter_save_restore_benchmark:public sdl_painter_demo
+{
+public:
+  painter_save_restore_benchmark(void);
+
+protected:
+  void
+  derived_init(int, int);
+
+  void
+  draw_frame(void);
+
+  void
+  handle_event(const SDL_Event &ev);
+
+private:
+  void
+  print_results(void);
+
+  command_separator m_benchmark_options;
+  command_line_argument_value<int> m_num_frames;
+  command_line_argument_value<int> m_num_rects;
+  command_line_argument_value<int> m_save_depth;
+  command_line_argument_value<bool> m_translate;
+  command_line_argument_value<bool> m_draw_rects;
+
+  PainterPackedValue<PainterBrush> m_brush;
+  simple_time m_benchmark_timer;
+  std::vector<uint64_t> m_frame_times;
+  int m_frame;
+};
+
+painter_save_restore_benchmark::
+painter_save_restore_benchmark(void):
+  sdl_painter_demo("Micro-benchmark of Painter::save() and Painter::restore()"),
+  m_benchmark_options("Benchmark Options", *this),
+  m_num_frames(100, "num_frames", "Number of frames to draw", *this),
+  m_num_rects(10000, "num_rects",
+              "Number of save(), translate(), draw_rect(), restore() sequences per frame",
+              *this),
+  m_save_depth(1, "save_depth",
+               "Number of nested save() calls (and matching restore() calls) per rect",
+               *this),
+  m_translate(true, "translate",
+              "If true, call translate() after the save() calls; if false the saves "
+              "do not modify any state and restore() is the trivial O(1) case",
+              *this),
+  m_draw_rects(true, "draw_rects",
+               "If false, skip the draw_rect() call to measure only save() and restore()",
+               *this),
+  m_frame(0)
+{
+  std::cout << "Usage:\n\tEscape: quit application\n";
+}
+
+void
+painter_save_restore_benchmark::
+derived_init(int, int)
+{
+  m_brush = m_painter->packed_value_pool().create_packed_value(PainterBrush()
+                                                               .pen(0.0f, 0.0f, 1.0f, 1.0f));
+  m_frame_times.reserve(std::max(0, m_num_frames.m_value));
+}
+
+void
+painter_save_restore_benchmark::
+print_results(void)
+{
+  uint64_t total_us(0);
+  float num_pairs;
+
+  for(uint64_t us : m_frame_times)
+    {
+      total_us += us;
+    }
+
+  num_pairs = static_cast<float>(m_frame_times.size())
+    * static_cast<float>(m_num_rects.m_value)
+    * static_cast<float>(std::max(1, m_save_depth.m_value));
+
+  std::cout << "Did " << m_frame_times.size() << " frames of "
+            << m_num_rects.m_value << " rects with save depth "
+            << m_save_depth.m_value << " in " << total_us << " us\n"
+            << "\taverage CPU time per frame = "
+            << static_cast<float>(total_us) / static_cast<float>(std::max(size_t(1), m_frame_times.size()))
+            << " us\n"
+            << "\taverage CPU time per save()/restore() pair = "
+            << 1000.0f * static_cast<float>(total_us) / std::max(1.0f, num_pairs)
+            << " ns\n";
+}
+
+void
+painter_save_restore_benchmark::
+draw_frame(void)
+{
+  if (m_frame >= m_num_frames.m_value)
+    {
+      print_results();
+      end_demo(0);
+      return;
+    }
+
+  ivec2 wh(dimensions());
+  float3x3 proj(float_orthogonal_projection_params(0, wh.x(), wh.y(), 0));
+  int num_rects(std::max(0, m_num_rects.m_value));
+  int depth(std::max(1, m_save_depth.m_value));
+  int per_row(std::max(1, static_cast<int>(std::sqrt(static_cast<float>(num_rects)))));
+  vec2 cell(vec2(wh) / static_cast<float>(per_row));
+  PainterData data(m_brush);
+
+  m_painter->begin(m_surface);
+  m_painter->transformation(proj);
+
+  m_benchmark_timer.restart();
+  for(int i = 0; i < num_rects; ++i)
+    {
+      for(int k = 0; k < depth; ++k)
+        {
+          m_painter->save();
+        }
+
+      if (m_translate.m_value)
+        {
+          m_painter->translate(cell * vec2(static_cast<float>(i % per_row), static_cast<float>(i / per_row)));
+        }
+
+      if (m_draw_rects.m_value)
+        {
+          m_painter->draw_rect(data, vec2(0.0f, 0.0f), cell * 0.5f, false);
+        }
+
+      for(int k = 0; k < depth; ++k)
+        {
+          m_painter->restore();
+        }
+    }
+  m_frame_times.push_back(m_benchmark_timer.elapsed_us());
+
+  m_painter->end();
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+  m_surface->blit_surface(GL_NEAREST);
+  ++m_frame;
+}
+
+void
+painter_save_restore_benchmark::
+handle_event(const SDL_Event &ev)
+{
+  switch(ev.type)
+    {
+    case SDL_QUIT:
+      end_demo(0);
+      break;
+
+    case SDL_KEYUP:
+      if (ev.key.keysym.sym == SDLK_ESCAPE)
+        {
+          end_demo(0);
+        }
+      break;
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+  painter_save_restore_benchmark P;
+  return P.main(argc, argv);
+}
@@ -131,6 +131,21 @@ namespace gl
       params&
       delayed(bool v);
 
+      /*!
+       * If true and delayed() is true, the data uploaded at
+       * ColorStopAtlasGL::flush() is staged through a buffer
+       * object bound to GL_PIXEL_UNPACK_BUFFER, merging adjacent
+       * regions into single uploads. Initial value is false.
+       */
+      bool
+      use_pixel_buffer_upload(void) const;
+
+      /*!
+       * Set the value for use_pixel_buffer_upload(void) const
+       */
+      params&
+      use_pixel_buffer_upload(bool v);
+
     private:
       void *m_d;
     };
@@ -151,6 +166,38 @@ namespace gl
     GLuint
     texture(void) const;
 
+    /*!
+     * Returns the total number of bytes of texel data
+     * uploaded to the texture since construction.
+     */
+    uint64_t
+    bytes_uploaded(void) const;
+
+    /*!
+     * Returns the total time in nanoseconds spent issuing
+     * the uploads of texel data to the texture since
+     * construction.
+     */
+    uint64_t
+    upload_time_ns(void) const;
+
+    /*!
+     * Returns the number of times a GL object backing this
+     * ColorStopAtlasGL had to be re-created because the atlas
+     * grew beyond its capacity. The contents are copied to the
+     * new object on the GPU with no read back to the CPU.
+     */
+    unsigned int
+    number_reallocations(void) const;
+
+    /*!
+     * Returns the total number of bytes copied on the GPU
+     * when re-creating the GL objects backing this ColorStopAtlasGL,
+     * see number_reallocations().
+     */
+    uint64_t
+    bytes_copied_on_reallocation(void) const;
+
     /*!
      * Returns the params value used to construct
      * the ColorStopAtlasGL.
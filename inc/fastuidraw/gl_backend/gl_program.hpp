@@ -124,6 +124,16 @@ public:
   GLuint
   name(void);
 
+  /*!
+   * Issues the GL commands to compile the shader (if they have
+   * not been issued already) without querying GL for the result
+   * of the compile, so that the GL implementation may perform
+   * the compile asynchronously. Returns the GL name of this
+   * Shader. Should only be called from the GL rendering thread.
+   */
+  GLuint
+  issue_compile(void);
+
   /*!
    * Returns the shader type of this
    * Shader as set by it's constructor.
@@ -743,6 +753,94 @@ private:
   void *m_d;
 };
 
+/*!
+ * \brief
+ * A ProgramBinaryCache stores the binaries of linked GLSL
+ * programs, as returned by glGetProgramBinary(), in files
+ * of a directory so that a later run can create the program
+ * with glProgramBinary() instead of compiling and linking
+ * its shaders.
+ *
+ * Each entry is identified by a 64-bit key; a \ref Program
+ * computes the key from the source code of its shaders, the
+ * GL_VENDOR, GL_RENDERER and GL_VERSION strings of the GL
+ * context and a caller supplied string describing those
+ * pre-link actions that affect the linked program, see
+ * Program::program_binary_cache(). An entry is written to a
+ * temporary file which is then renamed, so that an interrupted
+ * write never leaves a partial entry; entries whose header or
+ * checksum do not match, or which GL refuses to load, are
+ * treated as missing. Using a ProgramBinaryCache requires:
+ * - for GLES: GLES3.0 or higher
+ * - for GL: either GL version 4.1 or the extension GL_ARB_get_program_binary
+ */
+class ProgramBinaryCache:
+  public reference_counted<ProgramBinaryCache>::default_base
+{
+public:
+  /*!
+   * Ctor.
+   * \param directory directory in which to store the program binaries,
+   *                  the directory must already exist
+   */
+  explicit
+  ProgramBinaryCache(c_string directory);
+
+  ~ProgramBinaryCache();
+
+  /*!
+   * Returns the directory in which the program binaries are stored.
+   */
+  c_string
+  directory(void) const;
+
+  /*!
+   * Returns true if the GL context supports retrieving and
+   * loading program binaries. The GL context must be current.
+   */
+  static
+  bool
+  supported(void);
+
+  /*!
+   * Attempts to load a program binary from the cache into a GLSL
+   * program. Returns true if the entry exists, is not corrupt and
+   * GL successfully linked the GLSL program from it. The GL context
+   * must be current.
+   * \param key key of the entry
+   * \param glsl_program GL name of GLSL program to which to load the binary
+   */
+  bool
+  load(uint64_t key, GLuint glsl_program);
+
+  /*!
+   * Retrieves the binary of a successfully linked GLSL program and
+   * stores it in the cache, replacing any previous entry with the same
+   * key. Returns true on success. The GL context must be current and
+   * the GLSL program should have been linked with the parameter
+   * GL_PROGRAM_BINARY_RETRIEVABLE_HINT set to GL_TRUE.
+   * \param key key of the entry
+   * \param glsl_program GL name of GLSL program from which to get the binary
+   */
+  bool
+  store(uint64_t key, GLuint glsl_program);
+
+  /*!
+   * Returns the number of times load() succeeded.
+   */
+  unsigned int
+  number_hits(void) const;
+
+  /*!
+   * Returns the number of times load() failed.
+   */
+  unsigned int
+  number_misses(void) const;
+
+private:
+  void *m_d;
+};
+
 /*!
  * \brief
  * Class for creating and using GLSL programs.
@@ -1321,6 +1419,30 @@ public:
   void
   use_program(void);
 
+  /*!
+   * Issues the GL commands to compile the shaders and link the
+   * GLSL program without querying GL for their results, so that
+   * a GL implementation supporting GL_KHR_parallel_shader_compile
+   * (or GL_ARB_parallel_shader_compile) can compile and link in
+   * the background. The Program is finished being assembled, which
+   * waits on GL if the link has not yet completed, the first time
+   * use_program() or any query requiring the GL program is called.
+   * The GL context must be current.
+   */
+  void
+  issue_link(void);
+
+  /*!
+   * Returns true if the GLSL program of this Program can be used or
+   * queried without waiting on GL to finish compiling and linking.
+   * If the link has not been issued, calls issue_link(). If neither
+   * GL_KHR_parallel_shader_compile nor GL_ARB_parallel_shader_compile
+   * is supported, there is no way to know if the link has completed
+   * and the return value is always true. The GL context must be current.
+   */
+  bool
+  link_completed(void);
+
   /*!
    * Returns the GL name (i.e. ID assigned by GL,
    * for use in glUseProgram) of this Program.
@@ -1592,6 +1714,35 @@ public:
   c_string
   shader_compile_log(GLenum tp, unsigned int i) const;
 
+  /*!
+   * Set the ProgramBinaryCache from which to fetch (and to
+   * which to store) the linked program. Must be called before
+   * the GLSL program is assembled, i.e. before use_program()
+   * or any query that requires the GL context is first called.
+   * The cache is ignored if the GL context does not support
+   * program binaries, see ProgramBinaryCache::supported().
+   * \param cache ProgramBinaryCache to use, a nullptr value
+   *              indicates to not use a cache
+   * \param binding_key string to add to the key of the cache
+   *                    entry; it should describe the pre-link
+   *                    actions (for example attribute bindings)
+   *                    of the Program, since those affect the
+   *                    linked program but are not part of the
+   *                    shader source code
+   */
+  void
+  program_binary_cache(const reference_counted_ptr<ProgramBinaryCache> &cache,
+                       c_string binding_key = "");
+
+  /*!
+   * Returns true if the GLSL program was created from an
+   * entry of the ProgramBinaryCache set by program_binary_cache().
+   * In that case the shaders of the Program were never compiled
+   * and shader_compile_log() returns an empty string.
+   */
+  bool
+  program_binary_from_cache(void);
+
 private:
   void *m_d;
 };
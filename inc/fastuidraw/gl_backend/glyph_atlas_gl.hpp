@@ -127,6 +127,22 @@ namespace gl
       params&
       delayed(bool v);
 
+      /*!
+       * If true and delayed() is true, the texel data (and the
+       * glyph geometry data when it is backed by a texture)
+       * uploaded at flush() is staged through a buffer object
+       * bound to GL_PIXEL_UNPACK_BUFFER, merging adjacent regions
+       * into single uploads. Initial value is false.
+       */
+      bool
+      use_pixel_buffer_upload(void) const;
+
+      /*!
+       * Set the value for use_pixel_buffer_upload(void) const
+       */
+      params&
+      use_pixel_buffer_upload(bool v);
+
       /*!
        * Returns what kind of GL object is used to back
        * the glyph geometry data. Default value is
@@ -224,6 +240,38 @@ namespace gl
     GLuint
     texel_texture(bool as_integer) const;
 
+    /*!
+     * Returns the total number of bytes of texel and geometry
+     * data uploaded to GL by this GlyphAtlasGL since construction.
+     */
+    uint64_t
+    bytes_uploaded(void) const;
+
+    /*!
+     * Returns the total time in nanoseconds spent issuing the
+     * uploads of texel and geometry data to GL by this
+     * GlyphAtlasGL since construction.
+     */
+    uint64_t
+    upload_time_ns(void) const;
+
+    /*!
+     * Returns the number of times a GL object backing this
+     * GlyphAtlasGL had to be re-created because the atlas
+     * grew beyond its capacity. The contents are copied to the
+     * new object on the GPU with no read back to the CPU.
+     */
+    unsigned int
+    number_reallocations(void) const;
+
+    /*!
+     * Returns the total number of bytes copied on the GPU
+     * when re-creating the GL objects backing this GlyphAtlasGL,
+     * see number_reallocations().
+     */
+    uint64_t
+    bytes_copied_on_reallocation(void) const;
+
     /*!
      * Returns the GL texture ID of the GlyphAtlasGeometryBackingStoreBase
      * derived object used by this GlyphAtlasGL. If the
@@ -186,6 +186,23 @@ namespace gl
       params&
       delayed(bool v);
 
+      /*!
+       * If true and delayed() is true, the data uploaded at
+       * flush() is first copied into a buffer object bound to
+       * GL_PIXEL_UNPACK_BUFFER from which the textures are
+       * updated, adjacent regions are merged into a single
+       * upload and the staging buffers are reused once a fence
+       * indicates GL has consumed them. Initial value is false.
+       */
+      bool
+      use_pixel_buffer_upload(void) const;
+
+      /*!
+       * Set the value for use_pixel_buffer_upload(void) const
+       */
+      params&
+      use_pixel_buffer_upload(bool v);
+
     private:
       void *m_d;
     };
@@ -226,6 +243,39 @@ namespace gl
     const params&
     param_values(void) const;
 
+    /*!
+     * Returns the total number of bytes of texel data uploaded
+     * to the GL textures of this ImageAtlasGL since construction.
+     */
+    uint64_t
+    bytes_uploaded(void) const;
+
+    /*!
+     * Returns the total time in nanoseconds spent issuing the
+     * uploads of texel data to the GL textures of this
+     * ImageAtlasGL since construction; this measures the CPU
+     * time of the upload calls, not the GPU time.
+     */
+    uint64_t
+    upload_time_ns(void) const;
+
+    /*!
+     * Returns the number of times a GL object backing this
+     * ImageAtlasGL had to be re-created because the atlas
+     * grew beyond its capacity. The contents are copied to the
+     * new object on the GPU with no read back to the CPU.
+     */
+    unsigned int
+    number_reallocations(void) const;
+
+    /*!
+     * Returns the total number of bytes copied on the GPU
+     * when re-creating the GL objects backing this ImageAtlasGL,
+     * see number_reallocations().
+     */
+    uint64_t
+    bytes_copied_on_reallocation(void) const;
+
     /*!
      * Returns the coordinates to use for the corners
      * of drawing an image that are fed as the 1st
@@ -424,6 +424,227 @@ namespace fastuidraw
         ConfigurationGL&
         provide_auxiliary_image_buffer(enum auxiliary_buffer_t);
 
+        /*!
+         * The ProgramBinaryCache from which to fetch, and to which
+         * to store, the GLSL programs of the PainterBackendGL, see
+         * Program::program_binary_cache(). Default value is nullptr,
+         * i.e. the programs are always compiled and linked from
+         * their source code.
+         */
+        const reference_counted_ptr<ProgramBinaryCache>&
+        program_binary_cache(void) const;
+
+        /*!
+         * Set the value returned by program_binary_cache(void) const.
+         */
+        ConfigurationGL&
+        program_binary_cache(const reference_counted_ptr<ProgramBinaryCache> &v);
+
+        /*!
+         * If true, when shaders are registered after the GLSL programs
+         * of the PainterBackendGL have been built, the new programs are
+         * compiled and linked asynchronously (see Program::issue_link())
+         * and the previous programs continue to be used for drawing until
+         * the new programs have finished linking. Until then, items drawn
+         * with shaders registered since the previous programs were built
+         * are not drawn (or, for blend shaders, not blended) correctly. The asynchronous build only avoids a stall if the
+         * GL implementation supports GL_KHR_parallel_shader_compile (or
+         * GL_ARB_parallel_shader_compile); otherwise the GL implementation
+         * is given until the start of the next frame to finish the build.
+         * Default value is false.
+         */
+        bool
+        async_program_rebuild(void) const;
+
+        /*!
+         * Set the value returned by async_program_rebuild(void) const.
+         */
+        ConfigurationGL&
+        async_program_rebuild(bool v);
+
+        /*!
+         * If non-zero, instead of drawing all items with the uber-shader
+         * programs, PainterBackendGL lazily builds programs specialized
+         * to a single item shader (together with its sub-shaders and all
+         * blend shaders) and switches programs at the draw breaks between
+         * item shaders. An item shader gets a specialized program once it
+         * has been drawn in specialized_program_threshold() draw breaks,
+         * so that rarely used shaders continue to use the uber-shader.
+         * The specialized program is linked asynchronously (see
+         * Program::issue_link()) and the uber-shader is used until it is
+         * ready. Since each change of item shader causes a draw break, a
+         * non-zero value increases the number of draw calls; it is a
+         * trade of more draw calls for shaders with less branching and
+         * register pressure. A value of 0 means to always use the
+         * uber-shader programs; this value takes precedence over
+         * break_on_shader_change(). Default value is 0.
+         */
+        unsigned int
+        specialized_program_threshold(void) const;
+
+        /*!
+         * Set the value returned by specialized_program_threshold(void) const.
+         */
+        ConfigurationGL&
+        specialized_program_threshold(unsigned int v);
+
+        /*!
+         * The maximum number of specialized programs built, see
+         * specialized_program_threshold(). Default value is 32.
+         */
+        unsigned int
+        max_specialized_programs(void) const;
+
+        /*!
+         * Set the value returned by max_specialized_programs(void) const.
+         */
+        ConfigurationGL&
+        max_specialized_programs(unsigned int v);
+
+        /*!
+         * If true, instead of mapping a buffer object of one of the
+         * pools (see number_pools()) with glMapBufferRange() for each
+         * PainterDraw, the attribute, index and data store streams
+         * are each backed by a large buffer object allocated with
+         * glBufferStorage() that is mapped persistently once and
+         * carved into segments used in ring order. Before a segment
+         * is reused, the fence placed after the draw that last used
+         * it is waited on, so mapping a PainterDraw never makes a GL
+         * call and the GL implementation never needs to synchronize
+         * or orphan the buffers. The ring grows (by
+         * persistent_buffer_segments() segments) only when more
+         * PainterDraw objects are in flight than it has segments.
+         * Requires GL 4.4 or GL_ARB_buffer_storage (and, when the
+         * data store is backed by a TBO, GL 4.3 or
+         * GL_ARB_texture_buffer_range); if not supported or on
+         * GLES the value is ignored. Default value is false.
+         */
+        bool
+        persistent_mapped_buffers(void) const;
+
+        /*!
+         * Set the value returned by persistent_mapped_buffers(void) const.
+         */
+        ConfigurationGL&
+        persistent_mapped_buffers(bool v);
+
+        /*!
+         * The number of segments of each allocation of the
+         * persistently mapped ring buffers, see
+         * persistent_mapped_buffers(). Each segment holds the
+         * data of a single PainterDraw. Default value is 16.
+         */
+        unsigned int
+        persistent_buffer_segments(void) const;
+
+        /*!
+         * Set the value returned by persistent_buffer_segments(void) const.
+         */
+        ConfigurationGL&
+        persistent_buffer_segments(unsigned int v);
+
+        /*!
+         * If true, the index ranges drawn between consecutive state
+         * changes (blend mode, program or a PainterDraw::Action) of a
+         * PainterDraw are written to an indirect buffer and each is
+         * drawn with a single glMultiDrawElementsIndirect() call.
+         * Regardless of this value, consecutive index ranges with the
+         * same state are merged into a single range unless
+         * break_on_shader_change() is true. Requires GL 4.3 or
+         * GL_ARB_multi_draw_indirect; if not supported or on GLES
+         * the value is ignored. Default value is false.
+         */
+        bool
+        multi_draw_indirect(void) const;
+
+        /*!
+         * Set the value returned by multi_draw_indirect(void) const.
+         */
+        ConfigurationGL&
+        multi_draw_indirect(bool v);
+
+        /*!
+         * If true, the GL objects of the gl_backend (textures and
+         * buffers of the atlases, Program and Shader objects, the
+         * GL objects of SurfaceGL, ...) whose owners are destroyed
+         * are not deleted immediately; instead their deletion is
+         * queued and executed in batches in on_post_draw(), i.e.
+         * when the GL context of the PainterBackendGL is current.
+         * This allows the reference counted objects of the gl_backend
+         * to be released from any thread and without a GL context
+         * current. Each PainterBackendGL with this option has its
+         * own queue; a GL object is queued on the PainterBackendGL
+         * that was last constructed or last issued on_pre_draw()
+         * on the thread that made the GL object, i.e. the one whose
+         * GL context was current. The remaining deletions are executed
+         * when the PainterBackendGL is destroyed; GL objects released
+         * after that are deleted immediately. Default value is false.
+         */
+        bool
+        deferred_resource_release(void) const;
+
+        /*!
+         * Set the value returned by deferred_resource_release(void) const.
+         */
+        ConfigurationGL&
+        deferred_resource_release(bool v);
+
+        /*!
+         * The maximum number of GL objects deleted in each call to
+         * on_post_draw() when deferred_resource_release() is true,
+         * so that a burst of releases is spread over several frames.
+         * A value of 0 indicates no limit. Default value is 64.
+         */
+        unsigned int
+        resource_release_budget(void) const;
+
+        /*!
+         * Set the value returned by resource_release_budget(void) const.
+         */
+        ConfigurationGL&
+        resource_release_budget(unsigned int v);
+
+        /*!
+         * If true, GL_TIMESTAMP queries are issued around the draws
+         * of each PainterDraw and around each range of draws of an
+         * item shader group. The results are read back, without
+         * waiting on the GPU, once they are available which is
+         * typically a few frames later, see
+         * PainterBackendGL::number_gpu_timed_frames(). In order to
+         * attribute time to item shaders, the item shader group of an
+         * item shader is computed as if break_on_shader_change() were
+         * true, which adds draw breaks. Requires GL 3.3 or
+         * GL_ARB_timer_query (GL_EXT_disjoint_timer_query for GLES);
+         * if not supported the value is ignored. Default value is
+         * false.
+         */
+        bool
+        gpu_timer_queries(void) const;
+
+        /*!
+         * Set the value returned by gpu_timer_queries(void) const.
+         */
+        ConfigurationGL&
+        gpu_timer_queries(bool v);
+
+        /*!
+         * If true, the indices of a PainterDraw are written by
+         * the packer to CPU memory and copied to the GL index
+         * buffer when the PainterDraw is unmapped; if the number
+         * of attributes of the PainterDraw is no more than 65536,
+         * the indices are converted to and drawn as GLushort, halving
+         * the bytes of index data sent to GL at the cost of a copy.
+         * Default value is false.
+         */
+        bool
+        compact_indices(void) const;
+
+        /*!
+         * Set the value returned by compact_indices(void) const.
+         */
+        ConfigurationGL&
+        compact_indices(bool v);
+
       private:
         void *m_d;
       };
@@ -646,6 +867,136 @@ namespace fastuidraw
       reference_counted_ptr<Program>
       program(enum program_type_t tp);
 
+      /*!
+       * Builds the GLSL programs for all the shaders registered
+       * to this PainterBackendGL, waiting for any asynchronous
+       * build (see ConfigurationGL::async_program_rebuild()) to
+       * complete, so that the compile and link of the programs
+       * does not happen on the first frame that draws with them.
+       * Intended to be called after registering shaders, for
+       * example during a splash screen. The GL context must be
+       * current.
+       */
+      void
+      warm_up(void);
+
+      /*!
+       * Returns the number of programs specialized to a single item
+       * shader that have been built since the last time the uber-shader
+       * programs were built, see ConfigurationGL::specialized_program_threshold().
+       */
+      unsigned int
+      number_specialized_programs(void) const;
+
+      /*!
+       * Returns the number of bytes of attribute, index and data
+       * store data written to GL by the PainterDraw objects mapped
+       * during the last frame, i.e. between the last two calls to
+       * on_post_draw().
+       */
+      uint64_t
+      last_frame_bytes_streamed(void) const;
+
+      /*!
+       * Returns the time in nanoseconds spent during the last frame
+       * (see last_frame_bytes_streamed()) waiting to write to the
+       * buffers of PainterDraw objects. When
+       * ConfigurationGL::persistent_mapped_buffers() is true, this
+       * is the time waiting on the fences of the ring segments;
+       * otherwise it is the time spent in glMapBufferRange().
+       */
+      uint64_t
+      last_frame_stream_stall_ns(void) const;
+
+      /*!
+       * Returns the number of GL draw calls issued during the
+       * last frame (see last_frame_bytes_streamed()).
+       */
+      uint64_t
+      last_frame_draw_calls(void) const;
+
+      /*!
+       * Returns the number of GL draw calls saved during the last
+       * frame (see last_frame_bytes_streamed()) compared to issuing
+       * a glDrawElements() call for each range of indices between
+       * the draw breaks of the PainterDraw objects, i.e. the calls
+       * saved by merging ranges and by using multi-draw calls (see
+       * ConfigurationGL::multi_draw_indirect()).
+       */
+      uint64_t
+      last_frame_draw_calls_saved(void) const;
+
+      /*!
+       * Returns the number of GL objects deleted in the last call
+       * to on_post_draw(), see ConfigurationGL::deferred_resource_release().
+       */
+      unsigned int
+      last_frame_resources_released(void) const;
+
+      /*!
+       * Returns the number of GL objects whose deletion is queued
+       * on this PainterBackendGL, see
+       * ConfigurationGL::deferred_resource_release().
+       */
+      unsigned int
+      number_pending_resource_releases(void) const;
+
+      /*!
+       * Returns the number of frames whose GPU timer query results
+       * have been read back, see ConfigurationGL::gpu_timer_queries().
+       * The values of the last_gpu_timed_frame_*() methods refer to
+       * the most recent of these frames; they change only when this
+       * value changes.
+       */
+      unsigned int
+      number_gpu_timed_frames(void) const;
+
+      /*!
+       * Returns the number of frames whose GPU timer queries were
+       * dropped, either because too many frames were waiting for
+       * results or because GL reported the timer as disjoint.
+       */
+      unsigned int
+      number_gpu_dropped_frames(void) const;
+
+      /*!
+       * Returns the GPU time in nanoseconds to execute the draws of
+       * all the PainterDraw objects of the most recent timed frame.
+       */
+      uint64_t
+      last_gpu_timed_frame_time_ns(void) const;
+
+      /*!
+       * Returns the GPU time in nanoseconds to execute the draws of
+       * each of the PainterDraw objects of the most recent timed
+       * frame, in the order the PainterDraw objects were drawn.
+       */
+      c_array<const uint64_t>
+      last_gpu_timed_frame_draw_times_ns(void) const;
+
+      /*!
+       * Returns the item shader groups drawn in the most recent
+       * timed frame, sorted in increasing order. Since the item
+       * shader group is computed as if
+       * ConfigurationGL::break_on_shader_change() were true, the
+       * value is PainterItemShader::ID() of the item shader (or of
+       * its parent if specialized_program_threshold() is non-zero);
+       * the value 0 is for draws of PainterDraw::Action objects
+       * and of items drawn before the first item shader change. The
+       * time of each group is given by the same element of
+       * last_gpu_timed_frame_shader_group_times_ns().
+       */
+      c_array<const uint32_t>
+      last_gpu_timed_frame_shader_groups(void) const;
+
+      /*!
+       * Returns the GPU time in nanoseconds spent in each item shader
+       * group of last_gpu_timed_frame_shader_groups() in the most
+       * recent timed frame.
+       */
+      c_array<const uint64_t>
+      last_gpu_timed_frame_shader_group_times_ns(void) const;
+
       /*!
        * Returns the ConfigurationGL adapted from that passed
        * by ctor (for the properties of the GL context) of
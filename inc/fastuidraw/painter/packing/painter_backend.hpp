@@ -24,6 +24,7 @@
 #include <fastuidraw/image.hpp>
 #include <fastuidraw/colorstop_atlas.hpp>
 #include <fastuidraw/painter/packing/painter_draw.hpp>
+#include <fastuidraw/painter/packing/painter_packing_stats.hpp>
 #include <fastuidraw/painter/painter_shader.hpp>
 #include <fastuidraw/painter/painter_shader_set.hpp>
 
@@ -124,6 +125,27 @@ namespace fastuidraw
       ConfigurationBase&
       blend_type(enum PainterBlendShader::shader_type tp);
 
+      /*!
+       * The number of draws (i.e. packed headers) that a
+       * PainterPacker is allowed to hold back before writing
+       * their index data. Draws within the window are reordered
+       * so that draws with the same shader groups and blend
+       * mode are adjacent, thus reducing the number of calls to
+       * PainterDraw::draw_break(). A draw is only moved in
+       * front of draws whose clipping region does not intersect
+       * its own. A value of 0 or 1 disables reordering.
+       */
+      unsigned int
+      reorder_window(void) const;
+
+      /*!
+       * Specify the value returned by reorder_window(void) const,
+       * default value is 0
+       * \param v value
+       */
+      ConfigurationBase&
+      reorder_window(unsigned int v);
+
     private:
       void *m_d;
     };
@@ -312,6 +334,24 @@ namespace fastuidraw
     const ConfigurationBase&
     configuration_base(void) const;
 
+    /*!
+     * Returns the statistics of how the data of the most
+     * recent frame was packed. The value is set by
+     * PainterPacker::end() before it calls on_pre_draw(),
+     * thus an implementation may read the statistics of the
+     * frame it is drawing within on_pre_draw(),
+     * PainterDraw::draw() and on_post_draw().
+     */
+    const PainterPackingStats&
+    packing_stats(void) const;
+
+    /*!
+     * Set the value returned by packing_stats(void) const.
+     * \param st value to which to set
+     */
+    void
+    packing_stats(const PainterPackingStats &st);
+
     /*!
      * Called just before calling PainterDraw::draw() on a sequence
      * of PainterDraw objects who have had their PainterDraw::unmap()
@@ -100,6 +100,20 @@ namespace fastuidraw
       virtual
       void
       execute(void) const = 0;
+
+      /*!
+       * To be optionally implemented by a derived class to
+       * return true if the action is a memory barrier. The
+       * value is only used for the statistics of \ref
+       * PainterPackingStats. Default implementation returns
+       * false.
+       */
+      virtual
+      bool
+      barrier(void) const
+      {
+        return false;
+      }
     };
 
     /*!
@@ -196,6 +196,13 @@ namespace fastuidraw
          */
         num_headers,
 
+        /*!
+         * Offset to how many calls to PainterDraw::draw_break()
+         * were avoided by reordering draws within the window
+         * of PainterBackend::ConfigurationBase::reorder_window().
+         */
+        num_draw_breaks_avoided,
+
         /*!
          * Number of stats.
          */
@@ -359,6 +366,15 @@ namespace fastuidraw
     unsigned int
     query_stat(enum stats_t st) const;
 
+    /*!
+     * Returns the PainterPackingStats of the current frame if
+     * called within a begin()/end() pair and otherwise of the
+     * last frame packed. On end(), the value is also handed
+     * to the PainterBackend, see PainterBackend::packing_stats().
+     */
+    const PainterPackingStats&
+    packing_stats(void) const;
+
     /*!
      * Returns the PainterBackend::PerformanceHints of the underlying
      * PainterBackend of this PainterPacker.
@@ -0,0 +1,183 @@
+/*!
+ * \file painter_packing_stats.hpp
+ * \brief file painter_packing_stats.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <fastuidraw/util/vecN.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup PainterPacking
+ * @{
+ */
+
+  /*!
+   * \brief
+   * A PainterPackingStats holds statistics of how a PainterPacker
+   * packed the data of a single frame, i.e. the data packed
+   * between PainterPacker::begin() and PainterPacker::end().
+   */
+  class PainterPackingStats
+  {
+  public:
+    /*!
+     * \brief
+     * Enumeration to describe why a draw was broken, i.e. why
+     * PainterDraw::draw_break() was called or why a new
+     * PainterDraw was mapped.
+     */
+    enum break_reason_t
+      {
+        /*!
+         * The group of the item shader changed.
+         */
+        item_shader_change,
+
+        /*!
+         * The group of the blend shader or the blend mode changed.
+         */
+        blend_change,
+
+        /*!
+         * Bits of PainterBrush::shader() selected by
+         * PainterBackend::ConfigurationBase::brush_shader_mask()
+         * changed.
+         */
+        brush_mask_change,
+
+        /*!
+         * A new PainterDraw was mapped because the attribute
+         * buffer of the current PainterDraw was full.
+         */
+        attributes_full,
+
+        /*!
+         * A new PainterDraw was mapped because the index
+         * buffer of the current PainterDraw was full.
+         */
+        indices_full,
+
+        /*!
+         * A new PainterDraw was mapped because the data
+         * store buffer of the current PainterDraw was full.
+         */
+        store_full,
+
+        /*!
+         * PainterPacker::draw_break() was called with an action
+         * for which PainterDraw::Action::barrier() is false.
+         */
+        draw_break_action,
+
+        /*!
+         * PainterPacker::draw_break() was called with an action
+         * for which PainterDraw::Action::barrier() is true.
+         */
+        barrier_action,
+
+        number_break_reasons
+      };
+
+    /*!
+     * \brief
+     * Enumeration to name the buffers of a PainterDraw.
+     */
+    enum buffer_t
+      {
+        attribute_buffer, /*!< PainterDraw::m_attributes */
+        index_buffer, /*!< PainterDraw::m_indices */
+        store_buffer, /*!< PainterDraw::m_store */
+
+        number_buffers
+      };
+
+    enum
+      {
+        /*!
+         * Number of bins of the histograms of \ref m_fill_histogram.
+         */
+        number_histogram_bins = 10
+      };
+
+    /*!
+     * Ctor, initializes all values as zero.
+     */
+    PainterPackingStats(void);
+
+    /*!
+     * Set all counters and histograms to zero.
+     */
+    void
+    reset(void);
+
+    /*!
+     * Record how full a buffer of a PainterDraw was when
+     * it was unmapped.
+     * \param b which buffer
+     * \param written number of elements written to the buffer
+     * \param size size of the buffer
+     */
+    void
+    record_fill(enum buffer_t b, unsigned int written, unsigned int size);
+
+    /*!
+     * Returns a string label for a break_reason_t.
+     */
+    static
+    const char*
+    label(enum break_reason_t r);
+
+    /*!
+     * Returns a string label for a buffer_t.
+     */
+    static
+    const char*
+    label(enum buffer_t b);
+
+    /*!
+     * Counts for each break_reason_t. Note that a single call
+     * to PainterDraw::draw_break() from a shader change counts
+     * toward each of the reasons \ref item_shader_change, \ref
+     * blend_change and \ref brush_mask_change that apply.
+     */
+    vecN<unsigned int, number_break_reasons> m_break_counts;
+
+    /*!
+     * Histograms of how full each buffer of each PainterDraw was
+     * when unmapped: m_fill_histogram[B][I] is the number of
+     * PainterDraw objects whose buffer B was filled to a ratio
+     * in the range [I / N, (I + 1) / N) where N is
+     * \ref number_histogram_bins; a completely full buffer is
+     * placed in the last bin.
+     */
+    vecN<vecN<unsigned int, number_histogram_bins>, number_buffers> m_fill_histogram;
+
+    /*!
+     * Number of PainterDraw objects unmapped.
+     */
+    unsigned int m_number_draws;
+
+    /*!
+     * Time in nanoseconds spent within PainterPacker::draw_generic().
+     */
+    uint64_t m_packing_time_ns;
+  };
+
+/*! @} */
+}
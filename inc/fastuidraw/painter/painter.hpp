@@ -28,6 +28,8 @@
 #include <fastuidraw/painter/painter_stroke_params.hpp>
 #include <fastuidraw/painter/painter_dashed_stroke_params.hpp>
 #include <fastuidraw/painter/painter_data.hpp>
+#include <fastuidraw/painter/painter_clip.hpp>
+#include <fastuidraw/painter/painter_glyph_run.hpp>
 #include <fastuidraw/painter/packing/painter_packer.hpp>
 
 namespace fastuidraw
@@ -323,6 +325,35 @@ namespace fastuidraw
     void
     clipInPath(const Path &path, const CustomFillRuleBase &fill_rule);
 
+    /*!
+     * Create a PainterClip from a Path. The tessellation of the
+     * path is selected from the current transformation and
+     * curve flatness (see curveFlatness(float)) and is refined
+     * by applyClip() if a later transformation requires a finer
+     * tessellation; the occluder data of the returned PainterClip
+     * is selected on the first call to applyClip().
+     * \param path path by which to clip
+     * \param fill_rule fill rule to apply to path
+     * \param mode if the clip is a clip-in or a clip-out
+     */
+    reference_counted_ptr<PainterClip>
+    make_clip(const Path &path, enum PainterEnums::fill_rule_t fill_rule,
+              enum PainterClip::clip_mode_t mode = PainterClip::clip_in);
+
+    /*!
+     * Apply a PainterClip created by make_clip(); the effect
+     * is the same as clipInPath() or clipOutPath() (according
+     * to PainterClip::clip_mode()) of the Path and fill rule
+     * from which the PainterClip was created, but the occluder
+     * data is reused from the last time the PainterClip was
+     * applied if the transformation and clipping are unchanged
+     * and the recorded tessellation is fine enough for the
+     * current transformation and curve flatness.
+     * \param clip PainterClip to apply
+     */
+    void
+    applyClip(const reference_counted_ptr<PainterClip> &clip);
+
     /*!
      * Set the curve flatness requirement for TessellatedPath
      * and StrokedPath selection when stroking or filling paths
@@ -349,16 +380,23 @@ namespace fastuidraw
      * The state saved is:
      * - transformation state (see concat(), transformation(), translate(),
      *   shear(), scale(), rotate()).
-     * - clip state (see clipInRect(), clipOutPath(), clipInPath())
+     * - clip state (see clipInRect(), clipOutPath(), clipInPath(), applyClip())
      * - curve flatness requirement (see curveFlatness(float))
      * - blend shader (see blend_shader()).
+     *
+     * Each of the above values is only copied the first time it is
+     * modified after save(); thus the cost of save() is constant
+     * and does not depend on the size of the state.
      */
     void
     save(void);
 
     /*!
      * Restore the state of this Painter to the state
-     * it had from the last call to save().
+     * it had from the last call to save(). Only those
+     * values modified since the last call to save()
+     * are restored, so restore() of an unmodified
+     * state is O(1).
      */
     void
     restore(void);
@@ -396,6 +434,41 @@ namespace fastuidraw
                 const PainterAttributeData &data, bool use_anisotropic = false,
                 const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
 
+    /*!
+     * Draw glyphs of a PainterGlyphRun; only those chunks
+     * of the PainterGlyphRun that are not completely clipped
+     * are drawn (see PainterGlyphRun::select_chunks()). Each
+     * drawn chunk is first updated with
+     * PainterGlyphRun::update_chunk().
+     * \param shader with which to draw the glyphs
+     * \param draw data for how to draw
+     * \param run glyph run to draw
+     * \param call_back if non-nullptr handle, call back called when attribute data
+     *                  is added.
+     */
+    void
+    draw_glyphs(const PainterGlyphShader &shader, const PainterData &draw,
+                const PainterGlyphRun &run,
+                const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+     * Draw glyphs of a PainterGlyphRun; only those chunks
+     * of the PainterGlyphRun that are not completely clipped
+     * are drawn (see PainterGlyphRun::select_chunks()). Each
+     * drawn chunk is first updated with
+     * PainterGlyphRun::update_chunk().
+     * \param draw data for how to draw
+     * \param run glyph run to draw
+     * \param use_anisotropic if true, use default_shaders().glyph_shader_anisotropic()
+     *                        otherwise use default_shaders().glyph_shader()
+     * \param call_back if non-nullptr handle, call back called when attribute data
+     *                  is added.
+     */
+    void
+    draw_glyphs(const PainterData &draw,
+                const PainterGlyphRun &run, bool use_anisotropic = false,
+                const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
     /*!
      * Stroke a path.
      * \param shader shader with which to stroke the attribute data
@@ -908,6 +981,13 @@ namespace fastuidraw
     unsigned int
     query_stat(enum PainterPacker::stats_t st) const;
 
+    /*!
+     * Returns the PainterPackingStats of the underlying
+     * PainterPacker, see PainterPacker::packing_stats().
+     */
+    const PainterPackingStats&
+    packing_stats(void) const;
+
     /*!
      * Return the z-depth value that the next item will have.
      */
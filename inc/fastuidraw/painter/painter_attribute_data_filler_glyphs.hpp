@@ -44,7 +44,14 @@ namespace fastuidraw
    * successfully uploaded to its GlyphCache. That value can be
    * queried by number_glyphs(). If all glyphs are uploaded or
    * successfully loaded, then number_glyphs() returns the number
-   * glyph in the glyph run. Data for glyphs is packed as follows:
+   * glyph in the glyph run. Glyphs that are not valid or whose
+   * data is still generated (see Glyph::pending()) are skipped;
+   * number_pending_glyphs() returns how many glyphs were skipped
+   * because they were pending, the data needs to be filled again
+   * to draw those glyphs once they are no longer pending (a
+   * PainterGlyphRun does this when drawn, see
+   * PainterGlyphRun::update_chunk()).
+   * Data for glyphs is packed as follows:
    *   - PainterAttribute::m_attrib0 .xy   -> xy-texel location in primary atlas (float)
    *   - PainterAttribute::m_attrib0 .zw   -> xy-texel location in secondary atlas (float)
    *   - PainterAttribute::m_attrib1 .xy -> position in item coordinates (float)
@@ -120,6 +127,15 @@ namespace fastuidraw
     unsigned int
     number_glyphs(void) const;
 
+    /*!
+     * After calling PainterAttributeData::set_data() with this object,
+     * returns the number of glyphs among the first number_glyphs()
+     * glyphs that were skipped because they were pending (see
+     * Glyph::pending()).
+     */
+    unsigned int
+    number_pending_glyphs(void) const;
+
     virtual
     void
     compute_sizes(unsigned int &number_attributes,
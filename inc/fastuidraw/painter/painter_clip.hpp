@@ -0,0 +1,108 @@
+/*!
+ * \file painter_clip.hpp
+ * \brief file painter_clip.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
+
+namespace fastuidraw
+{
+  class Painter;
+
+/*!\addtogroup Painter
+ * @{
+ */
+
+  /*!
+   * \brief
+   * A PainterClip represents a clip-in or clip-out by a Path
+   * whose occluder draw data is computed once and reused
+   * each time the PainterClip is applied with Painter::applyClip().
+   *
+   * A PainterClip records the tessellation of the Path, the
+   * attribute and index chunks of the occluder and the clip
+   * equations and transformation against which those chunks
+   * were selected. When a PainterClip is applied with the same
+   * transformation and clipping as the last time it was applied
+   * (for example the same clip applied every frame), the only
+   * work done is the packing of the occluder with a new z-value.
+   * If the transformation or clipping differ, the chunks are
+   * re-selected from the recorded tessellation. If the current
+   * transformation and curve flatness (see Painter::curveFlatness())
+   * require a finer tessellation than the recorded one (for example
+   * when zooming in), a finer tessellation of the Path is recorded
+   * and the chunks are selected from it; a coarser requirement
+   * keeps the recorded tessellation. A PainterClip is
+   * created with Painter::make_clip() and can only be used with
+   * the Painter that created it.
+   */
+  class PainterClip:
+    public reference_counted<PainterClip>::non_concurrent
+  {
+  public:
+    /*!
+     * \brief
+     * Enumeration to specify if a PainterClip
+     * clips-in or clips-out by its path.
+     */
+    enum clip_mode_t
+      {
+        /*!
+         * Apply the clip as in Painter::clipInPath().
+         */
+        clip_in,
+
+        /*!
+         * Apply the clip as in Painter::clipOutPath().
+         */
+        clip_out,
+      };
+
+    ~PainterClip();
+
+    /*!
+     * Returns the clip mode of this PainterClip.
+     */
+    enum clip_mode_t
+    clip_mode(void) const;
+
+    /*!
+     * Returns the fill rule with which the PainterClip
+     * was created.
+     */
+    enum PainterEnums::fill_rule_t
+    fill_rule(void) const;
+
+    /*!
+     * Returns the number of times the occluder chunks had to
+     * be (re)selected since the PainterClip was created.
+     */
+    unsigned int
+    number_selections(void) const;
+
+  private:
+    friend class Painter;
+
+    PainterClip(void);
+
+    void *m_d;
+  };
+/*! @} */
+}
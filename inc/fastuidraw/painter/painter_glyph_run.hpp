@@ -0,0 +1,213 @@
+/*!
+ * \file painter_glyph_run.hpp
+ * \brief file painter_glyph_run.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/fastuidraw_memory.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/matrix.hpp>
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
+#include <fastuidraw/text/glyph.hpp>
+
+namespace fastuidraw
+{
+///@cond
+class PainterAttributeData;
+///@endcond
+
+/*!\addtogroup Painter
+ * @{
+ */
+
+  /*!
+   * \brief
+   * A PainterGlyphRun holds the attribute and index data to draw
+   * a run of glyphs broken into chunks of consecutive glyphs, each
+   * chunk with its own bounding box. Painter::draw_glyphs() given
+   * a PainterGlyphRun only draws those chunks that are not completely
+   * clipped, in the same way that Painter::fill_path() only draws
+   * those FilledPath::Subset objects that are not completely clipped.
+   * Since glyphs of a text run are laid out in order, consecutive
+   * glyphs are spatially close and a chunk is typically a portion
+   * of a single line of text.
+   *
+   * The data of each chunk is a PainterAttributeData filled by a
+   * PainterAttributeDataFillerGlyphs, the glyphs are uploaded to
+   * their GlyphCache at construction. A PainterGlyphRun keeps its
+   * glyphs; when a chunk is drawn, update_chunk() marks its glyphs
+   * as used in the current frame of their GlyphCache and fills the
+   * chunk again if a glyph changed its location in the GlyphAtlas
+   * (for example because it was evicted, see GlyphCache::begin_frame())
+   * or if a glyph that was pending (see Glyph::pending()) when the
+   * chunk was filled is now generated. Thus a PainterGlyphRun can be
+   * drawn across frames and its pending glyphs appear once generated.
+   */
+  class PainterGlyphRun:
+    public reference_counted<PainterGlyphRun>::non_concurrent
+  {
+  public:
+    /*!
+     * \brief
+     * Opaque object to hold work room needed for functions
+     * of PainterGlyphRun that require scratch space.
+     */
+    class ScratchSpace:fastuidraw::noncopyable
+    {
+    public:
+      ScratchSpace(void);
+      ~ScratchSpace();
+    private:
+      friend class PainterGlyphRun;
+      void *m_d;
+    };
+
+    enum
+      {
+        /*!
+         * Default value for the number of glyphs per chunk.
+         */
+        default_glyphs_per_chunk = 64
+      };
+
+    /*!
+     * Ctor. The values behind the arrays passed are copied into
+     * attribute data at construction and do not need to stay in
+     * scope.
+     * \param glyph_positions position of the bottom left corner of each glyph
+     * \param glyphs glyphs to draw, array must be same size as glyph_positions
+     * \param scale_factors scale factors to apply to each glyph, must be either
+     *                      empty (indicating no scaling factors) or the exact
+     *                      same length as glyph_positions
+     * \param orientation orientation of drawing
+     * \param glyphs_per_chunk maximum number of glyphs in each chunk
+     */
+    PainterGlyphRun(c_array<const vec2> glyph_positions,
+                    c_array<const Glyph> glyphs,
+                    c_array<const float> scale_factors,
+                    enum PainterEnums::glyph_orientation orientation
+                    = PainterEnums::y_increases_downwards,
+                    unsigned int glyphs_per_chunk = default_glyphs_per_chunk);
+
+    /*!
+     * Ctor. The values behind the arrays passed are copied into
+     * attribute data at construction and do not need to stay in
+     * scope.
+     * \param glyph_positions position of the bottom left corner of each glyph
+     * \param glyphs glyphs to draw, array must be same size as glyph_positions
+     * \param render_pixel_size pixel size to which to scale the glyphs
+     * \param orientation orientation of drawing
+     * \param glyphs_per_chunk maximum number of glyphs in each chunk
+     */
+    PainterGlyphRun(c_array<const vec2> glyph_positions,
+                    c_array<const Glyph> glyphs,
+                    float render_pixel_size,
+                    enum PainterEnums::glyph_orientation orientation
+                    = PainterEnums::y_increases_downwards,
+                    unsigned int glyphs_per_chunk = default_glyphs_per_chunk);
+
+    ~PainterGlyphRun();
+
+    /*!
+     * Returns the number of chunks of this PainterGlyphRun.
+     */
+    unsigned int
+    number_chunks(void) const;
+
+    /*!
+     * Returns the attribute and index data of a chunk; the
+     * chunks of the data are as documented in
+     * PainterAttributeDataFillerGlyphs.
+     * \param I which chunk with 0 <= I < number_chunks()
+     */
+    const PainterAttributeData&
+    chunk_data(unsigned int I) const;
+
+    /*!
+     * Returns the min-corner of the bounding box of
+     * a chunk in item coordinates.
+     * \param I which chunk with 0 <= I < number_chunks()
+     */
+    vec2
+    chunk_bounding_box_min(unsigned int I) const;
+
+    /*!
+     * Returns the max-corner of the bounding box of
+     * a chunk in item coordinates.
+     * \param I which chunk with 0 <= I < number_chunks()
+     */
+    vec2
+    chunk_bounding_box_max(unsigned int I) const;
+
+    /*!
+     * Returns the number of glyphs in the attribute data
+     * of all the chunks, see
+     * PainterAttributeDataFillerGlyphs::number_glyphs().
+     */
+    unsigned int
+    number_glyphs(void) const;
+
+    /*!
+     * Returns the number of glyphs that were pending (see
+     * Glyph::pending()) when the chunks were last filled and
+     * thus are not in the attribute data; such a glyph is
+     * added to the attribute data of its chunk by
+     * update_chunk() once it is no longer pending.
+     */
+    unsigned int
+    number_pending_glyphs(void) const;
+
+    /*!
+     * Uploads the glyphs of a chunk to the GlyphAtlas, which
+     * marks them as used in the current frame of their
+     * GlyphCache, and fills the attribute data of the chunk
+     * again if a glyph is not at the atlas location with which
+     * the chunk was filled, if the upload of a glyph failed
+     * when the chunk was filled or if a glyph that was pending
+     * when the chunk was filled is no longer pending and
+     * uploaded. Painter::draw_glyphs() calls
+     * update_chunk() on each chunk it draws before drawing it.
+     * \param I which chunk with 0 <= I < number_chunks()
+     */
+    void
+    update_chunk(unsigned int I) const;
+
+    /*!
+     * Fetch those chunks that are not completely clipped.
+     * \param scratch_space scratch space for computations.
+     * \param clip_equations array of clip equations
+     * \param clip_matrix_local 3x3 transformation from local (x, y, 1)
+     *                          coordinates to clip coordinates.
+     * \param dst[output] location to which to write the indices
+     *                    of the chunks, must be at least number_chunks()
+     *                    in size
+     * \returns the number of chunks written to dst
+     */
+    unsigned int
+    select_chunks(ScratchSpace &scratch_space,
+                  c_array<const vec3> clip_equations,
+                  const float3x3 &clip_matrix_local,
+                  c_array<unsigned int> dst) const;
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
@@ -0,0 +1,169 @@
+/*!
+ * \file painter_text_run_cache.hpp
+ * \brief file painter_text_run_cache.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/text/glyph_selector.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
+#include <fastuidraw/painter/painter_glyph_run.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Painter
+ * @{
+ */
+
+  /*!
+   * \brief
+   * A PainterTextRunCache lays out strings of character codes as
+   * a single line of text and keeps the resulting PainterGlyphRun
+   * objects, so that a label whose text does not change is laid
+   * out and its attribute data filled only once. A text run is
+   * identified by its character codes, the FontProperties, the
+   * pixel size, the GlyphRender and the glyph orientation. Moving
+   * a label does not require a new text run: the run is positioned
+   * with the transformation of the Painter.
+   *
+   * The text runs are kept within a budget of a number of glyphs;
+   * when the budget is exceeded the least recently fetched text
+   * runs are removed. When a glyph of a text run changes its
+   * location in the GlyphAtlas (for example because it was evicted,
+   * see GlyphCache::begin_frame(), or by GlyphCache::compact_atlas())
+   * the PainterGlyphRun fills its attribute data again when drawn,
+   * without a new layout (see PainterGlyphRun::update_chunk()). The
+   * glyphs whose data is generated asynchronously (see Glyph::pending())
+   * are left out of the PainterGlyphRun returned by fetch() because
+   * their advance is not yet known; such a text run is laid out again
+   * on each fetch until no glyph is pending. Hence a PainterGlyphRun
+   * returned by fetch() should not be kept across frames, instead
+   * fetch() should be called again for each frame; for a text run
+   * without pending glyphs this only finds the retained run.
+   */
+  class PainterTextRunCache:
+    public reference_counted<PainterTextRunCache>::non_concurrent
+  {
+  public:
+    /*!
+     * Ctor.
+     * \param selector GlyphSelector used to fetch the glyphs of text runs
+     * \param max_glyphs maximum total number of glyphs of the text
+     *                   runs kept
+     */
+    explicit
+    PainterTextRunCache(const reference_counted_ptr<GlyphSelector> &selector,
+                        unsigned int max_glyphs = 65536);
+
+    ~PainterTextRunCache();
+
+    /*!
+     * Fetch, and if necessary create, the PainterGlyphRun of
+     * a single line of text. The baseline of the text starts
+     * at (0, 0) and goes along the positive x-axis.
+     * \param character_codes character codes, i.e. Unicode code points, of the text
+     * \param props FontProperties used to select the fonts of the glyphs
+     * \param pixel_size pixel size at which to render the text
+     * \param render GlyphRender of the glyphs
+     * \param orientation orientation of the glyphs
+     */
+    reference_counted_ptr<const PainterGlyphRun>
+    fetch(c_array<const uint32_t> character_codes,
+          const FontProperties &props, float pixel_size,
+          GlyphRender render,
+          enum PainterEnums::glyph_orientation orientation
+          = PainterEnums::y_increases_downwards);
+
+    /*!
+     * Provided as a conveniance, equivalent to fetch() passing
+     * the Unicode code points of a UTF-8 encoded string as the
+     * character codes. Invalid UTF-8 sequences are decoded as
+     * the replacement character U+FFFD.
+     * \param text nul-terminated UTF-8 encoded string of the text
+     * \param props FontProperties used to select the fonts of the glyphs
+     * \param pixel_size pixel size at which to render the text
+     * \param render GlyphRender of the glyphs
+     * \param orientation orientation of the glyphs
+     */
+    reference_counted_ptr<const PainterGlyphRun>
+    fetch(c_string text,
+          const FontProperties &props, float pixel_size,
+          GlyphRender render,
+          enum PainterEnums::glyph_orientation orientation
+          = PainterEnums::y_increases_downwards);
+
+    /*!
+     * Returns the maximum total number of glyphs of the
+     * text runs kept.
+     */
+    unsigned int
+    max_glyphs(void) const;
+
+    /*!
+     * Set the value returned by max_glyphs(void) const,
+     * removing text runs if necessary.
+     * \param v value
+     */
+    void
+    max_glyphs(unsigned int v);
+
+    /*!
+     * Returns the total number of glyphs of the text runs kept.
+     */
+    unsigned int
+    number_glyphs(void) const;
+
+    /*!
+     * Returns the number of text runs kept.
+     */
+    unsigned int
+    number_runs(void) const;
+
+    /*!
+     * Removes all text runs.
+     */
+    void
+    clear(void);
+
+    /*!
+     * Returns the number of calls to fetch() that returned
+     * a kept text run without a new layout.
+     */
+    unsigned int
+    number_hits(void) const;
+
+    /*!
+     * Returns the number of calls to fetch() that laid out
+     * a text run.
+     */
+    unsigned int
+    number_misses(void) const;
+
+    /*!
+     * Returns the number of text runs removed to respect
+     * max_glyphs().
+     */
+    unsigned int
+    number_evictions(void) const;
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
@@ -0,0 +1,86 @@
+/*!
+ * \file character_coverage.hpp
+ * \brief file character_coverage.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <fastuidraw/util/reference_counted.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Text
+ * @{
+ */
+
+  /*!
+   * \brief
+   * A CharacterCoverage is a set of character codes, stored as
+   * a bitset in pages of 4096 character codes so that memory is
+   * only used for ranges of character codes that have elements.
+   * Queries are constant time. A CharacterCoverage is filled by
+   * FontBase::compute_character_coverage() and used by
+   * GlyphSelector to select which font of a font merging chain
+   * has a character.
+   */
+  class CharacterCoverage:
+    public reference_counted<CharacterCoverage>::default_base
+  {
+  public:
+    /*!
+     * Ctor. Initializes the CharacterCoverage as empty.
+     */
+    CharacterCoverage(void);
+
+    ~CharacterCoverage();
+
+    /*!
+     * Add a character code to the CharacterCoverage.
+     * \param character_code character code to add
+     */
+    void
+    add(uint32_t character_code);
+
+    /*!
+     * Add the character codes of a range to the CharacterCoverage.
+     * \param begin first character code to add
+     * \param end one past the last character code to add
+     */
+    void
+    add_range(uint32_t begin, uint32_t end);
+
+    /*!
+     * Returns true if a character code is an element
+     * of the CharacterCoverage.
+     * \param character_code character code to query
+     */
+    bool
+    contains(uint32_t character_code) const;
+
+    /*!
+     * Returns the number of character codes of the
+     * CharacterCoverage.
+     */
+    unsigned int
+    number_character_codes(void) const;
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
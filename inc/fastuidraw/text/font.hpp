@@ -25,6 +25,7 @@
 #include <fastuidraw/path.hpp>
 #include <fastuidraw/text/font_properties.hpp>
 #include <fastuidraw/text/glyph_render_data.hpp>
+#include <fastuidraw/text/character_coverage.hpp>
 
 namespace fastuidraw
 {
@@ -101,6 +102,52 @@ namespace fastuidraw
     compute_rendering_data(GlyphRender render, uint32_t glyph_code,
                            GlyphLayoutData &layout, Path &path) const = 0;
 
+    /*!
+     * To be optionally implemented by a derived class to compute
+     * only the Path of a glyph, i.e. the same Path as computed by
+     * compute_rendering_data(). This is used for glyphs whose
+     * rendering data is loaded from a GlyphDiskCache. The default
+     * implementation calls compute_rendering_data() and discards
+     * the rendering data.
+     * \param render specifies object to return via GlyphRender::type(),
+     *               it is guaranteed by the caller that can_create_rendering_data()
+     *               returns true on render.type()
+     * \param glyph_code glyph code of glyph rendering data to create
+     * \param[out] path Path of the glyph
+     */
+    virtual
+    void
+    compute_path(GlyphRender render, uint32_t glyph_code, Path &path) const;
+
+    /*!
+     * To be optionally implemented by a derived class to return a
+     * value that identifies the glyph rendering data the font
+     * generates across processes, i.e. if two fonts (possibly of
+     * different processes) return the same non-zero value, then
+     * they generate the same glyph rendering data. The value is
+     * used as part of the key of a GlyphDiskCache. A return value
+     * of 0 indicates that the glyph rendering data of the font is
+     * not to be stored in a GlyphDiskCache. The default
+     * implementation returns 0.
+     */
+    virtual
+    uint64_t
+    persistent_id(void) const;
+
+    /*!
+     * To be optionally implemented by a derived class to add to
+     * a CharacterCoverage each character code for which glyph_code()
+     * returns a non-zero value. GlyphSelector computes the coverage
+     * of a font once and then only calls glyph_code() for the
+     * character codes the font has. Returns false if the font does
+     * not compute its coverage, in which case glyph_code() is called
+     * instead; the default implementation returns false.
+     * \param[out] dst CharacterCoverage to which to add character codes
+     */
+    virtual
+    bool
+    compute_character_coverage(CharacterCoverage &dst) const;
+
   private:
     FontProperties m_props;
   };
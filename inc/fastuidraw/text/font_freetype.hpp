@@ -123,6 +123,42 @@ namespace fastuidraw
       RenderParams&
       curve_pair_pixel_size(unsigned int v);
 
+      /*!
+       * Maximum number of FreeTypeFace objects a FontFreeType
+       * creates (on demand) to generate glyph data concurrently.
+       * When more threads than this generate glyph data, the
+       * threads wait for a FreeTypeFace to become available.
+       */
+      unsigned int
+      number_faces(void) const;
+
+      /*!
+       * Set the value returned by number_faces(void) const,
+       * initial value is 8. A value of 0 is treated as 1.
+       * \param v value
+       */
+      RenderParams&
+      number_faces(unsigned int v);
+
+      /*!
+       * Maximum number of threads used to generate the
+       * distance field of a single distance field glyph.
+       * The generated data does not depend on the number
+       * of threads; using more than one thread reduces the
+       * latency of generating a single glyph, which is useful
+       * when few glyphs are generated at a time.
+       */
+      unsigned int
+      distance_field_threads(void) const;
+
+      /*!
+       * Set the value returned by distance_field_threads(void) const,
+       * initial value is 1. A value of 0 is treated as 1.
+       * \param v value
+       */
+      RenderParams&
+      distance_field_threads(unsigned int v);
+
     private:
       void *m_d;
     };
@@ -212,6 +248,29 @@ namespace fastuidraw
     compute_rendering_data(GlyphRender render, uint32_t glyph_code,
                            GlyphLayoutData &layout, Path &path) const;
 
+    virtual
+    void
+    compute_path(GlyphRender render, uint32_t glyph_code, Path &path) const;
+
+    /*!
+     * Implements FontBase::persistent_id() as a hash of the
+     * contents of the font file, the face index and render_params();
+     * the value is computed on the first call. Only fonts in the
+     * SFNT format (TrueType and OpenType) have a non-zero value.
+     */
+    virtual
+    uint64_t
+    persistent_id(void) const;
+
+    /*!
+     * Implements FontBase::compute_character_coverage() by walking
+     * the charmap of the face, i.e. the same charmap used by
+     * glyph_code().
+     */
+    virtual
+    bool
+    compute_character_coverage(CharacterCoverage &dst) const;
+
   private:
     void *m_d;
   };
@@ -62,6 +62,19 @@ namespace fastuidraw
       return m_opaque != nullptr;
     }
 
+    /*!
+     * Returns true if the data of the glyph is still being
+     * generated asynchronously, see GlyphCache::async_generation_threads().
+     * A pending glyph cannot be uploaded, only the glyph code
+     * and font of its layout() are set and its path() is empty.
+     * Once pending() returns false, layout() and path() return
+     * the generated data; a reference returned by layout() or
+     * path() while the glyph was pending stays valid but is not
+     * updated. The return value of valid() must be true.
+     */
+    bool
+    pending(void) const;
+
     /*!
      * Returns the glyph's rendering type, valid()
      * must return true. If not, debug builds FASTUIDRAWassert
@@ -135,10 +148,13 @@ namespace fastuidraw
     cache_location(void) const;
 
     /*!
-     * If returns \ref routine_fail, then the GlyphCache
-     * on which the glyph resides needs to be cleared
-     * first. If the glyph is already uploaded returns
-     * immediately with \ref routine_success.
+     * If the glyph is already uploaded returns immediately
+     * with \ref routine_success. If the GlyphAtlas is full,
+     * the least recently used glyphs of the GlyphCache that
+     * were not used in the current frame are evicted from the
+     * GlyphAtlas (see GlyphCache::begin_frame()). If returns
+     * \ref routine_fail, then the GlyphCache on which the glyph
+     * resides needs to be cleared first.
      */
     enum return_code
     upload_to_atlas(void) const;
@@ -318,6 +318,49 @@ namespace fastuidraw
     void
     clear(void);
 
+    /*!
+     * Returns the number of texels of the texel store,
+     * i.e. the product of the values of texel_store()->dimensions().
+     */
+    unsigned int
+    number_texels(void) const;
+
+    /*!
+     * Returns the number of texels (including padding)
+     * of the regions currently allocated by allocate().
+     * When allocate() fails even though number_texels()
+     * is much larger, the free texels are fragmented; see
+     * GlyphCache::compact_atlas().
+     */
+    unsigned int
+    number_texels_allocated(void) const;
+
+    /*!
+     * Returns the amount of geometry data currently allocated
+     * by allocate_geometry_data() in units of
+     * geometry_store()->alignment().
+     */
+    unsigned int
+    geometry_data_allocated(void) const;
+
+    /*!
+     * Returns the largest amount of geometry data, in units of
+     * geometry_store()->alignment(), that can currently be
+     * allocated without resizing the geometry store. Compared
+     * to the free data, i.e. geometry_store()->size() minus
+     * geometry_data_allocated(), it gives the fragmentation
+     * of the geometry store.
+     */
+    unsigned int
+    largest_free_geometry_data(void) const;
+
+    /*!
+     * Returns the number of calls to allocate() and
+     * allocate_geometry_data() that failed.
+     */
+    unsigned int
+    number_failed_allocations(void) const;
+
     /*!
      * Calls GlyphAtlasTexelBackingStoreBase::flush() on
      * the texel backing store (see texel_store())
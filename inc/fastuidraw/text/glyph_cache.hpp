@@ -24,6 +24,7 @@
 #include <fastuidraw/text/font.hpp>
 #include <fastuidraw/text/glyph_layout_data.hpp>
 #include <fastuidraw/text/glyph.hpp>
+#include <fastuidraw/text/glyph_disk_cache.hpp>
 
 namespace fastuidraw
 {
@@ -34,8 +35,11 @@ namespace fastuidraw
   /*!
    * \brief
    * A GlyphCache represents a cache of glyphs and manages the uploading
-   * of the data to a GlyphAtlas. Methods are reentrant but NOT thread
-   * safe.
+   * of the data to a GlyphAtlas. Methods are reentrant; fetch_glyph()
+   * and add_glyph() are also thread safe with respect to each other,
+   * i.e. several threads can fetch (and create) glyphs concurrently.
+   * The other methods, as well as Glyph::upload_to_atlas(), are NOT
+   * thread safe.
    */
   class GlyphCache:public reference_counted<GlyphCache>::default_base
   {
@@ -52,7 +56,13 @@ namespace fastuidraw
     /*!
      * Fetch, and if necessay create and store, a glyph given a
      * glyph code of a font and a GlyphRender specifying how
-     * to render the glyph.
+     * to render the glyph. The glyphs are stored in a hash table
+     * split into shards, each with its own lock, and the data of
+     * a glyph is created without holding any lock; thus, several
+     * threads can call fetch_glyph() concurrently. If a GlyphDiskCache
+     * is set (see disk_cache()), the data of a glyph not in the
+     * GlyphCache is first looked up in the GlyphDiskCache and, if
+     * not found there, the generated data is stored to it.
      */
     Glyph
     fetch_glyph(GlyphRender render,
@@ -82,6 +92,97 @@ namespace fastuidraw
     void
     delete_glyph(Glyph glyph);
 
+    /*!
+     * Sets the number of worker threads that generate glyph data
+     * asynchronously. If the value is non-zero, fetch_glyph() (and
+     * so also GlyphSelector::fetch_glyph()) does not generate the
+     * data of a glyph not in the GlyphCache; it returns a Glyph
+     * whose Glyph::pending() is true and the data is generated by
+     * one of the worker threads. The data of the generated glyphs
+     * is given to the glyphs, and the glyphs uploaded to the
+     * GlyphAtlas, by process_generated_glyphs(). Until then, only
+     * the glyph code and the font of GlyphLayoutData of the Glyph
+     * are set and the Glyph is skipped by PainterAttributeDataFillerGlyphs;
+     * a PainterGlyphRun adds the glyph to its attribute data when
+     * drawn after the glyph is no longer pending (see
+     * PainterGlyphRun::update_chunk()). A value of 0, which is
+     * the initial value, generates the glyph data in fetch_glyph().
+     * Changing the value waits for the glyph data being generated.
+     * Must not be called concurrently with fetch_glyph().
+     * \param v number of worker threads
+     */
+    void
+    async_generation_threads(unsigned int v);
+
+    /*!
+     * Returns the value set by async_generation_threads(unsigned int).
+     */
+    unsigned int
+    async_generation_threads(void) const;
+
+    /*!
+     * Gives the data generated by the worker threads (see
+     * async_generation_threads(unsigned int)) to the pending glyphs
+     * and uploads them to the GlyphAtlas; returns the number of
+     * glyphs that stopped being pending. Should be called by the
+     * thread that renders, for example at the start of each frame;
+     * like Glyph::upload_to_atlas() it is not thread safe.
+     */
+    unsigned int
+    process_generated_glyphs(void);
+
+    /*!
+     * Waits until the data of all pending glyphs is generated, a
+     * following call to process_generated_glyphs() then makes
+     * all glyphs non-pending.
+     */
+    void
+    wait_generated_glyphs(void);
+
+    /*!
+     * Marks the start of a new frame. A GlyphCache tracks for each
+     * glyph the frame in which it was last used, i.e. last fetched
+     * with fetch_glyph() or uploaded with Glyph::upload_to_atlas().
+     * When uploading a glyph fails because the GlyphAtlas is full,
+     * the atlas allocations of the least recently used glyphs that
+     * were not used in the current frame are freed (the glyphs
+     * remain in the GlyphCache) until the upload succeeds. Eviction
+     * is opt-in: if begin_frame() is never called, all glyphs are in
+     * the same frame and no glyph is evicted. An application that
+     * calls begin_frame() must mark the glyphs it draws as used each
+     * frame: Painter::draw_glyphs() does so for a PainterGlyphRun
+     * (see PainterGlyphRun::update_chunk()), which also fills its
+     * attribute data again for glyphs that were evicted; attribute
+     * data filled directly with PainterAttributeDataFillerGlyphs
+     * requires calling Glyph::upload_to_atlas() on its glyphs each
+     * frame and filling the data again if their atlas locations
+     * changed.
+     */
+    void
+    begin_frame(void);
+
+    /*!
+     * Returns the number of times begin_frame() was called.
+     */
+    uint64_t
+    current_frame(void) const;
+
+    /*!
+     * Returns the number of times the atlas allocations of a
+     * glyph were freed to make room for the upload of another
+     * glyph (see begin_frame()).
+     */
+    unsigned int
+    number_evictions(void) const;
+
+    /*!
+     * Returns the number of times a glyph was uploaded to the
+     * GlyphAtlas again after its atlas allocations were freed
+     * by an eviction or by clear_atlas().
+     */
+    unsigned int
+    number_reuploads(void) const;
+
     /*!
      * Call to clear the backing GlyphAtlas. In doing so, the glyphs
      * will no longer be uploaded to the GlyphAtlas and will need
@@ -89,11 +190,51 @@ namespace fastuidraw
      * however are NOT removed from this GlyphCache. Thus, the return
      * values of previous calls to create_glyph() are still valie, but
      * they need to be re-uploaded to the GlyphAtlas with
+     * Glyph::upload_to_atlas(). May be called while other
+     * threads call fetch_glyph(), but not concurrently with
      * Glyph::upload_to_atlas().
      */
     void
     clear_atlas(void);
 
+    /*!
+     * Repacks the glyphs currently uploaded to the GlyphAtlas:
+     * the GlyphAtlas is cleared and the glyphs are uploaded
+     * again, largest first, into the now empty atlas. This
+     * removes the fragmentation that accumulates when glyphs
+     * of many different sizes are uploaded and evicted (see
+     * GlyphAtlas::number_texels_allocated() and
+     * GlyphAtlas::largest_free_geometry_data()). The atlas
+     * locations of the glyphs change, so just as with
+     * clear_atlas(), attribute data packed with the previous
+     * locations must not be drawn after calling compact_atlas();
+     * a PainterGlyphRun fills such data again when drawn (see
+     * PainterGlyphRun::update_chunk()). Returns \ref routine_fail
+     * if some glyphs could not be uploaded again, such glyphs are
+     * uploaded when next drawn. Like clear_atlas(), may be called
+     * while other threads call fetch_glyph().
+     */
+    enum return_code
+    compact_atlas(void);
+
+    /*!
+     * Set the GlyphDiskCache that fetch_glyph() consults before
+     * generating the data of a glyph; a null value indicates to
+     * not use a GlyphDiskCache, which is the initial value. The
+     * Glyph::path() of a glyph whose data is loaded from the
+     * GlyphDiskCache is computed (by FontBase::compute_path())
+     * on the first call to Glyph::path().
+     * \param v GlyphDiskCache to use
+     */
+    void
+    disk_cache(const reference_counted_ptr<GlyphDiskCache> &v);
+
+    /*!
+     * Returns the GlyphDiskCache set by disk_cache(const reference_counted_ptr<GlyphDiskCache>&).
+     */
+    const reference_counted_ptr<GlyphDiskCache>&
+    disk_cache(void) const;
+
     /*!
      * Clear this GlyphCache and the GlyphAtlas. Essentially NUKE.
      */
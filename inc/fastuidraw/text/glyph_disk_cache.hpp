@@ -0,0 +1,148 @@
+/*!
+ * \file glyph_disk_cache.hpp
+ * \brief file glyph_disk_cache.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/text/font.hpp>
+#include <fastuidraw/text/glyph_layout_data.hpp>
+#include <fastuidraw/text/glyph_render_data.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Text
+ * @{
+ */
+
+  /*!
+   * \brief
+   * A GlyphDiskCache stores the GlyphRenderData and GlyphLayoutData
+   * of scalable glyphs (see GlyphRender::scalable()) in a directory
+   * so that the data, which is expensive to generate, can be loaded
+   * instead of generated by later processes. Each glyph is stored in
+   * its own file; a file holds a versioned header, the GlyphLayoutData,
+   * the texel data and the geometry data of the glyph, each aligned
+   * so that the file can be memory mapped.
+   *
+   * A glyph is identified by FontBase::persistent_id() of its font,
+   * its glyph code and its GlyphRender; glyphs of fonts whose
+   * FontBase::persistent_id() is 0 are never stored. When the total
+   * size of the files exceeds max_size_bytes(), the oldest files
+   * (by last store or load) are removed. The methods of GlyphDiskCache
+   * are thread safe and several processes can share the same directory.
+   */
+  class GlyphDiskCache:public reference_counted<GlyphDiskCache>::default_base
+  {
+  public:
+    /*!
+     * Ctor. Creates the directory if it does not exist.
+     * \param directory directory in which to store the glyph files
+     * \param max_size_bytes maximum total size of the glyph files
+     */
+    explicit
+    GlyphDiskCache(c_string directory,
+                   uint64_t max_size_bytes = 256u * 1024u * 1024u);
+
+    ~GlyphDiskCache();
+
+    /*!
+     * Returns the directory in which the glyph files are stored.
+     */
+    c_string
+    directory(void) const;
+
+    /*!
+     * Returns the maximum total size of the glyph files.
+     */
+    uint64_t
+    max_size_bytes(void) const;
+
+    /*!
+     * Returns the total size of the glyph files as known
+     * to this GlyphDiskCache, i.e. the size of the files
+     * when the GlyphDiskCache was created together with
+     * the files it stored and removed since.
+     */
+    uint64_t
+    current_size_bytes(void) const;
+
+    /*!
+     * Load the data of a glyph from the disk cache; returns
+     * nullptr if the glyph is not in the disk cache. The caller
+     * takes ownership of the returned GlyphRenderData.
+     * \param render how the glyph is rendered
+     * \param font font of the glyph
+     * \param glyph_code glyph code of the glyph
+     * \param[out] layout location to which to write the GlyphLayoutData
+     *                    of the glyph, only written to on success
+     */
+    GlyphRenderData*
+    fetch(GlyphRender render,
+          const reference_counted_ptr<const FontBase> &font,
+          uint32_t glyph_code, GlyphLayoutData &layout);
+
+    /*!
+     * Store the data of a glyph to the disk cache. Returns
+     * routine_fail if the glyph is not scalable, if the font
+     * has no persistent id or if writing the file fails.
+     * \param render how the glyph is rendered
+     * \param font font of the glyph
+     * \param glyph_code glyph code of the glyph
+     * \param layout GlyphLayoutData of the glyph
+     * \param data GlyphRenderData of the glyph, must be a
+     *             GlyphRenderDataDistanceField if render.m_type
+     *             is distance_field_glyph and a GlyphRenderDataCurvePair
+     *             if render.m_type is curve_pair_glyph
+     */
+    enum return_code
+    store(GlyphRender render,
+          const reference_counted_ptr<const FontBase> &font,
+          uint32_t glyph_code, const GlyphLayoutData &layout,
+          const GlyphRenderData &data);
+
+    /*!
+     * Returns the number of calls to fetch() that loaded a glyph.
+     */
+    unsigned int
+    number_hits(void) const;
+
+    /*!
+     * Returns the number of calls to fetch() that did not load a glyph.
+     */
+    unsigned int
+    number_misses(void) const;
+
+    /*!
+     * Returns the number of glyphs successfully stored.
+     */
+    unsigned int
+    number_stores(void) const;
+
+    /*!
+     * Returns the number of files removed to respect max_size_bytes().
+     */
+    unsigned int
+    number_evictions(void) const;
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
@@ -33,6 +33,12 @@ namespace fastuidraw
    * \brief
    * A GlyphSelector performs the act of selecting a glyph
    * from a font preference and a character code.
+   *
+   * The methods of GlyphSelector are thread safe. Only adding
+   * fonts (add_font() and add_font_generator()) and creating a
+   * font from a FontGeneratorBase take a lock; fetching fonts,
+   * FontGroup values and glyphs of fonts already loaded do not
+   * lock, so several threads can lay out text concurrently.
    */
   class GlyphSelector:public reference_counted<GlyphSelector>::default_base
   {
@@ -88,7 +94,9 @@ namespace fastuidraw
 
       /*!
        * Returns a list of generators of this FontGroup that have
-       * not yet loaded their font.
+       * not yet loaded their font. The list changes when a font is
+       * added to the GlyphSelector or loaded from a generator, and
+       * so must not be used while another thread does so.
        */
       c_array<const reference_counted_ptr<const FontGeneratorBase> >
       font_generators(void) const;
@@ -274,27 +282,6 @@ namespace fastuidraw
                                      output_iterator output_begin);
 
   private:
-    void
-    lock_mutex(void);
-
-    void
-    unlock_mutex(void);
-
-    Glyph
-    fetch_glyph_no_lock(GlyphRender tp, FontGroup group, uint32_t character_code,
-                        bool exact_match);
-
-    Glyph
-    fetch_glyph_no_lock(GlyphRender tp,
-                        reference_counted_ptr<const FontBase> h,
-                        uint32_t character_code,
-                        bool exact_match);
-
-    Glyph
-    fetch_glyph_no_merging_no_lock(GlyphRender tp,
-                                   reference_counted_ptr<const FontBase> h,
-                                   uint32_t character_code);
-
     void *m_d;
   };
 
@@ -308,14 +295,12 @@ namespace fastuidraw
                         output_iterator output_begin,
                         bool exact_match)
   {
-    lock_mutex();
     for(;character_codes_begin != character_codes_end; ++character_codes_begin, ++output_begin)
       {
         uint32_t v;
         v = static_cast<uint32_t>(*character_codes_begin);
-        *output_begin = fetch_glyph_no_lock(tp, group, v, exact_match);
+        *output_begin = fetch_glyph(tp, group, v, exact_match);
       }
-    unlock_mutex();
   }
 
   template<typename input_iterator,
@@ -329,14 +314,12 @@ namespace fastuidraw
                         output_iterator output_begin,
                         bool exact_match)
   {
-    lock_mutex();
     for(;character_codes_begin != character_codes_end; ++character_codes_begin, ++output_begin)
       {
         uint32_t v;
         v = static_cast<uint32_t>(*character_codes_begin);
-        *output_begin = fetch_glyph_no_lock(tp, h, v, exact_match);
+        *output_begin = fetch_glyph(tp, h, v, exact_match);
       }
-    unlock_mutex();
   }
 
   template<typename input_iterator,
@@ -349,14 +332,12 @@ namespace fastuidraw
                                    input_iterator character_codes_end,
                                    output_iterator output_begin)
   {
-    lock_mutex();
     for(;character_codes_begin != character_codes_end; ++character_codes_begin, ++output_begin)
       {
         uint32_t v;
         v = static_cast<uint32_t>(*character_codes_begin);
-        *output_begin = fetch_glyph_no_merging_no_lock(tp, h, v);
+        *output_begin = fetch_glyph_no_merging(tp, h, v);
       }
-    unlock_mutex();
   }
 
 /*! @} */
@@ -30,7 +30,7 @@ namespace
   class BackingStore:public fastuidraw::ColorStopBackingStore
   {
   public:
-    BackingStore(int w, int l, bool delayed);
+    BackingStore(int w, int l, bool delayed, bool use_pixel_buffer);
     ~BackingStore();
 
     virtual
@@ -51,16 +51,40 @@ namespace
       return m_backing_store.texture();
     }
 
+    uint64_t
+    bytes_uploaded(void) const
+    {
+      return m_backing_store.bytes_uploaded();
+    }
+
+    uint64_t
+    upload_time_ns(void) const
+    {
+      return m_backing_store.upload_time_ns();
+    }
+
+    unsigned int
+    number_reallocations(void) const
+    {
+      return m_backing_store.number_reallocations();
+    }
+
+    uint64_t
+    bytes_copied_on_reallocation(void) const
+    {
+      return m_backing_store.bytes_copied_on_reallocation();
+    }
+
     virtual
     void
     resize_implement(int new_num_layers);
 
     static
     fastuidraw::reference_counted_ptr<fastuidraw::ColorStopBackingStore>
-    create(int w, int l, bool delayed)
+    create(int w, int l, bool delayed, bool use_pixel_buffer)
     {
       BackingStore *p;
-      p = FASTUIDRAWnew BackingStore(w, l, delayed);
+      p = FASTUIDRAWnew BackingStore(w, l, delayed, use_pixel_buffer);
       return fastuidraw::reference_counted_ptr<fastuidraw::ColorStopBackingStore>(p);
     }
 
@@ -118,12 +142,14 @@ namespace
     ColorStopAtlasGLParamsPrivate(void):
       m_width(1024),
       m_num_layers(32),
-      m_delayed(false)
+      m_delayed(false),
+      m_use_pixel_buffer_upload(false)
     {}
 
     int m_width;
     int m_num_layers;
     bool m_delayed;
+    bool m_use_pixel_buffer_upload;
   };
 
   class ColorStopAtlasGLPrivate
@@ -141,9 +167,9 @@ namespace
 //////////////////////////
 // BackingStore methods
 BackingStore::
-BackingStore(int w, int l, bool delayed):
+BackingStore(int w, int l, bool delayed, bool use_pixel_buffer):
   fastuidraw::ColorStopBackingStore(w, l, true),
-  m_backing_store(dimensions_for_store(w, l), delayed)
+  m_backing_store(dimensions_for_store(w, l), delayed, use_pixel_buffer)
 {
 }
 
@@ -212,6 +238,9 @@ setget_implement(fastuidraw::gl::ColorStopAtlasGL::params,
 setget_implement(fastuidraw::gl::ColorStopAtlasGL::params,
                  ColorStopAtlasGLParamsPrivate,
                  bool, delayed)
+setget_implement(fastuidraw::gl::ColorStopAtlasGL::params,
+                 ColorStopAtlasGLParamsPrivate,
+                 bool, use_pixel_buffer_upload)
 
 fastuidraw::gl::ColorStopAtlasGL::params&
 fastuidraw::gl::ColorStopAtlasGL::params::
@@ -224,7 +253,8 @@ optimal_width(void)
 // fastuidraw::gl::ColorStopAtlasGL methods
 fastuidraw::gl::ColorStopAtlasGL::
 ColorStopAtlasGL(const params &P):
-  fastuidraw::ColorStopAtlas(BackingStore::create(P.width(), P.num_layers(), P.delayed()))
+  fastuidraw::ColorStopAtlas(BackingStore::create(P.width(), P.num_layers(), P.delayed(),
+                                                  P.use_pixel_buffer_upload()))
 {
   m_d = FASTUIDRAWnew ColorStopAtlasGLPrivate(P);
 }
@@ -258,6 +288,46 @@ texture(void) const
   return p->texture();
 }
 
+uint64_t
+fastuidraw::gl::ColorStopAtlasGL::
+bytes_uploaded(void) const
+{
+  const BackingStore *p;
+  FASTUIDRAWassert(dynamic_cast<const BackingStore*>(backing_store().get()));
+  p = static_cast<const BackingStore*>(backing_store().get());
+  return p->bytes_uploaded();
+}
+
+uint64_t
+fastuidraw::gl::ColorStopAtlasGL::
+upload_time_ns(void) const
+{
+  const BackingStore *p;
+  FASTUIDRAWassert(dynamic_cast<const BackingStore*>(backing_store().get()));
+  p = static_cast<const BackingStore*>(backing_store().get());
+  return p->upload_time_ns();
+}
+
+unsigned int
+fastuidraw::gl::ColorStopAtlasGL::
+number_reallocations(void) const
+{
+  const BackingStore *p;
+  FASTUIDRAWassert(dynamic_cast<const BackingStore*>(backing_store().get()));
+  p = static_cast<const BackingStore*>(backing_store().get());
+  return p->number_reallocations();
+}
+
+uint64_t
+fastuidraw::gl::ColorStopAtlasGL::
+bytes_copied_on_reallocation(void) const
+{
+  const BackingStore *p;
+  FASTUIDRAWassert(dynamic_cast<const BackingStore*>(backing_store().get()));
+  p = static_cast<const BackingStore*>(backing_store().get());
+  return p->bytes_copied_on_reallocation();
+}
+
 GLenum
 fastuidraw::gl::ColorStopAtlasGL::
 texture_bind_target(void)
@@ -30,27 +30,111 @@
 #include <algorithm>
 #include <sstream>
 #include <stdint.h>
+#include <cstdio>
 #include <sys/time.h>
+#include <unistd.h>
 
 #include <fastuidraw/util/static_resource.hpp>
 #include <fastuidraw/gl_backend/ngl_header.hpp>
 #include <fastuidraw/gl_backend/gl_get.hpp>
 #include <fastuidraw/gl_backend/gl_context_properties.hpp>
 #include <fastuidraw/gl_backend/gl_program.hpp>
+#include "private/deferred_release.hpp"
 
 namespace
 {
+  class ProgramBinaryCachePrivate
+  {
+  public:
+    /* header written before the binary of each entry;
+     * the checksum is of the binary that follows.
+     */
+    class Header
+    {
+    public:
+      enum
+        {
+          magic_value = 0x46554942, /* 'FUIB' */
+          version_value = 1
+        };
+
+      uint32_t m_magic;
+      uint32_t m_version;
+      uint64_t m_key;
+      uint32_t m_binary_format;
+      uint32_t m_binary_size;
+      uint64_t m_checksum;
+    };
+
+    explicit
+    ProgramBinaryCachePrivate(fastuidraw::c_string directory):
+      m_directory(directory),
+      m_number_hits(0),
+      m_number_misses(0)
+    {}
+
+    std::string
+    filename(uint64_t key) const;
+
+    bool
+    load(uint64_t key, GLuint glsl_program);
+
+    std::string m_directory;
+    unsigned int m_number_hits, m_number_misses;
+  };
+
+  /* 64-bit FNV-1a hash, used both for the key of
+   * program binary cache entries and for the checksum
+   * of their contents.
+   */
+  class FNV1a64
+  {
+  public:
+    FNV1a64(void):
+      m_value(14695981039346656037ull)
+    {}
+
+    FNV1a64&
+    add(const void *data, size_t num_bytes)
+    {
+      const uint8_t *bytes(static_cast<const uint8_t*>(data));
+      for(size_t i = 0; i < num_bytes; ++i)
+        {
+          m_value ^= uint64_t(bytes[i]);
+          m_value *= 1099511628211ull;
+        }
+      return *this;
+    }
+
+    FNV1a64&
+    add(fastuidraw::c_string str)
+    {
+      /* include the terminator so that concatenations
+       * of different strings hash differently.
+       */
+      str = (str) ? str : "";
+      return add(str, std::strlen(str) + 1);
+    }
+
+    uint64_t m_value;
+  };
+
   class ShaderPrivate
   {
   public:
     ShaderPrivate(const fastuidraw::glsl::ShaderSource &src,
                   GLenum pshader_type);
 
+    void
+    issue_compile(void);
+
     void
     compile(void);
 
+    bool m_compile_issued;
     bool m_shader_ready;
     GLuint m_name;
+    fastuidraw::gl::detail::DeferredReleaseTarget m_release_target;
     GLenum m_shader_type;
 
     std::string m_source_code;
@@ -605,8 +689,11 @@ namespace
       m_name(0),
       m_delete_program(true),
       m_assembled(false),
+      m_assemble_issued(false),
       m_initializers(initers),
       m_pre_link_actions(action),
+      m_binary_cache_key(0),
+      m_from_binary_cache(false),
       m_p(p)
     {
       for(const ShaderRef &R : m_shaders)
@@ -623,8 +710,11 @@ namespace
       m_name(0),
       m_delete_program(true),
       m_assembled(false),
+      m_assemble_issued(false),
       m_initializers(initers),
       m_pre_link_actions(action),
+      m_binary_cache_key(0),
+      m_from_binary_cache(false),
       m_p(p)
     {
       FASTUIDRAWassert(vert_shader && vert_shader->shader_type() == GL_VERTEX_SHADER);
@@ -641,8 +731,11 @@ namespace
       m_name(0),
       m_delete_program(true),
       m_assembled(false),
+      m_assemble_issued(false),
       m_initializers(initers),
       m_pre_link_actions(action),
+      m_binary_cache_key(0),
+      m_from_binary_cache(false),
       m_p(p)
     {
       m_shaders.push_back(FASTUIDRAWnew fastuidraw::gl::Shader(vert_shader, GL_VERTEX_SHADER));
@@ -651,9 +744,18 @@ namespace
 
     ProgramPrivate(GLuint pname, bool take_ownership, fastuidraw::gl::Program *p);
 
+    void
+    issue_assemble(void);
+
     void
     assemble(void);
 
+    bool
+    assemble_completed(void);
+
+    uint64_t
+    compute_binary_cache_key(void);
+
     void
     populate_info(void);
 
@@ -668,8 +770,9 @@ namespace
     std::map<GLenum, std::vector<int> > m_shader_data_sorted_by_type;
 
     GLuint m_name;
+    fastuidraw::gl::detail::DeferredReleaseTarget m_release_target;
     bool m_delete_program;
-    bool m_link_success, m_assembled;
+    bool m_link_success, m_assembled, m_assemble_issued;
     std::string m_link_log;
     std::string m_log;
     float m_assemble_time;
@@ -680,15 +783,65 @@ namespace
     ShaderStorageBlockSetInfo m_storage_buffer_list;
     fastuidraw::gl::ProgramInitializerArray m_initializers;
     fastuidraw::gl::PreLinkActionArray m_pre_link_actions;
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache> m_binary_cache;
+    std::string m_binary_cache_binding_key;
+    uint64_t m_binary_cache_key;
+    bool m_from_binary_cache;
     fastuidraw::gl::Program *m_p;
   };
 }
 
+/////////////////////////////////////////
+// ProgramBinaryCachePrivate methods
+std::string
+ProgramBinaryCachePrivate::
+filename(uint64_t key) const
+{
+  std::ostringstream str;
+  str << m_directory << "/fastuidraw_program_"
+      << std::hex << std::setw(16) << std::setfill('0')
+      << key << ".bin";
+  return str.str();
+}
+
+bool
+ProgramBinaryCachePrivate::
+load(uint64_t key, GLuint glsl_program)
+{
+  std::ifstream file(filename(key).c_str(), std::ios::binary);
+  Header header;
+  std::vector<char> binary;
+  GLint linkOK(GL_FALSE);
+
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+      || header.m_magic != Header::magic_value
+      || header.m_version != Header::version_value
+      || header.m_key != key
+      || header.m_binary_size == 0)
+    {
+      return false;
+    }
+
+  binary.resize(header.m_binary_size);
+  if (!file.read(&binary[0], binary.size())
+      || FNV1a64().add(&binary[0], binary.size()).m_value != header.m_checksum)
+    {
+      return false;
+    }
+
+  glProgramBinary(glsl_program, header.m_binary_format,
+                  &binary[0], binary.size());
+  glGetProgramiv(glsl_program, GL_LINK_STATUS, &linkOK);
+
+  return linkOK == GL_TRUE;
+}
+
 /////////////////////////////////////////
 // ShaderPrivate methods
 ShaderPrivate::
 ShaderPrivate(const fastuidraw::glsl::ShaderSource &src,
               GLenum pshader_type):
+  m_compile_issued(false),
   m_shader_ready(false),
   m_name(0),
   m_shader_type(pshader_type),
@@ -699,9 +852,9 @@ ShaderPrivate(const fastuidraw::glsl::ShaderSource &src,
 
 void
 ShaderPrivate::
-compile(void)
+issue_compile(void)
 {
-  if (m_shader_ready)
+  if (m_compile_issued)
     {
       return;
     }
@@ -709,7 +862,8 @@ compile(void)
   //now do the GL work, create a name and compile the source code:
   FASTUIDRAWassert(m_name == 0);
 
-  m_shader_ready = true;
+  m_compile_issued = true;
+  m_release_target.capture();
   m_name = glCreateShader(m_shader_type);
 
   fastuidraw::c_string sourceString[1];
@@ -721,6 +875,19 @@ compile(void)
                  nullptr); //lengths of each string or nullptr implies each is 0-terminated
 
   glCompileShader(m_name);
+}
+
+void
+ShaderPrivate::
+compile(void)
+{
+  if (m_shader_ready)
+    {
+      return;
+    }
+
+  issue_compile();
+  m_shader_ready = true;
 
   GLint logSize(0), shaderOK;
   std::vector<char> raw_log;
@@ -1567,14 +1734,13 @@ fastuidraw::gl::Shader::
   ShaderPrivate *d;
   d = static_cast<ShaderPrivate*>(m_d);
 
-  /*
-   * TODO: deletion of a shader should not be
-   * required to be done with a GL context
-   * current.
+  /* the deletion is deferred to the PainterBackendGL current
+   * when the shader was compiled if it requested it, see
+   * PainterBackendGL::ConfigurationGL::deferred_resource_release().
    */
   if (d->m_name)
     {
-      glDeleteShader(d->m_name);
+      d->m_release_target.release(detail::shader_resource, d->m_name);
     }
   FASTUIDRAWdelete(d);
   m_d = nullptr;
@@ -1611,6 +1777,16 @@ name(void)
   return d->m_name;
 }
 
+GLuint
+fastuidraw::gl::Shader::
+issue_compile(void)
+{
+  ShaderPrivate *d;
+  d = static_cast<ShaderPrivate*>(m_d);
+  d->issue_compile();
+  return d->m_name;
+}
+
 bool
 fastuidraw::gl::Shader::
 shader_ready(void)
@@ -2163,9 +2339,13 @@ ProgramPrivate(GLuint pname, bool take_ownership, fastuidraw::gl::Program *p):
   m_delete_program(take_ownership),
   m_link_success(true),
   m_assembled(true),
+  m_assemble_issued(true),
   m_assemble_time(0.0f),
+  m_binary_cache_key(0),
+  m_from_binary_cache(false),
   m_p(p)
 {
+  m_release_target.capture();
   populate_info();
 }
 
@@ -2224,9 +2404,9 @@ populate_info(void)
 
 void
 ProgramPrivate::
-assemble(void)
+issue_assemble(void)
 {
-  if (m_assembled)
+  if (m_assemble_issued)
     {
       return;
     }
@@ -2234,43 +2414,130 @@ assemble(void)
   struct timeval start_time, end_time;
   gettimeofday(&start_time, nullptr);
 
-  std::ostringstream error_ostr;
-
-  m_assembled = true;
+  m_assemble_issued = true;
   FASTUIDRAWassert(m_name == 0);
+  m_release_target.capture();
   m_name = glCreateProgram();
   m_link_success = true;
 
-  //attatch the shaders, attaching a bad shader makes
-  //m_link_success become false
-  for(const auto &sh : m_shaders)
+  if (m_binary_cache && !fastuidraw::gl::ProgramBinaryCache::supported())
+    {
+      m_binary_cache = nullptr;
+    }
+
+  if (m_binary_cache)
     {
-      if (sh->compile_success())
+      m_binary_cache_key = compute_binary_cache_key();
+      m_from_binary_cache = m_binary_cache->load(m_binary_cache_key, m_name);
+      if (!m_from_binary_cache)
         {
-          glAttachShader(m_name, sh->name());
+          /* start with a fresh program object rather than
+           * one on which a glProgramBinary() failed.
+           */
+          glDeleteProgram(m_name);
+          m_name = glCreateProgram();
         }
-      else
+    }
+
+  if (!m_from_binary_cache)
+    {
+      /* issue the compiles of all shaders before querying any
+       * of them so that a GL implementation can compile them
+       * in parallel; a shader that fails to compile makes
+       * the link fail.
+       */
+      for(const auto &sh : m_shaders)
         {
-          m_link_success = false;
+          glAttachShader(m_name, sh->issue_compile());
         }
-    }
 
-  //we no longer need the GL shaders.
-  clear_shaders_and_save_shader_data();
+      //perform any pre-link actions
+      m_pre_link_actions.execute_actions(m_name);
+      if (m_binary_cache)
+        {
+          glProgramParameteri(m_name, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
 
-  //perform any pre-link actions and then clear them
-  m_pre_link_actions.execute_actions(m_name);
+      //now finally link!
+      glLinkProgram(m_name);
+    }
   m_pre_link_actions = fastuidraw::gl::PreLinkActionArray();
 
-  //now finally link!
-  glLinkProgram(m_name);
-
   gettimeofday(&end_time, nullptr);
   m_assemble_time = float(end_time.tv_sec - start_time.tv_sec)
     + float(end_time.tv_usec - start_time.tv_usec) / 1e6f;
+}
+
+bool
+ProgramPrivate::
+assemble_completed(void)
+{
+  if (m_assembled)
+    {
+      return true;
+    }
+
+  issue_assemble();
+  if (m_from_binary_cache)
+    {
+      return true;
+    }
+
+  fastuidraw::gl::ContextProperties ctx_props;
+  if (ctx_props.has_extension("GL_KHR_parallel_shader_compile")
+      || ctx_props.has_extension("GL_ARB_parallel_shader_compile"))
+    {
+      GLint status(GL_FALSE);
+      glGetProgramiv(m_name, GL_COMPLETION_STATUS_KHR, &status);
+      return status == GL_TRUE;
+    }
+
+  /* without the extension there is no way to know if the
+   * link has completed without potentially waiting on it.
+   */
+  return true;
+}
+
+void
+ProgramPrivate::
+assemble(void)
+{
+  if (m_assembled)
+    {
+      return;
+    }
+
+  issue_assemble();
+
+  struct timeval start_time, end_time;
+  gettimeofday(&start_time, nullptr);
+
+  m_assembled = true;
+  if (!m_from_binary_cache)
+    {
+      for(const auto &sh : m_shaders)
+        {
+          if (!sh->compile_success())
+            {
+              m_link_success = false;
+            }
+        }
+    }
+
+  //we no longer need the GL shaders.
+  clear_shaders_and_save_shader_data();
 
   populate_info();
 
+  gettimeofday(&end_time, nullptr);
+  m_assemble_time += float(end_time.tv_sec - start_time.tv_sec)
+    + float(end_time.tv_usec - start_time.tv_usec) / 1e6f;
+
+  if (m_binary_cache && m_link_success && !m_from_binary_cache)
+    {
+      m_binary_cache->store(m_binary_cache_key, m_name);
+    }
+
   if (!m_link_success)
     {
       std::ostringstream oo;
@@ -2291,6 +2558,31 @@ assemble(void)
   generate_log();
 }
 
+uint64_t
+ProgramPrivate::
+compute_binary_cache_key(void)
+{
+  FNV1a64 hasher;
+  uint32_t version(ProgramBinaryCachePrivate::Header::version_value);
+
+  hasher.add(&version, sizeof(version));
+  for(const auto &sh : m_shaders)
+    {
+      GLenum tp(sh->shader_type());
+      hasher
+        .add(&tp, sizeof(tp))
+        .add(sh->source_code());
+    }
+
+  hasher
+    .add(reinterpret_cast<fastuidraw::c_string>(glGetString(GL_VENDOR)))
+    .add(reinterpret_cast<fastuidraw::c_string>(glGetString(GL_RENDERER)))
+    .add(reinterpret_cast<fastuidraw::c_string>(glGetString(GL_VERSION)))
+    .add(m_binary_cache_binding_key.c_str());
+
+  return hasher.m_value;
+}
+
 void
 ProgramPrivate::
 clear_shaders_and_save_shader_data(void)
@@ -2299,9 +2591,20 @@ clear_shaders_and_save_shader_data(void)
   for(unsigned int i = 0, endi = m_shaders.size(); i<endi; ++i)
     {
       m_shader_data[i].m_source_code = m_shaders[i]->source_code();
-      m_shader_data[i].m_name = m_shaders[i]->name();
       m_shader_data[i].m_shader_type = m_shaders[i]->shader_type();
-      m_shader_data[i].m_compile_log = m_shaders[i]->compile_log();
+
+      /* a program loaded from a ProgramBinaryCache does
+       * not trigger compiling its shaders.
+       */
+      if (m_shaders[i]->shader_ready() || !m_from_binary_cache)
+        {
+          m_shader_data[i].m_name = m_shaders[i]->name();
+          m_shader_data[i].m_compile_log = m_shaders[i]->compile_log();
+        }
+      else
+        {
+          m_shader_data[i].m_name = 0;
+        }
       m_shader_data_sorted_by_type[m_shader_data[i].m_shader_type].push_back(i);
     }
   m_shaders.clear();
@@ -2539,7 +2842,7 @@ fastuidraw::gl::Program::
   d = static_cast<ProgramPrivate*>(m_d);
   if (d->m_name && d->m_delete_program)
     {
-      glDeleteProgram(d->m_name);
+      d->m_release_target.release(detail::program_resource, d->m_name);
     }
   FASTUIDRAWdelete(d);
   m_d = nullptr;
@@ -2877,6 +3180,198 @@ shader_compile_log(GLenum tp, unsigned int i) const
 }
 
 
+void
+fastuidraw::gl::Program::
+program_binary_cache(const reference_counted_ptr<ProgramBinaryCache> &cache,
+                     c_string binding_key)
+{
+  ProgramPrivate *d;
+  d = static_cast<ProgramPrivate*>(m_d);
+  FASTUIDRAWassert(!d->m_assemble_issued);
+  d->m_binary_cache = cache;
+  d->m_binary_cache_binding_key = (binding_key) ? binding_key : "";
+}
+
+void
+fastuidraw::gl::Program::
+issue_link(void)
+{
+  ProgramPrivate *d;
+  d = static_cast<ProgramPrivate*>(m_d);
+  d->issue_assemble();
+}
+
+bool
+fastuidraw::gl::Program::
+link_completed(void)
+{
+  ProgramPrivate *d;
+  d = static_cast<ProgramPrivate*>(m_d);
+  return d->assemble_completed();
+}
+
+bool
+fastuidraw::gl::Program::
+program_binary_from_cache(void)
+{
+  ProgramPrivate *d;
+  d = static_cast<ProgramPrivate*>(m_d);
+  d->assemble();
+  return d->m_from_binary_cache;
+}
+
+//////////////////////////////////////
+// fastuidraw::gl::ProgramBinaryCache methods
+fastuidraw::gl::ProgramBinaryCache::
+ProgramBinaryCache(c_string directory)
+{
+  m_d = FASTUIDRAWnew ProgramBinaryCachePrivate(directory);
+}
+
+fastuidraw::gl::ProgramBinaryCache::
+~ProgramBinaryCache()
+{
+  ProgramBinaryCachePrivate *d;
+  d = static_cast<ProgramBinaryCachePrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+fastuidraw::c_string
+fastuidraw::gl::ProgramBinaryCache::
+directory(void) const
+{
+  ProgramBinaryCachePrivate *d;
+  d = static_cast<ProgramBinaryCachePrivate*>(m_d);
+  return d->m_directory.c_str();
+}
+
+bool
+fastuidraw::gl::ProgramBinaryCache::
+supported(void)
+{
+  ContextProperties ctx_props;
+  bool has_program_binary;
+
+  if (ctx_props.is_es())
+    {
+      has_program_binary = ctx_props.version() >= ivec2(3, 0);
+    }
+  else
+    {
+      has_program_binary = ctx_props.version() >= ivec2(4, 1)
+        || ctx_props.has_extension("GL_ARB_get_program_binary");
+    }
+
+  /* a GL implementation may support the entry points
+   * but not provide any binary formats.
+   */
+  return has_program_binary
+    && context_get<GLint>(GL_NUM_PROGRAM_BINARY_FORMATS) > 0;
+}
+
+bool
+fastuidraw::gl::ProgramBinaryCache::
+load(uint64_t key, GLuint glsl_program)
+{
+  ProgramBinaryCachePrivate *d;
+  bool return_value;
+
+  d = static_cast<ProgramBinaryCachePrivate*>(m_d);
+  return_value = d->load(key, glsl_program);
+  if (return_value)
+    {
+      ++d->m_number_hits;
+    }
+  else
+    {
+      ++d->m_number_misses;
+    }
+  return return_value;
+}
+
+bool
+fastuidraw::gl::ProgramBinaryCache::
+store(uint64_t key, GLuint glsl_program)
+{
+  ProgramBinaryCachePrivate *d;
+  ProgramBinaryCachePrivate::Header header;
+  std::vector<char> binary;
+  GLint binary_size(0);
+  GLsizei written(0);
+  GLenum binary_format(GL_NONE);
+  std::string final_name, tmp_name;
+
+  d = static_cast<ProgramBinaryCachePrivate*>(m_d);
+  glGetProgramiv(glsl_program, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+  if (binary_size <= 0)
+    {
+      return false;
+    }
+
+  binary.resize(binary_size);
+  glGetProgramBinary(glsl_program, binary_size, &written, &binary_format, &binary[0]);
+  if (written <= 0)
+    {
+      return false;
+    }
+  binary.resize(written);
+
+  header.m_magic = ProgramBinaryCachePrivate::Header::magic_value;
+  header.m_version = ProgramBinaryCachePrivate::Header::version_value;
+  header.m_key = key;
+  header.m_binary_format = binary_format;
+  header.m_binary_size = binary.size();
+  header.m_checksum = FNV1a64().add(&binary[0], binary.size()).m_value;
+
+  /* write to a temporary file unique to this process
+   * and rename it so that readers never see a partially
+   * written entry.
+   */
+  final_name = d->filename(key);
+  std::ostringstream str;
+  str << final_name << ".tmp." << getpid();
+  tmp_name = str.str();
+
+  {
+    std::ofstream file(tmp_name.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(&binary[0], binary.size());
+    file.flush();
+    if (!file)
+      {
+        file.close();
+        std::remove(tmp_name.c_str());
+        return false;
+      }
+  }
+
+  if (std::rename(tmp_name.c_str(), final_name.c_str()) != 0)
+    {
+      std::remove(tmp_name.c_str());
+      return false;
+    }
+  return true;
+}
+
+unsigned int
+fastuidraw::gl::ProgramBinaryCache::
+number_hits(void) const
+{
+  ProgramBinaryCachePrivate *d;
+  d = static_cast<ProgramBinaryCachePrivate*>(m_d);
+  return d->m_number_hits;
+}
+
+unsigned int
+fastuidraw::gl::ProgramBinaryCache::
+number_misses(void) const
+{
+  ProgramBinaryCachePrivate *d;
+  d = static_cast<ProgramBinaryCachePrivate*>(m_d);
+  return d->m_number_misses;
+}
+
 //////////////////////////////////////
 // fastuidraw::gl::ProgramInitializerArray methods
 fastuidraw::gl::ProgramInitializerArray::
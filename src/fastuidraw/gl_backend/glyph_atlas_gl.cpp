@@ -25,6 +25,7 @@
 #include "private/buffer_object_gl.hpp"
 #include "private/tex_buffer.hpp"
 #include "private/texture_view.hpp"
+#include "private/deferred_release.hpp"
 #include "../private/util_private.hpp"
 
 namespace
@@ -32,7 +33,7 @@ namespace
   class TexelStoreGL:public fastuidraw::GlyphAtlasTexelBackingStoreBase
   {
   public:
-    TexelStoreGL(fastuidraw::ivec3 dims, bool delayed);
+    TexelStoreGL(fastuidraw::ivec3 dims, bool delayed, bool use_pixel_buffer);
 
     ~TexelStoreGL(void);
 
@@ -49,9 +50,33 @@ namespace
     GLuint
     texture(bool as_integer) const;
 
+    uint64_t
+    bytes_uploaded(void) const
+    {
+      return m_backing_store.bytes_uploaded();
+    }
+
+    uint64_t
+    upload_time_ns(void) const
+    {
+      return m_backing_store.upload_time_ns();
+    }
+
+    unsigned int
+    number_reallocations(void) const
+    {
+      return m_backing_store.number_reallocations();
+    }
+
+    uint64_t
+    bytes_copied_on_reallocation(void) const
+    {
+      return m_backing_store.bytes_copied_on_reallocation();
+    }
+
     static
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasTexelBackingStoreBase>
-    create(fastuidraw::ivec3 dims, bool delayed);
+    create(fastuidraw::ivec3 dims, bool delayed, bool use_pixel_buffer);
 
   protected:
 
@@ -67,6 +92,7 @@ namespace
                                               GL_NEAREST> TextureGL;
     TextureGL m_backing_store;
     mutable GLuint m_texture_as_r8;
+    mutable fastuidraw::gl::detail::DeferredReleaseTarget m_release_target;
   };
 
   class GeometryStoreGL:public fastuidraw::GlyphAtlasGeometryBackingStoreBase
@@ -85,6 +111,22 @@ namespace
     GLuint
     texture(void) const = 0;
 
+    virtual
+    uint64_t
+    bytes_uploaded(void) const = 0;
+
+    virtual
+    uint64_t
+    upload_time_ns(void) const = 0;
+
+    virtual
+    unsigned int
+    number_reallocations(void) const = 0;
+
+    virtual
+    uint64_t
+    bytes_copied_on_reallocation(void) const = 0;
+
     static
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasGeometryBackingStoreBase>
     create(const fastuidraw::gl::GlyphAtlasGL::params &P);
@@ -99,6 +141,8 @@ namespace
     explicit
     GeometryStoreGL_Buffer(unsigned int number_vecNs, bool delayed, unsigned int N);
 
+    ~GeometryStoreGL_Buffer();
+
     virtual
     void
     set_values(unsigned int location,
@@ -112,6 +156,34 @@ namespace
     GLuint
     texture(void) const;
 
+    virtual
+    uint64_t
+    bytes_uploaded(void) const
+    {
+      return m_backing_store.bytes_uploaded();
+    }
+
+    virtual
+    uint64_t
+    upload_time_ns(void) const
+    {
+      return m_backing_store.upload_time_ns();
+    }
+
+    virtual
+    unsigned int
+    number_reallocations(void) const
+    {
+      return m_backing_store.number_reallocations();
+    }
+
+    virtual
+    uint64_t
+    bytes_copied_on_reallocation(void) const
+    {
+      return m_backing_store.bytes_copied_on_reallocation();
+    }
+
   protected:
 
     virtual
@@ -123,6 +195,7 @@ namespace
     typedef fastuidraw::gl::detail::BufferGL<GL_TEXTURE_BUFFER, GL_STATIC_DRAW> BufferGL;
     BufferGL m_backing_store;
     mutable GLuint m_texture;
+    mutable fastuidraw::gl::detail::DeferredReleaseTarget m_release_target;
     mutable bool m_tbo_dirty;
   };
 
@@ -130,7 +203,8 @@ namespace
   {
   public:
     explicit
-    GeometryStoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_vecNs, bool delayed, unsigned int N);
+    GeometryStoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_vecNs,
+                            bool delayed, bool use_pixel_buffer, unsigned int N);
 
     virtual
     void
@@ -145,6 +219,34 @@ namespace
     GLuint
     texture(void) const;
 
+    virtual
+    uint64_t
+    bytes_uploaded(void) const
+    {
+      return m_backing_store.bytes_uploaded();
+    }
+
+    virtual
+    uint64_t
+    upload_time_ns(void) const
+    {
+      return m_backing_store.upload_time_ns();
+    }
+
+    virtual
+    unsigned int
+    number_reallocations(void) const
+    {
+      return m_backing_store.number_reallocations();
+    }
+
+    virtual
+    uint64_t
+    bytes_copied_on_reallocation(void) const
+    {
+      return m_backing_store.bytes_copied_on_reallocation();
+    }
+
   protected:
 
     virtual
@@ -178,6 +280,7 @@ namespace
       m_texel_store_dimensions(1024, 1024, 16),
       m_number_floats(1024 * 1024),
       m_delayed(false),
+      m_use_pixel_buffer_upload(false),
       m_alignment(4),
       m_type(fastuidraw::glsl::PainterBackendGLSL::glyph_geometry_tbo),
       m_log2_dims_geometry_store(-1, -1)
@@ -186,6 +289,7 @@ namespace
     fastuidraw::ivec3 m_texel_store_dimensions;
     unsigned int m_number_floats;
     bool m_delayed;
+    bool m_use_pixel_buffer_upload;
     unsigned int m_alignment;
     enum fastuidraw::glsl::PainterBackendGLSL::glyph_geometry_backing_t m_type;
     fastuidraw::ivec2 m_log2_dims_geometry_store;
@@ -208,9 +312,9 @@ namespace
 /////////////////////////////////////////
 // TexelStoreGL methods
 TexelStoreGL::
-TexelStoreGL(fastuidraw::ivec3 dims, bool delayed):
+TexelStoreGL(fastuidraw::ivec3 dims, bool delayed, bool use_pixel_buffer):
   fastuidraw::GlyphAtlasTexelBackingStoreBase(dims, true),
-  m_backing_store(dims, delayed),
+  m_backing_store(dims, delayed, use_pixel_buffer),
   m_texture_as_r8(0)
 {
   /* clear the right and bottom border
@@ -234,7 +338,7 @@ TexelStoreGL::
 {
   if (m_texture_as_r8 != 0)
     {
-      glDeleteTextures(1, &m_texture_as_r8);
+      m_release_target.release(fastuidraw::gl::detail::texture_resource, m_texture_as_r8);
     }
 }
 
@@ -253,7 +357,7 @@ resize_implement(int new_num_layers)
        *  We delete the old texture view and let texture()
        *  recreate the view on demand.
        */
-      glDeleteTextures(1, &m_texture_as_r8);
+      m_release_target.release(fastuidraw::gl::detail::texture_resource, m_texture_as_r8);
       m_texture_as_r8 = 0;
     }
 
@@ -310,6 +414,7 @@ texture(bool as_integer) const
       md = fastuidraw::gl::detail::compute_texture_view_support();
       if (md != fastuidraw::gl::detail::texture_view_not_supported)
         {
+          m_release_target.capture();
           glGenTextures(1, &m_texture_as_r8);
           FASTUIDRAWassert(m_texture_as_r8 != 0);
 
@@ -340,22 +445,23 @@ texture(bool as_integer) const
 
 fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasTexelBackingStoreBase>
 TexelStoreGL::
-create(fastuidraw::ivec3 dims, bool delayed)
+create(fastuidraw::ivec3 dims, bool delayed, bool use_pixel_buffer)
 {
   TexelStoreGL *p;
-  p = FASTUIDRAWnew TexelStoreGL(dims, delayed);
+  p = FASTUIDRAWnew TexelStoreGL(dims, delayed, use_pixel_buffer);
   return fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasTexelBackingStoreBase>(p);
 }
 
 ///////////////////////////////////////////////
 // GeometryStoreGL_Texture methods
 GeometryStoreGL_Texture::
-GeometryStoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_texels, bool delayed, unsigned int N):
+GeometryStoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_texels,
+                        bool delayed, bool use_pixel_buffer, unsigned int N):
   GeometryStoreGL(number_texels, N, GL_TEXTURE_2D_ARRAY, log2_wh),
   m_layer_dims(1 << log2_wh.x(), 1 << log2_wh.y()),
   m_texels_per_layer(m_layer_dims.x() * m_layer_dims.y()),
   m_backing_store(internal_format(N), external_format(N), GL_FLOAT, GL_NEAREST,
-                  texture_size(m_layer_dims, number_texels), delayed)
+                  texture_size(m_layer_dims, number_texels), delayed, use_pixel_buffer)
 {
   FASTUIDRAWassert(N <= 4 && N > 0);
 }
@@ -493,6 +599,12 @@ GeometryStoreGL_Buffer(unsigned int number_vecNs, bool delayed, unsigned int N):
   FASTUIDRAWassert(N <= 4 && N > 0);
 }
 
+GeometryStoreGL_Buffer::
+~GeometryStoreGL_Buffer()
+{
+  m_release_target.release(fastuidraw::gl::detail::texture_resource, m_texture);
+}
+
 void
 GeometryStoreGL_Buffer::
 set_values(unsigned int location,
@@ -525,6 +637,7 @@ texture(void) const
 {
   if (m_texture == 0)
     {
+      m_release_target.capture();
       glGenTextures(1, &m_texture);
       FASTUIDRAWassert(m_texture != 0);
     }
@@ -578,7 +691,8 @@ create(const fastuidraw::gl::GlyphAtlasGL::params &P)
 
     case fastuidraw::glsl::PainterBackendGLSL::glyph_geometry_texture_array:
       p = FASTUIDRAWnew GeometryStoreGL_Texture(P.texture_2d_array_geometry_store_log2_dims(),
-                                                number_vecNs, delayed, N);
+                                                number_vecNs, delayed,
+                                                P.use_pixel_buffer_upload(), N);
       break;
 
     default:
@@ -713,6 +827,9 @@ setget_implement(fastuidraw::gl::GlyphAtlasGL::params,
 setget_implement(fastuidraw::gl::GlyphAtlasGL::params,
                  GlyphAtlasGLParamsPrivate,
                  bool, delayed);
+setget_implement(fastuidraw::gl::GlyphAtlasGL::params,
+                 GlyphAtlasGLParamsPrivate,
+                 bool, use_pixel_buffer_upload);
 setget_implement(fastuidraw::gl::GlyphAtlasGL::params,
                  GlyphAtlasGLParamsPrivate,
                  unsigned int, alignment);
@@ -721,7 +838,8 @@ setget_implement(fastuidraw::gl::GlyphAtlasGL::params,
 // fastuidraw::gl::GlyphAtlasGL methods
 fastuidraw::gl::GlyphAtlasGL::
 GlyphAtlasGL(const params &P):
-  GlyphAtlas(TexelStoreGL::create(P.texel_store_dimensions(), P.delayed()),
+  GlyphAtlas(TexelStoreGL::create(P.texel_store_dimensions(), P.delayed(),
+                                  P.use_pixel_buffer_upload()),
              GeometryStoreGL::create(P))
 {
   m_d = FASTUIDRAWnew GlyphAtlasGLPrivate(P);
@@ -756,6 +874,62 @@ texel_texture(bool as_integer) const
   return p->texture(as_integer);
 }
 
+uint64_t
+fastuidraw::gl::GlyphAtlasGL::
+bytes_uploaded(void) const
+{
+  const TexelStoreGL *t;
+  const GeometryStoreGL *g;
+
+  FASTUIDRAWassert(dynamic_cast<const TexelStoreGL*>(texel_store().get()));
+  FASTUIDRAWassert(dynamic_cast<const GeometryStoreGL*>(geometry_store().get()));
+  t = static_cast<const TexelStoreGL*>(texel_store().get());
+  g = static_cast<const GeometryStoreGL*>(geometry_store().get());
+  return t->bytes_uploaded() + g->bytes_uploaded();
+}
+
+uint64_t
+fastuidraw::gl::GlyphAtlasGL::
+upload_time_ns(void) const
+{
+  const TexelStoreGL *t;
+  const GeometryStoreGL *g;
+
+  FASTUIDRAWassert(dynamic_cast<const TexelStoreGL*>(texel_store().get()));
+  FASTUIDRAWassert(dynamic_cast<const GeometryStoreGL*>(geometry_store().get()));
+  t = static_cast<const TexelStoreGL*>(texel_store().get());
+  g = static_cast<const GeometryStoreGL*>(geometry_store().get());
+  return t->upload_time_ns() + g->upload_time_ns();
+}
+
+unsigned int
+fastuidraw::gl::GlyphAtlasGL::
+number_reallocations(void) const
+{
+  const TexelStoreGL *t;
+  const GeometryStoreGL *g;
+
+  FASTUIDRAWassert(dynamic_cast<const TexelStoreGL*>(texel_store().get()));
+  FASTUIDRAWassert(dynamic_cast<const GeometryStoreGL*>(geometry_store().get()));
+  t = static_cast<const TexelStoreGL*>(texel_store().get());
+  g = static_cast<const GeometryStoreGL*>(geometry_store().get());
+  return t->number_reallocations() + g->number_reallocations();
+}
+
+uint64_t
+fastuidraw::gl::GlyphAtlasGL::
+bytes_copied_on_reallocation(void) const
+{
+  const TexelStoreGL *t;
+  const GeometryStoreGL *g;
+
+  FASTUIDRAWassert(dynamic_cast<const TexelStoreGL*>(texel_store().get()));
+  FASTUIDRAWassert(dynamic_cast<const GeometryStoreGL*>(geometry_store().get()));
+  t = static_cast<const TexelStoreGL*>(texel_store().get());
+  g = static_cast<const GeometryStoreGL*>(geometry_store().get());
+  return t->bytes_copied_on_reallocation() + g->bytes_copied_on_reallocation();
+}
+
 GLenum
 fastuidraw::gl::GlyphAtlasGL::
 geometry_texture_binding_point(void) const
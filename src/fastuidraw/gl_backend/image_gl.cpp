@@ -42,7 +42,8 @@ namespace
   class ColorBackingStoreGL:public fastuidraw::AtlasColorBackingStoreBase
   {
   public:
-    ColorBackingStoreGL(int log2_tile_size, int log2_num_tiles_per_row_per_col, int number_layers, bool delayed);
+    ColorBackingStoreGL(int log2_tile_size, int log2_num_tiles_per_row_per_col, int number_layers,
+                        bool delayed, bool use_pixel_buffer);
     ~ColorBackingStoreGL() {}
 
     virtual
@@ -64,16 +65,42 @@ namespace
       return m_backing_store.texture();
     }
 
+    uint64_t
+    bytes_uploaded(void) const
+    {
+      return m_backing_store.bytes_uploaded();
+    }
+
+    uint64_t
+    upload_time_ns(void) const
+    {
+      return m_backing_store.upload_time_ns();
+    }
+
+    unsigned int
+    number_reallocations(void) const
+    {
+      return m_backing_store.number_reallocations();
+    }
+
+    uint64_t
+    bytes_copied_on_reallocation(void) const
+    {
+      return m_backing_store.bytes_copied_on_reallocation();
+    }
+
     static
     fastuidraw::ivec3
     store_size(int log2_tile_size, int log2_num_tiles_per_row_per_col, int num_layers);
 
     static
     fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase>
-    create(int log2_tile_size, int log2_num_tiles_per_row_per_col, int num_layers, bool delayed)
+    create(int log2_tile_size, int log2_num_tiles_per_row_per_col, int num_layers,
+           bool delayed, bool use_pixel_buffer)
     {
       ColorBackingStoreGL *p;
-      p = FASTUIDRAWnew ColorBackingStoreGL(log2_tile_size, log2_num_tiles_per_row_per_col, num_layers, delayed);
+      p = FASTUIDRAWnew ColorBackingStoreGL(log2_tile_size, log2_num_tiles_per_row_per_col, num_layers,
+                                            delayed, use_pixel_buffer);
       return fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase>(p);
     }
 
@@ -99,7 +126,8 @@ namespace
     IndexBackingStoreGL(int log2_tile_size,
                         int log2_num_index_tiles_per_row_per_col,
                         int num_layers,
-                        bool delayed);
+                        bool delayed,
+                        bool use_pixel_buffer);
 
     ~IndexBackingStoreGL()
     {}
@@ -132,6 +160,30 @@ namespace
       return m_backing_store.texture();
     }
 
+    uint64_t
+    bytes_uploaded(void) const
+    {
+      return m_backing_store.bytes_uploaded();
+    }
+
+    uint64_t
+    upload_time_ns(void) const
+    {
+      return m_backing_store.upload_time_ns();
+    }
+
+    unsigned int
+    number_reallocations(void) const
+    {
+      return m_backing_store.number_reallocations();
+    }
+
+    uint64_t
+    bytes_copied_on_reallocation(void) const
+    {
+      return m_backing_store.bytes_copied_on_reallocation();
+    }
+
     static
     fastuidraw::ivec3
     store_size(int log2_tile_size,
@@ -142,12 +194,13 @@ namespace
     fastuidraw::reference_counted_ptr<fastuidraw::AtlasIndexBackingStoreBase>
     create(int log2_tile_size,
            int log2_num_index_tiles_per_row_per_col,
-           int num_layers, bool delayed)
+           int num_layers, bool delayed,
+           bool use_pixel_buffer)
     {
       IndexBackingStoreGL *p;
       p = FASTUIDRAWnew IndexBackingStoreGL(log2_tile_size,
                                            log2_num_index_tiles_per_row_per_col,
-                                           num_layers, delayed);
+                                           num_layers, delayed, use_pixel_buffer);
       return fastuidraw::reference_counted_ptr<fastuidraw::AtlasIndexBackingStoreBase>(p);
     }
 
@@ -185,7 +238,8 @@ namespace
       m_log2_index_tile_size(2),
       m_log2_num_index_tiles_per_row_per_col(6),
       m_num_index_layers(4),
-      m_delayed(false)
+      m_delayed(false),
+      m_use_pixel_buffer_upload(false)
     {}
 
     int m_log2_color_tile_size;
@@ -195,6 +249,7 @@ namespace
     int m_log2_num_index_tiles_per_row_per_col;
     int m_num_index_layers;
     bool m_delayed;
+    bool m_use_pixel_buffer_upload;
   };
 
   class ImageAtlasGLPrivate
@@ -218,10 +273,11 @@ ColorBackingStoreGL::
 ColorBackingStoreGL(int log2_tile_size,
                     int log2_num_tiles_per_row_per_col,
                     int number_layers,
-                    bool delayed):
+                    bool delayed,
+                    bool use_pixel_buffer):
   fastuidraw::AtlasColorBackingStoreBase(store_size(log2_tile_size, log2_num_tiles_per_row_per_col, number_layers),
                                          true),
-  m_backing_store(dimensions(), delayed)
+  m_backing_store(dimensions(), delayed, use_pixel_buffer)
 {}
 
 void
@@ -261,10 +317,11 @@ IndexBackingStoreGL::
 IndexBackingStoreGL(int log2_tile_size,
                     int log2_num_index_tiles_per_row_per_col,
                     int num_layers,
-                    bool delayed):
+                    bool delayed,
+                    bool use_pixel_buffer):
   fastuidraw::AtlasIndexBackingStoreBase(store_size(log2_tile_size, log2_num_index_tiles_per_row_per_col, num_layers),
                                         true),
-  m_backing_store(dimensions(), delayed)
+  m_backing_store(dimensions(), delayed, use_pixel_buffer)
 {}
 
 void
@@ -384,6 +441,9 @@ setget_implement(fastuidraw::gl::ImageAtlasGL::params,
 setget_implement(fastuidraw::gl::ImageAtlasGL::params,
                  ImageAtlasGLParamsPrivate,
                  bool, delayed)
+setget_implement(fastuidraw::gl::ImageAtlasGL::params,
+                 ImageAtlasGLParamsPrivate,
+                 bool, use_pixel_buffer_upload)
 
 //////////////////////////////////////////////
 // fastuidraw::gl::ImageAtlasGL methods
@@ -392,10 +452,12 @@ ImageAtlasGL(const params &P):
   fastuidraw::ImageAtlas(1 << P.log2_color_tile_size(), //color tile size
                         1 << P.log2_index_tile_size(), //index tile size
                         ColorBackingStoreGL::create(P.log2_color_tile_size(), P.log2_num_color_tiles_per_row_per_col(),
-                                                    P.num_color_layers(), P.delayed()),
+                                                    P.num_color_layers(), P.delayed(),
+                                                    P.use_pixel_buffer_upload()),
                         IndexBackingStoreGL::create(P.log2_index_tile_size(),
                                                     P.log2_num_index_tiles_per_row_per_col(),
-                                                    P.num_index_layers(), P.delayed()))
+                                                    P.num_index_layers(), P.delayed(),
+                                                    P.use_pixel_buffer_upload()))
 {
   m_d = FASTUIDRAWnew ImageAtlasGLPrivate(P);
 }
@@ -440,6 +502,62 @@ index_texture(void) const
   return p->texture();
 }
 
+uint64_t
+fastuidraw::gl::ImageAtlasGL::
+bytes_uploaded(void) const
+{
+  const ColorBackingStoreGL *c;
+  const IndexBackingStoreGL *i;
+
+  FASTUIDRAWassert(dynamic_cast<const ColorBackingStoreGL*>(color_store().get()));
+  FASTUIDRAWassert(dynamic_cast<const IndexBackingStoreGL*>(index_store().get()));
+  c = static_cast<const ColorBackingStoreGL*>(color_store().get());
+  i = static_cast<const IndexBackingStoreGL*>(index_store().get());
+  return c->bytes_uploaded() + i->bytes_uploaded();
+}
+
+uint64_t
+fastuidraw::gl::ImageAtlasGL::
+upload_time_ns(void) const
+{
+  const ColorBackingStoreGL *c;
+  const IndexBackingStoreGL *i;
+
+  FASTUIDRAWassert(dynamic_cast<const ColorBackingStoreGL*>(color_store().get()));
+  FASTUIDRAWassert(dynamic_cast<const IndexBackingStoreGL*>(index_store().get()));
+  c = static_cast<const ColorBackingStoreGL*>(color_store().get());
+  i = static_cast<const IndexBackingStoreGL*>(index_store().get());
+  return c->upload_time_ns() + i->upload_time_ns();
+}
+
+unsigned int
+fastuidraw::gl::ImageAtlasGL::
+number_reallocations(void) const
+{
+  const ColorBackingStoreGL *c;
+  const IndexBackingStoreGL *i;
+
+  FASTUIDRAWassert(dynamic_cast<const ColorBackingStoreGL*>(color_store().get()));
+  FASTUIDRAWassert(dynamic_cast<const IndexBackingStoreGL*>(index_store().get()));
+  c = static_cast<const ColorBackingStoreGL*>(color_store().get());
+  i = static_cast<const IndexBackingStoreGL*>(index_store().get());
+  return c->number_reallocations() + i->number_reallocations();
+}
+
+uint64_t
+fastuidraw::gl::ImageAtlasGL::
+bytes_copied_on_reallocation(void) const
+{
+  const ColorBackingStoreGL *c;
+  const IndexBackingStoreGL *i;
+
+  FASTUIDRAWassert(dynamic_cast<const ColorBackingStoreGL*>(color_store().get()));
+  FASTUIDRAWassert(dynamic_cast<const IndexBackingStoreGL*>(index_store().get()));
+  c = static_cast<const ColorBackingStoreGL*>(color_store().get());
+  i = static_cast<const IndexBackingStoreGL*>(index_store().get());
+  return c->bytes_copied_on_reallocation() + i->bytes_copied_on_reallocation();
+}
+
 fastuidraw::vecN<fastuidraw::vec2, 2>
 fastuidraw::gl::ImageAtlasGL::
 shader_coords(reference_counted_ptr<Image> image)
@@ -22,6 +22,9 @@
 #include <sstream>
 #include <vector>
 #include <iostream>
+#include <chrono>
+#include <limits>
+#include <cstring>
 
 #include <fastuidraw/gl_backend/painter_backend_gl.hpp>
 #include <fastuidraw/gl_backend/ngl_header.hpp>
@@ -34,6 +37,8 @@
 #include "../private/util_private.hpp"
 #include "private/tex_buffer.hpp"
 #include "private/texture_gl.hpp"
+#include "private/deferred_release.hpp"
+#include "private/gpu_timer.hpp"
 
 #ifdef FASTUIDRAW_GL_USE_GLES
 #define GL_SRC1_COLOR GL_SRC1_COLOR_EXT
@@ -232,6 +237,19 @@ namespace
     return in_value;
   }
 
+  class ring_segment;
+
+  /* layout of a command of glMultiDrawElementsIndirect */
+  class DrawElementsIndirectCommand
+  {
+  public:
+    GLuint m_count;
+    GLuint m_instance_count;
+    GLuint m_first_index;
+    GLint m_base_vertex;
+    GLuint m_base_instance;
+  };
+
   class painter_vao
   {
   public:
@@ -241,7 +259,12 @@ namespace
       m_header_bo(0),
       m_index_bo(0),
       m_data_bo(0),
-      m_data_tbo(0)
+      m_data_tbo(0),
+      m_attribute_offset(0),
+      m_header_offset(0),
+      m_index_offset(0),
+      m_data_offset(0),
+      m_segment(nullptr)
     {}
 
     GLuint m_vao;
@@ -249,6 +272,68 @@ namespace
     GLuint m_data_tbo;
     enum fastuidraw::gl::PainterBackendGL::data_store_backing_t m_data_store_backing;
     unsigned int m_data_store_binding_point;
+
+    /* offsets in bytes into the buffer objects of the
+     * data of the painter_vao; these are non-zero only
+     * for segments of the persistently mapped ring buffers.
+     */
+    unsigned int m_attribute_offset, m_header_offset;
+    unsigned int m_index_offset, m_data_offset;
+
+    /* non-null exactly when the painter_vao is a segment
+     * of the persistently mapped ring buffers.
+     */
+    ring_segment *m_segment;
+  };
+
+  /* A ring_segment is a portion of the persistently mapped
+   * buffers of a ring_chunk that is used by a single DrawCommand.
+   * A segment is pending from when it is handed to a DrawCommand
+   * until the DrawCommand is drawn (at which point a fence is
+   * placed after the draw) or the DrawCommand is deleted without
+   * being drawn.
+   */
+  class ring_segment:fastuidraw::noncopyable
+  {
+  public:
+    enum state_t
+      {
+        segment_free,
+        segment_pending,
+        segment_fenced,
+      };
+
+    ring_segment(void):
+      m_fence(nullptr),
+      m_state(segment_free)
+    {}
+
+    painter_vao m_vao;
+    GLsync m_fence;
+    enum state_t m_state;
+
+    fastuidraw::c_array<fastuidraw::PainterAttribute> m_attributes;
+    fastuidraw::c_array<uint32_t> m_header_attributes;
+    fastuidraw::c_array<fastuidraw::PainterIndex> m_indices;
+    fastuidraw::c_array<fastuidraw::generic_data> m_store;
+  };
+
+  /* A ring_chunk is a set of buffer objects, one for each stream,
+   * allocated with glBufferStorage and mapped once for the lifetime
+   * of the chunk, carved into segments.
+   */
+  class ring_chunk
+  {
+  public:
+    ring_chunk(void):
+      m_attribute_bo(0),
+      m_header_bo(0),
+      m_index_bo(0),
+      m_data_bo(0)
+    {}
+
+    GLuint m_attribute_bo, m_header_bo, m_index_bo, m_data_bo;
+    std::vector<ring_segment*> m_segments;
   };
 
   class painter_vao_pool:fastuidraw::noncopyable
@@ -295,6 +380,85 @@ namespace
     GLuint //objects are recycled; make sure size never increases!
     request_uniform_ubo(unsigned int ubo_size, GLenum target);
 
+    /* called by DrawCommand after it issued the draw calls
+     * of its segment.
+     */
+    void
+    segment_drawn(ring_segment *segment);
+
+    /* called by DrawCommand when it is deleted */
+    void
+    segment_released(ring_segment *segment);
+
+    void
+    record_map_stall(std::chrono::steady_clock::time_point start);
+
+    void
+    record_bytes_streamed(uint64_t v)
+    {
+      m_bytes_streamed += v;
+    }
+
+    uint64_t
+    last_frame_bytes_streamed(void) const
+    {
+      return m_last_frame_bytes_streamed;
+    }
+
+    uint64_t
+    last_frame_stall_ns(void) const
+    {
+      return m_last_frame_stall_ns;
+    }
+
+    /* calls is the number of GL draw calls issued and ranges
+     * is the number of index ranges they drew.
+     */
+    void
+    record_draw_calls(unsigned int calls, unsigned int ranges)
+    {
+      m_draw_calls += calls;
+      m_draw_calls_saved += ranges - calls;
+    }
+
+    uint64_t
+    last_frame_draw_calls(void) const
+    {
+      return m_last_frame_draw_calls;
+    }
+
+    uint64_t
+    last_frame_draw_calls_saved(void) const
+    {
+      return m_last_frame_draw_calls_saved;
+    }
+
+    /* scratch space for the commands of glMultiDrawElementsIndirect */
+    std::vector<DrawElementsIndirectCommand>&
+    indirect_commands(void)
+    {
+      return m_indirect_commands;
+    }
+
+    /* upload indirect_commands() to a buffer object and
+     * bind it to GL_DRAW_INDIRECT_BUFFER
+     */
+    void
+    upload_indirect_commands(void);
+
+    /* CPU-side storage to which the indices of a DrawCommand
+     * are written when ConfigurationGL::compact_indices() is
+     * true; the storage is recycled with release_index_scratch().
+     */
+    std::vector<fastuidraw::PainterIndex>*
+    acquire_index_scratch(void);
+
+    void
+    release_index_scratch(std::vector<fastuidraw::PainterIndex> *p)
+    {
+      m_index_scratch.push_back(p);
+    }
+
   private:
     void
     generate_tbos(painter_vao &vao);
@@ -305,6 +469,22 @@ namespace
     GLuint
     generate_bo(GLenum bind_target, GLsizei psize);
 
+    void
+    set_vao_attributes(GLuint attribute_bo, unsigned int attribute_offset,
+                       GLuint header_bo, unsigned int header_offset);
+
+    painter_vao
+    request_ring_vao(void);
+
+    void
+    add_ring_chunk(void);
+
+    GLuint
+    generate_persistent_bo(GLenum bind_target, GLsizei psize, void **mapped);
+
+    void
+    wait_segment(ring_segment *segment);
+
     unsigned int m_attribute_buffer_size, m_header_buffer_size;
     unsigned int m_index_buffer_size;
     int m_alignment, m_blocks_per_data_buffer;
@@ -316,6 +496,24 @@ namespace
     unsigned int m_current, m_pool;
     std::vector<std::vector<painter_vao> > m_vaos;
     std::vector<GLuint> m_ubos;
+
+    /* persistently mapped ring buffers, m_ring lists the
+     * segments in the order in which they are used.
+     */
+    bool m_persistent_mapped_buffers;
+    unsigned int m_segments_per_chunk, m_data_segment_size;
+    std::vector<ring_chunk> m_chunks;
+    std::vector<ring_segment*> m_ring;
+    unsigned int m_ring_current;
+
+    uint64_t m_bytes_streamed, m_stall_ns;
+    uint64_t m_last_frame_bytes_streamed, m_last_frame_stall_ns;
+    uint64_t m_draw_calls, m_draw_calls_saved;
+    uint64_t m_last_frame_draw_calls, m_last_frame_draw_calls_saved;
+
+    GLuint m_indirect_bo;
+    std::vector<DrawElementsIndirectCommand> m_indirect_commands;
+    std::vector<std::vector<fastuidraw::PainterIndex>*> m_index_scratch;
   };
 
   bool
@@ -348,6 +546,41 @@ namespace
     bool m_use_hw_clip_planes;
   };
 
+  /* filter to build a program specialized to a single
+   * item shader (and its sub-shaders).
+   */
+  class SpecializedItemShaderFilter:public fastuidraw::glsl::PainterBackendGLSL::ItemShaderFilter
+  {
+  public:
+    explicit
+    SpecializedItemShaderFilter(uint32_t shader_id):
+      m_shader_id(shader_id)
+    {}
+
+    bool
+    use_shader(const fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> &shader) const
+    {
+      return shader->ID() == m_shader_id;
+    }
+
+  private:
+    uint32_t m_shader_id;
+  };
+
+  class SpecializedProgram
+  {
+  public:
+    SpecializedProgram(void):
+      m_use_count(0)
+    {}
+
+    /* number of times a DrawEntry with the item shader
+     * group of this SpecializedProgram was drawn
+     */
+    unsigned int m_use_count;
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::Program> m_program;
+  };
+
   class ImageBarrier:public fastuidraw::PainterDraw::Action
   {
   public:
@@ -357,6 +590,13 @@ namespace
     {
       glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
     }
+
+    virtual
+    bool
+    barrier(void) const
+    {
+      return true;
+    }
   };
 
   class PainterBackendGLPrivate
@@ -383,6 +623,9 @@ namespace
     const program_set&
     programs(bool rebuild);
 
+    void
+    finish_pending_programs(bool wait);
+
     void
     configure_backend(void);
 
@@ -393,7 +636,11 @@ namespace
     build_programs(void);
 
     program_ref
-    build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp);
+    build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp,
+                  const fastuidraw::glsl::PainterBackendGLSL::ItemShaderFilter *item_filter);
+
+    fastuidraw::gl::Program*
+    select_program(unsigned int choice, uint32_t item_group);
 
     void
     build_vao_tbos(void);
@@ -415,6 +662,26 @@ namespace
     fastuidraw::glsl::ShaderSource m_front_matter_vert;
     fastuidraw::glsl::ShaderSource m_front_matter_frag;
     program_set m_programs;
+
+    /* programs being built asynchronously that replace
+     * m_programs once they finish linking.
+     */
+    program_set m_pending_programs;
+    bool m_have_pending_programs;
+
+    /* programs specialized to a single item shader, keyed
+     * by the item shader group, see compute_item_shader_group().
+     */
+    std::map<uint32_t, SpecializedProgram> m_specialized_programs;
+    unsigned int m_number_specialized_programs;
+    unsigned int m_last_frame_resources_released;
+
+    /* queue of the GL objects made while this is current
+     * whose deletion is deferred, nullptr if deferred release
+     * is not enabled.
+     */
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::DeferredReleaseQueue> m_release_queue;
+    fastuidraw::gl::detail::GPUTimer *m_gpu_timer;
     std::vector<fastuidraw::generic_data> m_uniform_values;
     fastuidraw::c_array<fastuidraw::generic_data> m_uniform_values_ptr;
     painter_vao_pool *m_pool;
@@ -427,16 +694,53 @@ namespace
   public:
     DrawEntry(const fastuidraw::BlendMode &mode,
               PainterBackendGLPrivate *pr,
-              unsigned int pz);
+              unsigned int pz,
+              uint32_t item_group = 0u);
+
+    DrawEntry(const fastuidraw::BlendMode &mode, uint32_t item_group = 0u);
 
-    DrawEntry(const fastuidraw::BlendMode &mode);
     DrawEntry(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw::Action> &action);
 
+    /* first is the location of the range in the indices of
+     * the DrawCommand; if merge is true and the range is
+     * contiguous with the last range of the entry, the last
+     * range is extended instead of adding a new range.
+     */
     void
-    add_entry(GLsizei count, const void *offset);
+    add_entry(GLsizei count, GLsizei first, bool merge);
 
+    /* sets the index type with which the ranges are drawn
+     * and the location, in units of the index type, in the
+     * index buffer of the first index of the DrawCommand;
+     * must be called after the last call to add_entry().
+     */
     void
-    draw(void) const;
+    set_index_format(GLenum index_type, GLsizei base_index);
+
+    void
+    add_indirect_commands(std::vector<DrawElementsIndirectCommand> *dst) const;
+
+    /* Draws the entry; if indirect_offset is non-null the draw commands
+     * of the entry are sourced from the buffer bound to GL_DRAW_INDIRECT_BUFFER
+     * at the offset *indirect_offset which is then advanced. Returns the
+     * number of GL draw calls issued.
+     */
+    unsigned int
+    draw(GLintptr *indirect_offset) const;
+
+    /* number of ranges passed to add_entry() */
+    unsigned int
+    number_ranges(void) const
+    {
+      return m_number_ranges;
+    }
+
+    /* the item shader group of the draws of the entry */
+    uint32_t
+    item_group(void) const
+    {
+      return m_item_group;
+    }
 
   private:
 
@@ -452,9 +756,14 @@ namespace
     fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw::Action> m_action;
 
     std::vector<GLsizei> m_counts;
+    std::vector<GLsizei> m_firsts;
     std::vector<const GLvoid*> m_indices;
+    GLenum m_index_type;
+    GLsizei m_base_index;
+    unsigned int m_number_ranges;
     PainterBackendGLPrivate *m_private;
     unsigned int m_choice;
+    uint32_t m_item_group;
   };
 
   class DrawCommand:public fastuidraw::PainterDraw
@@ -467,7 +776,17 @@ namespace
 
     virtual
     ~DrawCommand()
-    {}
+    {
+      if (m_vao.m_segment)
+        {
+          m_pool->segment_released(m_vao.m_segment);
+        }
+
+      if (m_index_scratch)
+        {
+          m_pool->release_index_scratch(m_index_scratch);
+        }
+    }
 
     virtual
     void
@@ -497,8 +816,27 @@ namespace
     void
     add_entry(unsigned int indices_written) const;
 
+    void
+    map_buffers(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &params);
+
+    /* write the indices from m_index_scratch to the index
+     * buffer, returns the number of bytes written.
+     */
+    unsigned int
+    write_compact_indices(unsigned int attributes_written,
+                          unsigned int indices_written) const;
+
     PainterBackendGLPrivate *m_pr;
+    painter_vao_pool *m_pool;
     painter_vao m_vao;
+
+    /* when ConfigurationGL::compact_indices() is true, the
+     * indices are written by the packer to m_index_scratch
+     * and copied to m_mapped_indices at unmap.
+     */
+    mutable std::vector<fastuidraw::PainterIndex> *m_index_scratch;
+    fastuidraw::PainterIndex *m_mapped_indices;
+    mutable GLenum m_index_type;
     mutable unsigned int m_attributes_written, m_indices_written;
     mutable std::list<DrawEntry> m_draws;
   };
@@ -593,6 +931,7 @@ namespace
     fastuidraw::vecN<GLuint, number_auxiliary_buffer_t> m_auxiliary_buffer;
     fastuidraw::vecN<GLuint, number_buffer_t> m_buffers;
     fastuidraw::vecN<GLuint, number_fbo_t> m_fbo;
+    fastuidraw::gl::detail::DeferredReleaseTarget m_release_target;
     bool m_own_texture;
   };
 
@@ -620,7 +959,17 @@ namespace
       m_separate_program_for_discard(true),
       m_default_stroke_shader_aa_type(fastuidraw::PainterStrokeShader::draws_solid_then_fuzz),
       m_blend_type(fastuidraw::PainterBlendShader::dual_src),
-      m_provide_auxiliary_image_buffer(fastuidraw::glsl::PainterBackendGLSL::no_auxiliary_buffer)
+      m_provide_auxiliary_image_buffer(fastuidraw::glsl::PainterBackendGLSL::no_auxiliary_buffer),
+      m_async_program_rebuild(false),
+      m_specialized_program_threshold(0),
+      m_max_specialized_programs(32),
+      m_persistent_mapped_buffers(false),
+      m_persistent_buffer_segments(16),
+      m_multi_draw_indirect(false),
+      m_deferred_resource_release(false),
+      m_resource_release_budget(64),
+      m_gpu_timer_queries(false),
+      m_compact_indices(false)
     {}
 
     unsigned int m_attributes_per_buffer;
@@ -644,6 +993,17 @@ namespace
     enum fastuidraw::PainterStrokeShader::type_t m_default_stroke_shader_aa_type;
     enum fastuidraw::PainterBlendShader::shader_type m_blend_type;
     enum fastuidraw::glsl::PainterBackendGLSL::auxiliary_buffer_t m_provide_auxiliary_image_buffer;
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache> m_program_binary_cache;
+    bool m_async_program_rebuild;
+    unsigned int m_specialized_program_threshold;
+    unsigned int m_max_specialized_programs;
+    bool m_persistent_mapped_buffers;
+    unsigned int m_persistent_buffer_segments;
+    bool m_multi_draw_indirect;
+    bool m_deferred_resource_release;
+    unsigned int m_resource_release_budget;
+    bool m_gpu_timer_queries;
+    bool m_compact_indices;
   };
 
 }
@@ -667,8 +1027,39 @@ painter_vao_pool(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &params
   m_current(0),
   m_pool(0),
   m_vaos(params.number_pools()),
-  m_ubos(params.number_pools(), 0)
-{}
+  m_ubos(params.number_pools(), 0),
+  m_persistent_mapped_buffers(params.persistent_mapped_buffers()),
+  m_segments_per_chunk(fastuidraw::t_max(1u, params.persistent_buffer_segments())),
+  m_data_segment_size(m_data_buffer_size),
+  m_ring_current(0),
+  m_bytes_streamed(0),
+  m_stall_ns(0),
+  m_last_frame_bytes_streamed(0),
+  m_last_frame_stall_ns(0),
+  m_draw_calls(0),
+  m_draw_calls_saved(0),
+  m_last_frame_draw_calls(0),
+  m_last_frame_draw_calls_saved(0),
+  m_indirect_bo(0)
+{
+  #ifndef FASTUIDRAW_GL_USE_GLES
+    {
+      if (m_persistent_mapped_buffers)
+        {
+          GLint align;
+
+          /* the data store of a segment is bound with glBindBufferRange
+           * or glTexBufferRange whose offsets must be aligned.
+           */
+          align = (m_data_store_backing == fastuidraw::gl::PainterBackendGL::data_store_ubo) ?
+            fastuidraw::gl::context_get<GLint>(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT) :
+            fastuidraw::gl::context_get<GLint>(GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT);
+          align = fastuidraw::t_max(align, 1);
+          m_data_segment_size = align * ((m_data_buffer_size + align - 1) / align);
+        }
+    }
+  #endif
+}
 
 painter_vao_pool::
 ~painter_vao_pool()
@@ -694,6 +1085,38 @@ painter_vao_pool::
           glDeleteBuffers(1, &m_ubos[p]);
         }
     }
+
+  if (m_indirect_bo != 0)
+    {
+      glDeleteBuffers(1, &m_indirect_bo);
+    }
+
+  for(std::vector<fastuidraw::PainterIndex> *p : m_index_scratch)
+    {
+      FASTUIDRAWdelete(p);
+    }
+
+  for(ring_chunk &chunk : m_chunks)
+    {
+      for(ring_segment *segment : chunk.m_segments)
+        {
+          if (segment->m_fence)
+            {
+              glDeleteSync(segment->m_fence);
+            }
+          if (segment->m_vao.m_data_tbo != 0)
+            {
+              glDeleteTextures(1, &segment->m_vao.m_data_tbo);
+            }
+          glDeleteVertexArrays(1, &segment->m_vao.m_vao);
+          FASTUIDRAWdelete(segment);
+        }
+      /* deleting a buffer object also unmaps it */
+      glDeleteBuffers(1, &chunk.m_attribute_bo);
+      glDeleteBuffers(1, &chunk.m_header_bo);
+      glDeleteBuffers(1, &chunk.m_index_bo);
+      glDeleteBuffers(1, &chunk.m_data_bo);
+    }
 }
 
 GLuint
@@ -726,10 +1149,13 @@ request_vao(void)
 {
   painter_vao return_value;
 
-  if (m_current == m_vaos[m_pool].size())
+  if (m_persistent_mapped_buffers)
     {
-      fastuidraw::gl::opengl_trait_value v;
+      return request_ring_vao();
+    }
 
+  if (m_current == m_vaos[m_pool].size())
+    {
       m_vaos[m_pool].resize(m_current + 1);
       glGenVertexArrays(1, &m_vaos[m_pool][m_current].m_vao);
 
@@ -761,26 +1187,9 @@ request_vao(void)
        */
       m_vaos[m_pool][m_current].m_attribute_bo = generate_bo(GL_ARRAY_BUFFER, m_attribute_buffer_size);
       m_vaos[m_pool][m_current].m_index_bo = generate_bo(GL_ELEMENT_ARRAY_BUFFER, m_index_buffer_size);
-
-      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::primary_attrib_slot);
-      v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(sizeof(fastuidraw::PainterAttribute),
-                                                                 offsetof(fastuidraw::PainterAttribute, m_attrib0));
-      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::primary_attrib_slot, v);
-
-      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::secondary_attrib_slot);
-      v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(sizeof(fastuidraw::PainterAttribute),
-                                                                 offsetof(fastuidraw::PainterAttribute, m_attrib1));
-      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::secondary_attrib_slot, v);
-
-      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::uint_attrib_slot);
-      v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(sizeof(fastuidraw::PainterAttribute),
-                                                                 offsetof(fastuidraw::PainterAttribute, m_attrib2));
-      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::uint_attrib_slot, v);
-
       m_vaos[m_pool][m_current].m_header_bo = generate_bo(GL_ARRAY_BUFFER, m_header_buffer_size);
-      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot);
-      v = fastuidraw::gl::opengl_trait_values<uint32_t>();
-      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot, v);
+      set_vao_attributes(m_vaos[m_pool][m_current].m_attribute_bo, 0,
+                         m_vaos[m_pool][m_current].m_header_bo, 0);
 
       glBindVertexArray(0);
     }
@@ -791,6 +1200,266 @@ request_vao(void)
   return return_value;
 }
 
+void
+painter_vao_pool::
+set_vao_attributes(GLuint attribute_bo, unsigned int attribute_offset,
+                   GLuint header_bo, unsigned int header_offset)
+{
+  fastuidraw::gl::opengl_trait_value v;
+
+  glBindBuffer(GL_ARRAY_BUFFER, attribute_bo);
+  glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::primary_attrib_slot);
+  v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(sizeof(fastuidraw::PainterAttribute),
+                                                             attribute_offset
+                                                             + offsetof(fastuidraw::PainterAttribute, m_attrib0));
+  fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::primary_attrib_slot, v);
+
+  glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::secondary_attrib_slot);
+  v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(sizeof(fastuidraw::PainterAttribute),
+                                                             attribute_offset
+                                                             + offsetof(fastuidraw::PainterAttribute, m_attrib1));
+  fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::secondary_attrib_slot, v);
+
+  glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::uint_attrib_slot);
+  v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(sizeof(fastuidraw::PainterAttribute),
+                                                             attribute_offset
+                                                             + offsetof(fastuidraw::PainterAttribute, m_attrib2));
+  fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::uint_attrib_slot, v);
+
+  glBindBuffer(GL_ARRAY_BUFFER, header_bo);
+  glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot);
+  v = fastuidraw::gl::opengl_trait_values<uint32_t>(sizeof(uint32_t), header_offset);
+  fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot, v);
+}
+
+painter_vao
+painter_vao_pool::
+request_ring_vao(void)
+{
+  ring_segment *segment;
+
+  /* if the next segment of the ring is still held by a DrawCommand
+   * that has not been drawn, the ring is too small for the number of
+   * DrawCommand objects in flight; grow the ring by inserting a new
+   * chunk of segments before it. Once the ring is large enough for a
+   * frame, no more buffers are allocated.
+   */
+  if (m_ring.empty() || m_ring[m_ring_current]->m_state == ring_segment::segment_pending)
+    {
+      add_ring_chunk();
+    }
+
+  segment = m_ring[m_ring_current];
+  if (segment->m_state == ring_segment::segment_fenced)
+    {
+      wait_segment(segment);
+    }
+
+  FASTUIDRAWassert(segment->m_state == ring_segment::segment_free);
+  segment->m_state = ring_segment::segment_pending;
+
+  ++m_ring_current;
+  if (m_ring_current == m_ring.size())
+    {
+      m_ring_current = 0;
+    }
+
+  return segment->m_vao;
+}
+
+void
+painter_vao_pool::
+wait_segment(ring_segment *segment)
+{
+  GLenum result;
+
+  FASTUIDRAWassert(segment->m_fence);
+  result = glClientWaitSync(segment->m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  if (result == GL_TIMEOUT_EXPIRED)
+    {
+      std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+      const GLuint64 timeout_ns(1000000u);
+
+      do
+        {
+          result = glClientWaitSync(segment->m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns);
+        }
+      while (result == GL_TIMEOUT_EXPIRED);
+      record_map_stall(start);
+    }
+
+  glDeleteSync(segment->m_fence);
+  segment->m_fence = nullptr;
+  segment->m_state = ring_segment::segment_free;
+}
+
+void
+painter_vao_pool::
+segment_drawn(ring_segment *segment)
+{
+  if (segment->m_fence)
+    {
+      glDeleteSync(segment->m_fence);
+    }
+  segment->m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  segment->m_state = ring_segment::segment_fenced;
+}
+
+void
+painter_vao_pool::
+segment_released(ring_segment *segment)
+{
+  /* a segment whose DrawCommand was never drawn was never
+   * used by GL and can be reused immediately.
+   */
+  if (segment->m_state == ring_segment::segment_pending)
+    {
+      segment->m_state = ring_segment::segment_free;
+    }
+}
+
+void
+painter_vao_pool::
+record_map_stall(std::chrono::steady_clock::time_point start)
+{
+  std::chrono::steady_clock::duration d(std::chrono::steady_clock::now() - start);
+  m_stall_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+}
+
+GLuint
+painter_vao_pool::
+generate_persistent_bo(GLenum bind_target, GLsizei psize, void **mapped)
+{
+  GLuint return_value(0);
+
+  glGenBuffers(1, &return_value);
+  FASTUIDRAWassert(return_value != 0);
+  glBindBuffer(bind_target, return_value);
+
+  #ifndef FASTUIDRAW_GL_USE_GLES
+    {
+      /* the mapping is not coherent, writes are made visible
+       * to GL with glFlushMappedBufferRange() when a DrawCommand
+       * is unmapped.
+       */
+      glBufferStorage(bind_target, psize, nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT);
+      *mapped = glMapBufferRange(bind_target, 0, psize,
+                                 GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+    }
+  #else
+    {
+      FASTUIDRAWunused(psize);
+      FASTUIDRAWassert(!"Persistently mapped buffers not supported on GLES");
+      *mapped = nullptr;
+    }
+  #endif
+
+  FASTUIDRAWassert(*mapped != nullptr);
+  return return_value;
+}
+
+void
+painter_vao_pool::
+add_ring_chunk(void)
+{
+  void *attr_ptr, *header_ptr, *index_ptr, *data_ptr;
+  unsigned int N(m_segments_per_chunk);
+
+  m_chunks.push_back(ring_chunk());
+  ring_chunk &chunk(m_chunks.back());
+
+  chunk.m_attribute_bo = generate_persistent_bo(GL_ARRAY_BUFFER, N * m_attribute_buffer_size, &attr_ptr);
+  chunk.m_header_bo = generate_persistent_bo(GL_ARRAY_BUFFER, N * m_header_buffer_size, &header_ptr);
+  chunk.m_index_bo = generate_persistent_bo(GL_ARRAY_BUFFER, N * m_index_buffer_size, &index_ptr);
+  chunk.m_data_bo = generate_persistent_bo(GL_ARRAY_BUFFER, N * m_data_segment_size, &data_ptr);
+
+  chunk.m_segments.resize(N);
+  for(unsigned int i = 0; i < N; ++i)
+    {
+      ring_segment *segment(FASTUIDRAWnew ring_segment());
+      painter_vao &vao(segment->m_vao);
+      uint8_t *ptr;
+
+      chunk.m_segments[i] = segment;
+
+      vao.m_attribute_bo = chunk.m_attribute_bo;
+      vao.m_header_bo = chunk.m_header_bo;
+      vao.m_index_bo = chunk.m_index_bo;
+      vao.m_data_bo = chunk.m_data_bo;
+      vao.m_data_store_backing = m_data_store_backing;
+      vao.m_attribute_offset = i * m_attribute_buffer_size;
+      vao.m_header_offset = i * m_header_buffer_size;
+      vao.m_index_offset = i * m_index_buffer_size;
+      vao.m_data_offset = i * m_data_segment_size;
+      vao.m_segment = segment;
+
+      ptr = static_cast<uint8_t*>(attr_ptr) + vao.m_attribute_offset;
+      segment->m_attributes = fastuidraw::c_array<fastuidraw::PainterAttribute>(reinterpret_cast<fastuidraw::PainterAttribute*>(ptr),
+                                                                                m_attribute_buffer_size / sizeof(fastuidraw::PainterAttribute));
+      ptr = static_cast<uint8_t*>(header_ptr) + vao.m_header_offset;
+      segment->m_header_attributes = fastuidraw::c_array<uint32_t>(reinterpret_cast<uint32_t*>(ptr),
+                                                                   m_header_buffer_size / sizeof(uint32_t));
+      ptr = static_cast<uint8_t*>(index_ptr) + vao.m_index_offset;
+      segment->m_indices = fastuidraw::c_array<fastuidraw::PainterIndex>(reinterpret_cast<fastuidraw::PainterIndex*>(ptr),
+                                                                         m_index_buffer_size / sizeof(fastuidraw::PainterIndex));
+      ptr = static_cast<uint8_t*>(data_ptr) + vao.m_data_offset;
+      segment->m_store = fastuidraw::c_array<fastuidraw::generic_data>(reinterpret_cast<fastuidraw::generic_data*>(ptr),
+                                                                       m_data_buffer_size / sizeof(fastuidraw::generic_data));
+
+      glGenVertexArrays(1, &vao.m_vao);
+      FASTUIDRAWassert(vao.m_vao != 0);
+      glBindVertexArray(vao.m_vao);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk.m_index_bo);
+      set_vao_attributes(chunk.m_attribute_bo, vao.m_attribute_offset,
+                         chunk.m_header_bo, vao.m_header_offset);
+      glBindVertexArray(0);
+
+      switch(m_data_store_backing)
+        {
+        case fastuidraw::gl::PainterBackendGL::data_store_tbo:
+          {
+            const GLenum uint_fmts[4] =
+              {
+                GL_R32UI,
+                GL_RG32UI,
+                GL_RGB32UI,
+                GL_RGBA32UI,
+              };
+
+            vao.m_data_store_binding_point = m_binding_points.data_store_buffer_tbo();
+            glGenTextures(1, &vao.m_data_tbo);
+            FASTUIDRAWassert(vao.m_data_tbo != 0);
+            glActiveTexture(GL_TEXTURE0 + vao.m_data_store_binding_point);
+            glBindTexture(GL_TEXTURE_BUFFER, vao.m_data_tbo);
+            #ifndef FASTUIDRAW_GL_USE_GLES
+              {
+                glTexBufferRange(GL_TEXTURE_BUFFER, uint_fmts[m_alignment - 1], chunk.m_data_bo,
+                                 vao.m_data_offset, m_data_buffer_size);
+              }
+            #else
+              {
+                FASTUIDRAWunused(uint_fmts);
+                FASTUIDRAWassert(!"Persistently mapped buffers not supported on GLES");
+              }
+            #endif
+          }
+          break;
+
+        case fastuidraw::gl::PainterBackendGL::data_store_ubo:
+          {
+            vao.m_data_store_binding_point = m_binding_points.data_store_buffer_ubo();
+          }
+          break;
+        }
+    }
+
+  /* the new segments are used next */
+  m_ring.insert(m_ring.begin() + m_ring_current,
+                chunk.m_segments.begin(), chunk.m_segments.end());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
 void
 painter_vao_pool::
 next_pool(void)
@@ -802,6 +1471,54 @@ next_pool(void)
     }
 
   m_current = 0;
+
+  m_last_frame_bytes_streamed = m_bytes_streamed;
+  m_last_frame_stall_ns = m_stall_ns;
+  m_last_frame_draw_calls = m_draw_calls;
+  m_last_frame_draw_calls_saved = m_draw_calls_saved;
+  m_bytes_streamed = 0;
+  m_stall_ns = 0;
+  m_draw_calls = 0;
+  m_draw_calls_saved = 0;
+}
+
+std::vector<fastuidraw::PainterIndex>*
+painter_vao_pool::
+acquire_index_scratch(void)
+{
+  std::vector<fastuidraw::PainterIndex> *return_value;
+
+  if (m_index_scratch.empty())
+    {
+      return_value = FASTUIDRAWnew std::vector<fastuidraw::PainterIndex>();
+      return_value->resize(m_index_buffer_size / sizeof(fastuidraw::PainterIndex));
+    }
+  else
+    {
+      return_value = m_index_scratch.back();
+      m_index_scratch.pop_back();
+    }
+  return return_value;
+}
+
+void
+painter_vao_pool::
+upload_indirect_commands(void)
+{
+  if (m_indirect_bo == 0)
+    {
+      glGenBuffers(1, &m_indirect_bo);
+      FASTUIDRAWassert(m_indirect_bo != 0);
+    }
+
+  /* glBufferData orphans the previous contents so that
+   * the upload does not wait on earlier indirect draws.
+   */
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirect_bo);
+  glBufferData(GL_DRAW_INDIRECT_BUFFER,
+               m_indirect_commands.size() * sizeof(DrawElementsIndirectCommand),
+               m_indirect_commands.empty() ? nullptr : &m_indirect_commands[0],
+               GL_STREAM_DRAW);
 }
 
 
@@ -853,41 +1570,102 @@ generate_bo(GLenum bind_target, GLsizei psize)
 DrawEntry::
 DrawEntry(const fastuidraw::BlendMode &mode,
           PainterBackendGLPrivate *pr,
-          unsigned int pz):
+          unsigned int pz,
+          uint32_t item_group):
   m_blend_mode(mode),
+  m_index_type(fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type),
+  m_base_index(0),
+  m_number_ranges(0),
   m_private(pr),
-  m_choice(pz)
+  m_choice(pz),
+  m_item_group(item_group)
 {}
 
 
 DrawEntry::
-DrawEntry(const fastuidraw::BlendMode &mode):
+DrawEntry(const fastuidraw::BlendMode &mode, uint32_t item_group):
   m_blend_mode(mode),
+  m_index_type(fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type),
+  m_base_index(0),
+  m_number_ranges(0),
   m_private(nullptr),
-  m_choice(fastuidraw::gl::PainterBackendGL::number_program_types)
+  m_choice(fastuidraw::gl::PainterBackendGL::number_program_types),
+  m_item_group(item_group)
 {}
 
 DrawEntry::
 DrawEntry(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw::Action> &action):
   m_action(action),
-  m_private(nullptr)
+  m_index_type(fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type),
+  m_base_index(0),
+  m_number_ranges(0),
+  m_private(nullptr),
+  m_choice(fastuidraw::gl::PainterBackendGL::number_program_types),
+  m_item_group(0u)
 {}
 
 void
 DrawEntry::
-add_entry(GLsizei count, const void *offset)
+add_entry(GLsizei count, GLsizei first, bool merge)
 {
-  m_counts.push_back(count);
-  m_indices.push_back(offset);
+  if (count == 0)
+    {
+      return;
+    }
+
+  ++m_number_ranges;
+  if (merge && !m_counts.empty()
+      && m_firsts.back() + m_counts.back() == first)
+    {
+      m_counts.back() += count;
+    }
+  else
+    {
+      m_counts.push_back(count);
+      m_firsts.push_back(first);
+    }
 }
 
 void
 DrawEntry::
-draw(void) const
+set_index_format(GLenum index_type, GLsizei base_index)
+{
+  unsigned int index_size;
+
+  index_size = (index_type == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+  m_index_type = index_type;
+  m_base_index = base_index;
+  m_indices.resize(m_firsts.size());
+  for(unsigned int i = 0, endi = m_firsts.size(); i < endi; ++i)
+    {
+      m_indices[i] = fastuidraw::gl::offset_as_void_pointer(index_size * (base_index + m_firsts[i]));
+    }
+}
+
+void
+DrawEntry::
+add_indirect_commands(std::vector<DrawElementsIndirectCommand> *dst) const
+{
+  for(unsigned int i = 0, endi = m_counts.size(); i < endi; ++i)
+    {
+      DrawElementsIndirectCommand cmd;
+
+      cmd.m_count = m_counts[i];
+      cmd.m_instance_count = 1;
+      cmd.m_first_index = m_base_index + m_firsts[i];
+      cmd.m_base_vertex = 0;
+      cmd.m_base_instance = 0;
+      dst->push_back(cmd);
+    }
+}
+
+unsigned int
+DrawEntry::
+draw(GLintptr *indirect_offset) const
 {
   if (m_private)
     {
-      m_private->m_programs[m_choice]->use_program();
+      m_private->select_program(m_choice, m_item_group)->use_program();
     }
 
   if (m_action)
@@ -911,10 +1689,27 @@ draw(void) const
 
   if (m_counts.empty())
     {
-      return;
+      return 0;
     }
   FASTUIDRAWassert(m_counts.size() == m_indices.size());
 
+  if (indirect_offset)
+    {
+      #ifndef FASTUIDRAW_GL_USE_GLES
+        {
+          glMultiDrawElementsIndirect(GL_TRIANGLES, m_index_type,
+                                      fastuidraw::gl::offset_as_void_pointer(*indirect_offset),
+                                      m_counts.size(), sizeof(DrawElementsIndirectCommand));
+        }
+      #else
+        {
+          FASTUIDRAWassert(!"glMultiDrawElementsIndirect not supported on GLES");
+        }
+      #endif
+      *indirect_offset += m_counts.size() * sizeof(DrawElementsIndirectCommand);
+      return 1;
+    }
+
   /* TODO:
    *  Get rid of this unholy mess of #ifdef's here and move
    *  it to an internal private function that also has a tag
@@ -922,26 +1717,25 @@ draw(void) const
    */
   #ifndef FASTUIDRAW_GL_USE_GLES
     {
-      glMultiDrawElements(GL_TRIANGLES, &m_counts[0],
-                          fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type,
+      glMultiDrawElements(GL_TRIANGLES, &m_counts[0], m_index_type,
                           &m_indices[0], m_counts.size());
+      return 1;
     }
   #else
     {
       if (FASTUIDRAWglfunctionExists(glMultiDrawElementsEXT))
         {
-          glMultiDrawElementsEXT(GL_TRIANGLES, &m_counts[0],
-                                 fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type,
+          glMultiDrawElementsEXT(GL_TRIANGLES, &m_counts[0], m_index_type,
                                  &m_indices[0], m_counts.size());
+          return 1;
         }
       else
         {
           for(unsigned int i = 0, endi = m_counts.size(); i < endi; ++i)
             {
-              glDrawElements(GL_TRIANGLES, m_counts[i],
-                             fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type,
-                             m_indices[i]);
+              glDrawElements(GL_TRIANGLES, m_counts[i], m_index_type, m_indices[i]);
             }
+          return m_counts.size();
         }
     }
   #endif
@@ -1016,15 +1810,49 @@ DrawCommand(painter_vao_pool *hnd,
             const fastuidraw::gl::PainterBackendGL::ConfigurationGL &params,
             PainterBackendGLPrivate *pr):
   m_pr(pr),
+  m_pool(hnd),
   m_vao(hnd->request_vao()),
+  m_index_scratch(nullptr),
+  m_mapped_indices(nullptr),
+  m_index_type(fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type),
   m_attributes_written(0),
   m_indices_written(0)
 {
+  if (m_vao.m_segment)
+    {
+      /* the segment is already mapped and the pool has
+       * waited on its fence, so no GL calls are needed.
+       */
+      m_attributes = m_vao.m_segment->m_attributes;
+      m_indices = m_vao.m_segment->m_indices;
+      m_store = m_vao.m_segment->m_store;
+      m_header_attributes = m_vao.m_segment->m_header_attributes;
+    }
+  else
+    {
+      map_buffers(params);
+    }
+
+  if (params.compact_indices())
+    {
+      m_mapped_indices = m_indices.c_ptr();
+      m_index_scratch = hnd->acquire_index_scratch();
+      m_indices = fastuidraw::make_c_array(*m_index_scratch);
+    }
+}
+
+void
+DrawCommand::
+map_buffers(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &params)
+{
+  painter_vao_pool *hnd(m_pool);
+
   /* map the buffers and set to the c_array<> fields of
    *  fastuidraw::PainterDraw to the mapping location.
    */
   void *attr_bo, *index_bo, *data_bo, *header_bo;
   uint32_t flags;
+  std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
 
   flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
 
@@ -1044,6 +1872,11 @@ DrawCommand(painter_vao_pool *hnd,
   data_bo = glMapBufferRange(GL_ARRAY_BUFFER, 0, hnd->data_buffer_size(), flags);
   FASTUIDRAWassert(data_bo != nullptr);
 
+  /* the time to map is the time the GL implementation
+   * needs to synchronize (or orphan) the buffers.
+   */
+  hnd->record_map_stall(start);
+
   m_attributes = fastuidraw::c_array<fastuidraw::PainterAttribute>(static_cast<fastuidraw::PainterAttribute*>(attr_bo),
                                                                  params.attributes_per_buffer());
   m_indices = fastuidraw::c_array<fastuidraw::PainterIndex>(static_cast<fastuidraw::PainterIndex*>(index_bo),
@@ -1089,7 +1922,32 @@ draw_break(const fastuidraw::PainterShaderGroup &old_shaders,
   old_disc = old_shaders.item_group() & shader_group_discard_mask;
   new_disc = new_shaders.item_group() & shader_group_discard_mask;
 
-  if (old_disc != new_disc)
+  if (m_pr->m_params.specialized_program_threshold() > 0u
+      && old_shaders.item_group() != new_shaders.item_group())
+    {
+      /* the item shader group identifies the item shader,
+       * the program is selected when the entry is drawn.
+       */
+      unsigned int pz;
+      if (!m_pr->m_params.separate_program_for_discard())
+        {
+          pz = fastuidraw::gl::PainterBackendGL::program_all;
+        }
+      else
+        {
+          pz = (new_disc != 0u) ?
+            fastuidraw::gl::PainterBackendGL::program_with_discard :
+            fastuidraw::gl::PainterBackendGL::program_without_discard;
+        }
+
+      if (!m_draws.empty())
+        {
+          add_entry(indices_written);
+        }
+      m_draws.push_back(DrawEntry(fastuidraw::BlendMode(new_mode), m_pr, pz,
+                                  new_shaders.item_group()));
+    }
+  else if (old_disc != new_disc)
     {
       unsigned int pz;
       pz = (new_disc != 0u) ?
@@ -1100,15 +1958,20 @@ draw_break(const fastuidraw::PainterShaderGroup &old_shaders,
         {
           add_entry(indices_written);
         }
-      m_draws.push_back(DrawEntry(fastuidraw::BlendMode(new_mode), m_pr, pz));
+      m_draws.push_back(DrawEntry(fastuidraw::BlendMode(new_mode), m_pr, pz,
+                                  new_shaders.item_group()));
     }
-  else if (old_mode != new_mode)
+  else if (old_mode != new_mode
+           || (m_pr->m_gpu_timer && old_shaders.item_group() != new_shaders.item_group()))
     {
+      /* with GPU timer queries, each range of draws of an item
+       * shader group is its own entry so that it can be timed.
+       */
       if (!m_draws.empty())
         {
           add_entry(indices_written);
         }
-      m_draws.push_back(fastuidraw::BlendMode(new_mode));
+      m_draws.push_back(DrawEntry(fastuidraw::BlendMode(new_mode), new_shaders.item_group()));
     }
   else
     {
@@ -1135,7 +1998,15 @@ draw(void) const
 
     case fastuidraw::gl::PainterBackendGL::data_store_ubo:
       {
-        glBindBufferBase(GL_UNIFORM_BUFFER, m_vao.m_data_store_binding_point, m_vao.m_data_bo);
+        if (m_vao.m_segment)
+          {
+            glBindBufferRange(GL_UNIFORM_BUFFER, m_vao.m_data_store_binding_point, m_vao.m_data_bo,
+                              m_vao.m_data_offset, m_pool->data_buffer_size());
+          }
+        else
+          {
+            glBindBufferBase(GL_UNIFORM_BUFFER, m_vao.m_data_store_binding_point, m_vao.m_data_bo);
+          }
       }
       break;
 
@@ -1148,22 +2019,119 @@ draw(void) const
       m_pr->m_programs[fastuidraw::gl::PainterBackendGL::program_without_discard]->use_program();
     }
 
-  for(const DrawEntry &entry : m_draws)
-    {
-      entry.draw();
-    }
-  glBindVertexArray(0);
-}
+  if (m_pr->m_params.multi_draw_indirect())
+    {
+      std::vector<DrawElementsIndirectCommand> &cmds(m_pool->indirect_commands());
+      GLintptr indirect_offset(0);
+      unsigned int calls(0), ranges(0);
+
+      cmds.clear();
+      for(const DrawEntry &entry : m_draws)
+        {
+          entry.add_indirect_commands(&cmds);
+        }
+      m_pool->upload_indirect_commands();
+
+      if (m_pr->m_gpu_timer)
+        {
+          m_pr->m_gpu_timer->begin_command();
+        }
+
+      for(const DrawEntry &entry : m_draws)
+        {
+          calls += entry.draw(&indirect_offset);
+          ranges += entry.number_ranges();
+          if (m_pr->m_gpu_timer)
+            {
+              m_pr->m_gpu_timer->end_range(entry.item_group() & ~shader_group_discard_mask);
+            }
+        }
+      glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+      m_pool->record_draw_calls(calls, ranges);
+    }
+  else
+    {
+      unsigned int calls(0), ranges(0);
+
+      if (m_pr->m_gpu_timer)
+        {
+          m_pr->m_gpu_timer->begin_command();
+        }
+
+      for(const DrawEntry &entry : m_draws)
+        {
+          calls += entry.draw(nullptr);
+          ranges += entry.number_ranges();
+          if (m_pr->m_gpu_timer)
+            {
+              m_pr->m_gpu_timer->end_range(entry.item_group() & ~shader_group_discard_mask);
+            }
+        }
+      m_pool->record_draw_calls(calls, ranges);
+    }
+  glBindVertexArray(0);
+
+  if (m_vao.m_segment)
+    {
+      m_pool->segment_drawn(m_vao.m_segment);
+    }
+}
+
+void
+DrawCommand::
+unmap_implement(unsigned int attributes_written,
+                unsigned int indices_written,
+                unsigned int data_store_written) const
+{
+  unsigned int index_bytes, index_size;
+
+  m_attributes_written = attributes_written;
+  add_entry(indices_written);
+  FASTUIDRAWassert(m_indices_written == indices_written);
+
+  if (m_index_scratch)
+    {
+      index_bytes = write_compact_indices(attributes_written, indices_written);
+    }
+  else
+    {
+      index_bytes = indices_written * sizeof(fastuidraw::PainterIndex);
+    }
+
+  index_size = (m_index_type == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+  FASTUIDRAWassert(m_vao.m_index_offset % index_size == 0);
+  for(DrawEntry &entry : m_draws)
+    {
+      entry.set_index_format(m_index_type, m_vao.m_index_offset / index_size);
+    }
+
+  m_pool->record_bytes_streamed(attributes_written * (sizeof(fastuidraw::PainterAttribute) + sizeof(uint32_t))
+                                + index_bytes
+                                + data_store_written * sizeof(fastuidraw::generic_data));
+
+  if (m_vao.m_segment)
+    {
+      /* the ring buffers stay mapped, only flush the
+       * written ranges of the segment.
+       */
+      glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_attribute_bo);
+      glFlushMappedBufferRange(GL_ARRAY_BUFFER, m_vao.m_attribute_offset,
+                               attributes_written * sizeof(fastuidraw::PainterAttribute));
+
+      glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_header_bo);
+      glFlushMappedBufferRange(GL_ARRAY_BUFFER, m_vao.m_header_offset,
+                               attributes_written * sizeof(uint32_t));
+
+      glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_index_bo);
+      glFlushMappedBufferRange(GL_ARRAY_BUFFER, m_vao.m_index_offset, index_bytes);
+
+      glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_data_bo);
+      glFlushMappedBufferRange(GL_ARRAY_BUFFER, m_vao.m_data_offset,
+                               data_store_written * sizeof(fastuidraw::generic_data));
 
-void
-DrawCommand::
-unmap_implement(unsigned int attributes_written,
-                unsigned int indices_written,
-                unsigned int data_store_written) const
-{
-  m_attributes_written = attributes_written;
-  add_entry(indices_written);
-  FASTUIDRAWassert(m_indices_written == indices_written);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+      return;
+    }
 
   glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_attribute_bo);
   glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, attributes_written * sizeof(fastuidraw::PainterAttribute));
@@ -1174,7 +2142,7 @@ unmap_implement(unsigned int attributes_written,
   glUnmapBuffer(GL_ARRAY_BUFFER);
 
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_vao.m_index_bo);
-  glFlushMappedBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, indices_written * sizeof(fastuidraw::PainterIndex));
+  glFlushMappedBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, index_bytes);
   glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
 
   glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_data_bo);
@@ -1187,7 +2155,6 @@ DrawCommand::
 add_entry(unsigned int indices_written) const
 {
   unsigned int count;
-  const fastuidraw::PainterIndex *offset(nullptr);
 
   if (m_draws.empty())
     {
@@ -1195,11 +2162,49 @@ add_entry(unsigned int indices_written) const
     }
   FASTUIDRAWassert(indices_written >= m_indices_written);
   count = indices_written - m_indices_written;
-  offset += m_indices_written;
-  m_draws.back().add_entry(count, offset);
+
+  /* the ranges of indices are written consecutively, so unless each
+   * range is to be a separate element of the multi-draw call (see
+   * ConfigurationGL::break_on_shader_change()) they can be merged.
+   */
+  m_draws.back().add_entry(count, m_indices_written, !m_pr->m_params.break_on_shader_change());
   m_indices_written = indices_written;
 }
 
+unsigned int
+DrawCommand::
+write_compact_indices(unsigned int attributes_written,
+                      unsigned int indices_written) const
+{
+  unsigned int return_value;
+  const fastuidraw::PainterIndex *src(&(*m_index_scratch)[0]);
+
+  FASTUIDRAWassert(m_mapped_indices);
+  if (attributes_written <= 1u + std::numeric_limits<GLushort>::max())
+    {
+      /* every index fits in 16-bits, halving the bytes
+       * of the index buffer written.
+       */
+      GLushort *dst(reinterpret_cast<GLushort*>(m_mapped_indices));
+      for(unsigned int i = 0; i < indices_written; ++i)
+        {
+          FASTUIDRAWassert(src[i] < attributes_written);
+          dst[i] = static_cast<GLushort>(src[i]);
+        }
+      m_index_type = GL_UNSIGNED_SHORT;
+      return_value = indices_written * sizeof(GLushort);
+    }
+  else
+    {
+      return_value = indices_written * sizeof(fastuidraw::PainterIndex);
+      std::memcpy(m_mapped_indices, src, return_value);
+    }
+
+  m_pool->release_index_scratch(m_index_scratch);
+  m_index_scratch = nullptr;
+  return return_value;
+}
+
 /////////////////////////////
 //SurfaceGLPrivate methods
 SurfaceGLPrivate::
@@ -1220,13 +2225,25 @@ SurfaceGLPrivate(GLuint texture,
 SurfaceGLPrivate::
 ~SurfaceGLPrivate()
 {
+  using namespace fastuidraw::gl::detail;
+
   if (!m_own_texture)
     {
       m_buffers[buffer_color] = 0;
     }
-  glDeleteTextures(m_auxiliary_buffer.size(), m_auxiliary_buffer.c_ptr());
-  glDeleteFramebuffers(m_fbo.size(), m_fbo.c_ptr());
-  glDeleteTextures(m_buffers.size(), m_buffers.c_ptr());
+
+  for(GLuint name : m_auxiliary_buffer)
+    {
+      m_release_target.release(texture_resource, name);
+    }
+  for(GLuint name : m_fbo)
+    {
+      m_release_target.release(framebuffer_resource, name);
+    }
+  for(GLuint name : m_buffers)
+    {
+      m_release_target.release(texture_resource, name);
+    }
 }
 
 fastuidraw::gl::PainterBackendGL::SurfaceGL*
@@ -1250,6 +2267,7 @@ auxiliary_buffer(enum auxiliary_buffer_t tp)
       fastuidraw::gl::detail::ClearImageSubData clearer;
 
       internalFormat = auxiliaryBufferInternalFmt(tp);
+      m_release_target.capture();
       glGenTextures(1, &m_auxiliary_buffer[tp]);
       FASTUIDRAWassert(m_auxiliary_buffer[tp] != 0u);
 
@@ -1292,6 +2310,7 @@ buffer(enum buffer_t tp)
         GL_DEPTH24_STENCIL8;
 
       glGetIntegerv(tex_target_binding, &old_tex);
+      m_release_target.capture();
       glGenTextures(1, &m_buffers[tp]);
       FASTUIDRAWassert(m_buffers[tp] != 0);
       glBindTexture(tex_target, m_buffers[tp]);
@@ -1330,6 +2349,7 @@ fbo(enum fbo_t tp)
         GL_TEXTURE_2D :
         GL_TEXTURE_2D_MULTISAMPLE;
 
+      m_release_target.capture();
       glGenFramebuffers(1, &m_fbo[tp]);
       FASTUIDRAWassert(m_fbo[tp] != 0);
 
@@ -1363,9 +2383,18 @@ PainterBackendGLPrivate(const fastuidraw::gl::PainterBackendGL::ConfigurationGL
   m_number_clip_planes(0),
   m_clip_plane0(GL_INVALID_ENUM),
   m_linear_filter_sampler(0),
+  m_have_pending_programs(false),
+  m_number_specialized_programs(0),
+  m_last_frame_resources_released(0),
+  m_gpu_timer(nullptr),
   m_pool(nullptr),
   m_p(p)
 {
+  if (m_params.deferred_resource_release())
+    {
+      m_release_queue = FASTUIDRAWnew fastuidraw::gl::detail::DeferredReleaseQueue();
+    }
+  fastuidraw::gl::detail::DeferredReleaseQueue::make_current(m_release_queue);
   configure_backend();
 }
 
@@ -1381,6 +2410,23 @@ PainterBackendGLPrivate::
     {
       FASTUIDRAWdelete(m_pool);
     }
+
+  if (m_gpu_timer)
+    {
+      FASTUIDRAWdelete(m_gpu_timer);
+    }
+
+  /* the queued deletions are executed now; GL objects
+   * released to the queue afterwards are deleted immediately.
+   */
+  if (m_release_queue)
+    {
+      if (fastuidraw::gl::detail::DeferredReleaseQueue::current() == m_release_queue)
+        {
+          fastuidraw::gl::detail::DeferredReleaseQueue::make_current(nullptr);
+        }
+      m_release_queue->close();
+    }
 }
 
 fastuidraw::PainterBackend::ConfigurationBase
@@ -1512,6 +2558,23 @@ configure_backend(void)
       }
     }
 
+  if (m_params.async_program_rebuild())
+    {
+      /* let the GL implementation use as many threads
+       * as it likes for compiling and linking.
+       */
+      if (m_ctx_properties.has_extension("GL_KHR_parallel_shader_compile"))
+        {
+          glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        }
+      #ifndef FASTUIDRAW_GL_USE_GLES
+      else if (m_ctx_properties.has_extension("GL_ARB_parallel_shader_compile"))
+        {
+          glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+        }
+      #endif
+    }
+
   if (!m_params.use_hw_clip_planes())
     {
       m_number_clip_planes = 0;
@@ -1629,6 +2692,59 @@ configure_backend(void)
     .colorstop_atlas_backing(colorstop_tp)
     .provide_auxiliary_image_buffer(m_params.provide_auxiliary_image_buffer());
 
+  /* persistently mapped buffers require GL_ARB_buffer_storage
+   * and, to bind a range of a buffer as the data store TBO,
+   * GL_ARB_texture_buffer_range.
+   */
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      m_params.persistent_mapped_buffers(false);
+      m_params.multi_draw_indirect(false);
+    }
+  #else
+    {
+      if (m_params.persistent_mapped_buffers())
+        {
+          bool have_storage, have_range;
+
+          have_storage = m_ctx_properties.version() >= fastuidraw::ivec2(4, 4)
+            || m_ctx_properties.has_extension("GL_ARB_buffer_storage");
+          have_range = m_params.data_store_backing() != fastuidraw::gl::PainterBackendGL::data_store_tbo
+            || m_ctx_properties.version() >= fastuidraw::ivec2(4, 3)
+            || m_ctx_properties.has_extension("GL_ARB_texture_buffer_range");
+          m_params.persistent_mapped_buffers(have_storage && have_range);
+        }
+
+      m_params.multi_draw_indirect(m_params.multi_draw_indirect()
+                                   && (m_ctx_properties.version() >= fastuidraw::ivec2(4, 3)
+                                       || m_ctx_properties.has_extension("GL_ARB_multi_draw_indirect")));
+    }
+  #endif
+
+  /* timestamp queries require GL 3.3 or GL_ARB_timer_query,
+   * on GLES they require GL_EXT_disjoint_timer_query.
+   */
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      m_params.gpu_timer_queries(m_params.gpu_timer_queries()
+                                 && m_ctx_properties.has_extension("GL_EXT_disjoint_timer_query"));
+    }
+  #else
+    {
+      m_params.gpu_timer_queries(m_params.gpu_timer_queries()
+                                 && (m_ctx_properties.version() >= fastuidraw::ivec2(3, 3)
+                                     || m_ctx_properties.has_extension("GL_ARB_timer_query")));
+    }
+  #endif
+
+  if (m_params.gpu_timer_queries())
+    {
+      /* allow the results to be a few frames behind the
+       * frames in flight before dropping frames.
+       */
+      m_gpu_timer = FASTUIDRAWnew fastuidraw::gl::detail::GPUTimer(m_params.number_pools() + 2);
+    }
+
   /* now allocate m_pool after adjusting m_params */
   m_pool = FASTUIDRAWnew painter_vao_pool(m_params, m_p->configuration_base(),
                                           m_tex_buffer_support,
@@ -1848,33 +2964,123 @@ programs(bool rebuild)
     {
       build_programs();
     }
+  finish_pending_programs(false);
   return m_programs;
 }
 
+void
+PainterBackendGLPrivate::
+finish_pending_programs(bool wait)
+{
+  if (!m_have_pending_programs)
+    {
+      return;
+    }
+
+  for(unsigned int i = 0; i < fastuidraw::gl::PainterBackendGL::number_program_types; ++i)
+    {
+      if (!wait && !m_pending_programs[i]->link_completed())
+        {
+          return;
+        }
+    }
+
+  for(unsigned int i = 0; i < fastuidraw::gl::PainterBackendGL::number_program_types; ++i)
+    {
+      FASTUIDRAWassert(m_pending_programs[i]->link_success());
+      m_programs[i] = m_pending_programs[i];
+      m_pending_programs[i] = nullptr;
+    }
+  m_have_pending_programs = false;
+}
+
 void
 PainterBackendGLPrivate::
 build_programs(void)
 {
+  /* the programs are built asynchronously only when
+   * there are previous programs to draw with while
+   * the new ones are built.
+   */
+  bool async(m_params.async_program_rebuild() && m_programs[0]);
+
   for(unsigned int i = 0; i < fastuidraw::gl::PainterBackendGL::number_program_types; ++i)
     {
       enum fastuidraw::gl::PainterBackendGL::program_type_t tp;
       tp = static_cast<enum fastuidraw::gl::PainterBackendGL::program_type_t>(i);
-      m_programs[tp] = build_program(tp);
-      FASTUIDRAWassert(m_programs[tp]->link_success());
+      DiscardItemShaderFilter item_filter(tp, m_params.use_hw_clip_planes());
+
+      if (async)
+        {
+          m_pending_programs[tp] = build_program(tp, &item_filter);
+          m_pending_programs[tp]->issue_link();
+        }
+      else
+        {
+          m_programs[tp] = build_program(tp, &item_filter);
+          FASTUIDRAWassert(m_programs[tp]->link_success());
+        }
     }
+  m_have_pending_programs = async;
+
+  /* the specialized programs include all the blend shaders,
+   * so they need to be rebuilt when shaders are added.
+   */
+  m_specialized_programs.clear();
+  m_number_specialized_programs = 0;
 
   m_uniform_values.resize(m_p->ubo_size());
   m_uniform_values_ptr = fastuidraw::c_array<fastuidraw::generic_data>(&m_uniform_values[0],
                                                                        m_uniform_values.size());
 }
 
+fastuidraw::gl::Program*
+PainterBackendGLPrivate::
+select_program(unsigned int choice, uint32_t item_group)
+{
+  unsigned int threshold(m_params.specialized_program_threshold());
+
+  if (threshold == 0u)
+    {
+      return m_programs[choice].get();
+    }
+
+  /* Heuristic: only those item shaders drawn often enough get a
+   * specialized program and the number of specialized programs
+   * is bounded; all other draws use the uber-shader program.
+   */
+  SpecializedProgram &sp(m_specialized_programs[item_group]);
+  ++sp.m_use_count;
+  if (!sp.m_program
+      && sp.m_use_count >= threshold
+      && m_number_specialized_programs < m_params.max_specialized_programs())
+    {
+      enum fastuidraw::gl::PainterBackendGL::program_type_t tp;
+      SpecializedItemShaderFilter item_filter(item_group & ~shader_group_discard_mask);
+
+      tp = static_cast<enum fastuidraw::gl::PainterBackendGL::program_type_t>(choice);
+      sp.m_program = build_program(tp, &item_filter);
+      sp.m_program->issue_link();
+      ++m_number_specialized_programs;
+    }
+
+  /* keep using the uber-shader until the specialized
+   * program is linked.
+   */
+  if (sp.m_program && sp.m_program->link_completed())
+    {
+      return sp.m_program.get();
+    }
+  return m_programs[choice].get();
+}
+
 PainterBackendGLPrivate::program_ref
 PainterBackendGLPrivate::
-build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp)
+build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp,
+              const fastuidraw::glsl::PainterBackendGLSL::ItemShaderFilter *item_filter)
 {
   fastuidraw::glsl::ShaderSource vert, frag;
   program_ref return_value;
-  DiscardItemShaderFilter item_filter(tp, m_params.use_hw_clip_planes());
   fastuidraw::c_string discard_macro;
 
   if (tp == fastuidraw::gl::PainterBackendGL::program_without_discard)
@@ -1897,10 +3103,20 @@ build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp)
     .specify_extensions(m_front_matter_frag)
     .add_source(m_front_matter_frag);
 
-  m_p->construct_shader(vert, frag, m_uber_shader_builder_params, &item_filter, discard_macro);
+  m_p->construct_shader(vert, frag, m_uber_shader_builder_params, item_filter, discard_macro);
   return_value = FASTUIDRAWnew fastuidraw::gl::Program(vert, frag,
                                                        m_attribute_binder,
                                                        m_initializer);
+
+  /* the only pre-link actions are the attribute bindings
+   * which are determined by assign_layout_to_vertex_shader_inputs();
+   * everything else of the configuration is within the
+   * shader source code.
+   */
+  return_value->program_binary_cache(m_params.program_binary_cache(),
+                                     m_uber_shader_builder_params.assign_layout_to_vertex_shader_inputs() ?
+                                     "PainterBackendGL:layout_attributes" :
+                                     "PainterBackendGL:bind_attributes");
   return return_value;
 }
 
@@ -2086,6 +3302,28 @@ setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, Configuratio
                  enum fastuidraw::PainterBlendShader::shader_type, blend_type)
 setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
                  enum fastuidraw::glsl::PainterBackendGLSL::auxiliary_buffer_t, provide_auxiliary_image_buffer)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 const fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache>&, program_binary_cache)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 bool, async_program_rebuild)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 unsigned int, specialized_program_threshold)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 unsigned int, max_specialized_programs)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 bool, persistent_mapped_buffers)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 unsigned int, persistent_buffer_segments)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 bool, multi_draw_indirect)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 bool, deferred_resource_release)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 unsigned int, resource_release_budget)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 bool, gpu_timer_queries)
+setget_implement(fastuidraw::gl::PainterBackendGL::ConfigurationGL, ConfigurationGLPrivate,
+                 bool, compact_indices)
 
 ///////////////////////////////////////////////
 // fastuidraw::gl::PainterBackendGL methods
@@ -2119,6 +3357,157 @@ program(enum program_type_t tp)
   return d->programs(shader_code_added())[tp];
 }
 
+unsigned int
+fastuidraw::gl::PainterBackendGL::
+number_specialized_programs(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return d->m_number_specialized_programs;
+}
+
+uint64_t
+fastuidraw::gl::PainterBackendGL::
+last_frame_bytes_streamed(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return d->m_pool->last_frame_bytes_streamed();
+}
+
+uint64_t
+fastuidraw::gl::PainterBackendGL::
+last_frame_stream_stall_ns(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return d->m_pool->last_frame_stall_ns();
+}
+
+uint64_t
+fastuidraw::gl::PainterBackendGL::
+last_frame_draw_calls(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return d->m_pool->last_frame_draw_calls();
+}
+
+uint64_t
+fastuidraw::gl::PainterBackendGL::
+last_frame_draw_calls_saved(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return d->m_pool->last_frame_draw_calls_saved();
+}
+
+unsigned int
+fastuidraw::gl::PainterBackendGL::
+last_frame_resources_released(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return d->m_last_frame_resources_released;
+}
+
+unsigned int
+fastuidraw::gl::PainterBackendGL::
+number_pending_resource_releases(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return (d->m_release_queue) ?
+    d->m_release_queue->number_pending() :
+    0u;
+}
+
+unsigned int
+fastuidraw::gl::PainterBackendGL::
+number_gpu_timed_frames(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return (d->m_gpu_timer) ?
+    d->m_gpu_timer->number_timed_frames() :
+    0u;
+}
+
+unsigned int
+fastuidraw::gl::PainterBackendGL::
+number_gpu_dropped_frames(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return (d->m_gpu_timer) ?
+    d->m_gpu_timer->number_dropped_frames() :
+    0u;
+}
+
+uint64_t
+fastuidraw::gl::PainterBackendGL::
+last_gpu_timed_frame_time_ns(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return (d->m_gpu_timer) ?
+    d->m_gpu_timer->last_frame_time_ns() :
+    0u;
+}
+
+fastuidraw::c_array<const uint64_t>
+fastuidraw::gl::PainterBackendGL::
+last_gpu_timed_frame_draw_times_ns(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return (d->m_gpu_timer) ?
+    d->m_gpu_timer->last_frame_command_times_ns() :
+    c_array<const uint64_t>();
+}
+
+fastuidraw::c_array<const uint32_t>
+fastuidraw::gl::PainterBackendGL::
+last_gpu_timed_frame_shader_groups(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return (d->m_gpu_timer) ?
+    d->m_gpu_timer->last_frame_groups() :
+    c_array<const uint32_t>();
+}
+
+fastuidraw::c_array<const uint64_t>
+fastuidraw::gl::PainterBackendGL::
+last_gpu_timed_frame_shader_group_times_ns(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return (d->m_gpu_timer) ?
+    d->m_gpu_timer->last_frame_group_times_ns() :
+    c_array<const uint64_t>();
+}
+
+void
+fastuidraw::gl::PainterBackendGL::
+warm_up(void)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  d->programs(shader_code_added());
+  d->finish_pending_programs(true);
+
+  /* make sure that the programs are completely
+   * assembled; link_success() waits on GL.
+   */
+  for(unsigned int i = 0; i < number_program_types; ++i)
+    {
+      FASTUIDRAWassert(d->m_programs[i]);
+      d->m_programs[i]->link_success();
+    }
+}
+
 const fastuidraw::gl::PainterBackendGL::ConfigurationGL&
 fastuidraw::gl::PainterBackendGL::
 configuration_gl(void) const
@@ -2136,8 +3525,26 @@ compute_item_shader_group(PainterShader::Tag tag,
   bool b;
   uint32_t return_value;
 
-  b = configuration_gl().break_on_shader_change();
-  return_value = (b) ? tag.m_ID : 0u;
+  /* GPU timer queries attribute time to item shader groups,
+   * thus they need a group for each item shader.
+   */
+  b = configuration_gl().break_on_shader_change()
+    || configuration_gl().gpu_timer_queries();
+  if (configuration_gl().specialized_program_threshold() > 0u)
+    {
+      /* the group identifies the item shader whose
+       * specialized program draws the item; sub-shaders
+       * are part of the program of their parent.
+       */
+      return_value = (shader->parent()) ?
+        shader->parent()->tag().m_ID :
+        tag.m_ID;
+      return_value &= ~shader_group_discard_mask;
+    }
+  else
+    {
+      return_value = (b) ? tag.m_ID : 0u;
+    }
   return_value |= (shader_group_discard_mask & tag.m_group);
 
   if (configuration_gl().separate_program_for_discard())
@@ -2199,6 +3606,11 @@ on_pre_draw(const reference_counted_ptr<Surface> &surface,
    *       PainterPacker::end() and the on_pre_draw() call is immediately
    *       followed by PainterDraw::draw() calls.
    */
+
+  /* GL objects made from here on are in the share group of
+   * our GL context, so their deletions go to our queue.
+   */
+  detail::DeferredReleaseQueue::make_current(d->m_release_queue);
   if (d->m_linear_filter_sampler == 0)
     {
       glGenSamplers(1, &d->m_linear_filter_sampler);
@@ -2442,6 +3854,17 @@ on_post_draw(void)
   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
   glDisable(GL_SCISSOR_TEST);
   d->m_pool->next_pool();
+
+  if (d->m_gpu_timer)
+    {
+      d->m_gpu_timer->end_frame();
+    }
+
+  if (d->m_release_queue)
+    {
+      d->m_last_frame_resources_released =
+        d->m_release_queue->execute(d->m_params.resource_release_budget());
+    }
 }
 
 fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw>
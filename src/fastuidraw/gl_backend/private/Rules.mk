@@ -4,7 +4,8 @@ dirstack_$(sp)	:= $(d)
 d		:= $(dir)
 # End standard header
 
-FASTUIDRAW_PRIVATE_GL_SOURCES += $(call filelist, tex_buffer.cpp texture_gl.cpp texture_view.cpp)
+FASTUIDRAW_PRIVATE_GL_SOURCES += $(call filelist, tex_buffer.cpp texture_gl.cpp texture_view.cpp \
+	deferred_release.cpp gpu_timer.cpp)
 
 
 # Begin standard footer
@@ -19,8 +19,12 @@
 
 #pragma once
 
+#include <list>
+#include <vector>
+#include <chrono>
 #include <fastuidraw/gl_backend/ngl_header.hpp>
 #include <fastuidraw/gl_backend/gl_get.hpp>
+#include "deferred_release.hpp"
 
 namespace fastuidraw { namespace gl { namespace detail {
 
@@ -48,7 +52,11 @@ public:
     m_size(psize),
     m_buffer_size(psize),
     m_delayed(delayed),
-    m_buffer(0)
+    m_buffer(0),
+    m_bytes_uploaded(0),
+    m_upload_time_ns(0),
+    m_number_reallocations(0),
+    m_bytes_copied_on_reallocation(0)
   {
     FASTUIDRAWassert(m_size > 0);
     if (!m_delayed)
@@ -69,8 +77,7 @@ public:
   delete_buffer(void)
   {
     FASTUIDRAWassert(m_buffer != 0);
-    glBindBuffer(binding_point, 0);
-    glDeleteBuffers(1, &m_buffer);
+    m_release_target.release(buffer_resource, m_buffer);
     m_buffer = 0;
   }
 
@@ -87,9 +94,12 @@ public:
       }
     else
       {
+        std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+
         flush_size_change();
         glBindBuffer(binding_point, m_buffer);
         glBufferSubData(binding_point, offset, data.size(), &data[0]);
+        record_upload(start, data.size());
       }
   }
 
@@ -120,13 +130,37 @@ public:
 
     if (!m_unflushed_commands.empty())
       {
+        std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+        uint64_t bytes(0);
+        int run_location(0);
+
+        /* consecutive commands that write adjacent ranges (the
+         * common case of data appended in order) are merged into
+         * a single glBufferSubData() call; the order of the
+         * commands is preserved so that later writes still win.
+         */
         glBindBuffer(binding_point, m_buffer);
+        m_scratch.clear();
         for(BufferGLEntryLocation &B : m_unflushed_commands)
           {
             FASTUIDRAWassert(!B.m_data.empty());
-            glBufferSubData(binding_point, B.m_location, B.m_data.size(), &B.m_data[0]);
+            if (!m_scratch.empty()
+                && run_location + static_cast<int>(m_scratch.size()) != B.m_location)
+              {
+                glBufferSubData(binding_point, run_location, m_scratch.size(), &m_scratch[0]);
+                m_scratch.clear();
+              }
+
+            if (m_scratch.empty())
+              {
+                run_location = B.m_location;
+              }
+            m_scratch.insert(m_scratch.end(), B.m_data.begin(), B.m_data.end());
+            bytes += B.m_data.size();
           }
+        glBufferSubData(binding_point, run_location, m_scratch.size(), &m_scratch[0]);
         m_unflushed_commands.clear();
+        record_upload(start, bytes);
       }
   }
 
@@ -149,8 +183,48 @@ public:
     m_size = new_size;
   }
 
+  /* number of bytes of data sent to GL */
+  uint64_t
+  bytes_uploaded(void) const
+  {
+    return m_bytes_uploaded;
+  }
+
+  /* time spent issuing the uploads of data */
+  uint64_t
+  upload_time_ns(void) const
+  {
+    return m_upload_time_ns;
+  }
+
+  /* number of times the GL buffer was re-created
+   * (and its contents copied) because of a resize
+   */
+  unsigned int
+  number_reallocations(void) const
+  {
+    return m_number_reallocations;
+  }
+
+  /* number of bytes copied on the GPU from old
+   * buffers to their replacements on re-creation
+   */
+  uint64_t
+  bytes_copied_on_reallocation(void) const
+  {
+    return m_bytes_copied_on_reallocation;
+  }
+
 private:
 
+  void
+  record_upload(std::chrono::steady_clock::time_point start, uint64_t bytes)
+  {
+    std::chrono::steady_clock::duration d(std::chrono::steady_clock::now() - start);
+    m_upload_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    m_bytes_uploaded += bytes;
+  }
+
   void
   flush_size_change(void)
   {
@@ -184,6 +258,9 @@ private:
 
             glBindBuffer(src_binding_point, prev_buffer);
             glDeleteBuffers(1, &old_buffer);
+
+            ++m_number_reallocations;
+            m_bytes_copied_on_reallocation += std::min(m_buffer_size, m_size);
           }
 
         m_buffer_size = m_size;
@@ -194,6 +271,7 @@ private:
   create_buffer(void)
   {
     FASTUIDRAWassert(m_buffer == 0);
+    m_release_target.capture();
     glGenBuffers(1, &m_buffer);
     FASTUIDRAWassert(m_buffer != 0);
     glBindBuffer(binding_point, m_buffer);
@@ -204,7 +282,12 @@ private:
   GLsizei m_buffer_size;
   bool m_delayed;
   mutable GLuint m_buffer;
+  DeferredReleaseTarget m_release_target;
   std::list<BufferGLEntryLocation> m_unflushed_commands;
+  std::vector<uint8_t> m_scratch;
+  uint64_t m_bytes_uploaded, m_upload_time_ns;
+  unsigned int m_number_reallocations;
+  uint64_t m_bytes_copied_on_reallocation;
 };
 
 } //namespace detail
@@ -0,0 +1,228 @@
+/*!
+ * \file deferred_release.cpp
+ * \brief file deferred_release.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <fastuidraw/util/math.hpp>
+#include "deferred_release.hpp"
+
+namespace
+{
+  thread_local fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::DeferredReleaseQueue> current_queue;
+}
+
+//////////////////////////////////
+// fastuidraw::gl::detail::DeferredReleaseQueue methods
+void
+fastuidraw::gl::detail::DeferredReleaseQueue::
+delete_names(enum gl_resource_t tp, const GLuint *names, unsigned int cnt)
+{
+  switch(tp)
+    {
+    case buffer_resource:
+      glDeleteBuffers(cnt, names);
+      break;
+
+    case texture_resource:
+      glDeleteTextures(cnt, names);
+      break;
+
+    case framebuffer_resource:
+      glDeleteFramebuffers(cnt, names);
+      break;
+
+    case vertex_array_resource:
+      glDeleteVertexArrays(cnt, names);
+      break;
+
+    case sampler_resource:
+      glDeleteSamplers(cnt, names);
+      break;
+
+    case shader_resource:
+      for(unsigned int i = 0; i < cnt; ++i)
+        {
+          glDeleteShader(names[i]);
+        }
+      break;
+
+    case program_resource:
+      for(unsigned int i = 0; i < cnt; ++i)
+        {
+          glDeleteProgram(names[i]);
+        }
+      break;
+
+    default:
+      FASTUIDRAWassert(!"Bad gl_resource_t value");
+    }
+}
+
+void
+fastuidraw::gl::detail::DeferredReleaseQueue::
+release(enum gl_resource_t tp, GLuint name)
+{
+  if (name == 0)
+    {
+      return;
+    }
+
+  {
+    std::lock_guard<std::mutex> M(m_mutex);
+    if (!m_closed)
+      {
+        m_names[tp].push_back(name);
+        return;
+      }
+  }
+
+  delete_names(tp, &name, 1);
+}
+
+void
+fastuidraw::gl::detail::DeferredReleaseQueue::
+release(GLsync sync)
+{
+  if (sync == nullptr)
+    {
+      return;
+    }
+
+  {
+    std::lock_guard<std::mutex> M(m_mutex);
+    if (!m_closed)
+      {
+        m_syncs.push_back(sync);
+        return;
+      }
+  }
+
+  glDeleteSync(sync);
+}
+
+unsigned int
+fastuidraw::gl::detail::DeferredReleaseQueue::
+execute(unsigned int budget)
+{
+  std::lock_guard<std::mutex> M(m_mutex);
+  return execute_implement(budget);
+}
+
+void
+fastuidraw::gl::detail::DeferredReleaseQueue::
+close(void)
+{
+  std::lock_guard<std::mutex> M(m_mutex);
+  execute_implement(0);
+  m_closed = true;
+}
+
+unsigned int
+fastuidraw::gl::detail::DeferredReleaseQueue::
+execute_implement(unsigned int budget)
+{
+  unsigned int return_value(0);
+
+  /* each kind of object is deleted with a single
+   * GL call (where GL provides one) from the back
+   * of its queue.
+   */
+  for(unsigned int tp = 0; tp < m_names.size(); ++tp)
+    {
+      std::vector<GLuint> &names(m_names[tp]);
+      unsigned int cnt(names.size());
+
+      if (budget != 0)
+        {
+          cnt = t_min(cnt, budget - return_value);
+        }
+
+      if (cnt > 0)
+        {
+          delete_names(static_cast<enum gl_resource_t>(tp),
+                       &names[names.size() - cnt], cnt);
+          names.resize(names.size() - cnt);
+          return_value += cnt;
+        }
+    }
+
+  while (!m_syncs.empty() && (budget == 0 || return_value < budget))
+    {
+      glDeleteSync(m_syncs.back());
+      m_syncs.pop_back();
+      ++return_value;
+    }
+
+  return return_value;
+}
+
+unsigned int
+fastuidraw::gl::detail::DeferredReleaseQueue::
+number_pending(void)
+{
+  std::lock_guard<std::mutex> M(m_mutex);
+  unsigned int return_value(m_syncs.size());
+
+  for(const auto &v : m_names)
+    {
+      return_value += v.size();
+    }
+  return return_value;
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::DeferredReleaseQueue>
+fastuidraw::gl::detail::DeferredReleaseQueue::
+current(void)
+{
+  return current_queue;
+}
+
+void
+fastuidraw::gl::detail::DeferredReleaseQueue::
+make_current(const reference_counted_ptr<DeferredReleaseQueue> &q)
+{
+  current_queue = q;
+}
+
+//////////////////////////////////
+// fastuidraw::gl::detail::DeferredReleaseTarget methods
+void
+fastuidraw::gl::detail::DeferredReleaseTarget::
+release(enum gl_resource_t tp, GLuint name) const
+{
+  if (m_queue)
+    {
+      m_queue->release(tp, name);
+    }
+  else if (name != 0)
+    {
+      DeferredReleaseQueue::delete_names(tp, &name, 1);
+    }
+}
+
+void
+fastuidraw::gl::detail::DeferredReleaseTarget::
+release(GLsync sync) const
+{
+  if (m_queue)
+    {
+      m_queue->release(sync);
+    }
+  else if (sync != nullptr)
+    {
+      glDeleteSync(sync);
+    }
+}
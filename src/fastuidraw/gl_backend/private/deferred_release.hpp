@@ -0,0 +1,163 @@
+/*!
+ * \file deferred_release.hpp
+ * \brief file deferred_release.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/gl_backend/ngl_header.hpp>
+
+namespace fastuidraw { namespace gl { namespace detail {
+
+/* The dtors of a number of gl_backend objects need to delete
+ * GL objects, but because those objects are reference counted
+ * their dtors can run when no GL context is current (or from
+ * a different thread). A DeferredReleaseQueue is owned by a
+ * PainterBackendGL created with deferred release enabled:
+ * deleting a GL object made while that PainterBackendGL was
+ * current (see make_current()) only queues the name, and the
+ * queue is drained by the PainterBackendGL from within its own
+ * GL context (PainterBackendGL::on_post_draw()). GL objects
+ * made while no queue was current are deleted immediately.
+ * The queue is thread safe.
+ */
+enum gl_resource_t
+  {
+    buffer_resource,
+    texture_resource,
+    framebuffer_resource,
+    vertex_array_resource,
+    sampler_resource,
+    shader_resource,
+    program_resource,
+
+    number_gl_resource_types
+  };
+
+class DeferredReleaseQueue:
+  public reference_counted<DeferredReleaseQueue>::default_base
+{
+public:
+  DeferredReleaseQueue(void):
+    m_closed(false)
+  {}
+
+  /* Queue the deletion of a GL object; if the queue is
+   * closed, the object is deleted immediately.
+   */
+  void
+  release(enum gl_resource_t tp, GLuint name);
+
+  /* Queue the deletion of a GL sync object; if the queue
+   * is closed, the object is deleted immediately.
+   */
+  void
+  release(GLsync sync);
+
+  /* Delete queued GL objects, must be called with the GL
+   * context of the owning PainterBackendGL current.
+   * \param budget maximum number of GL objects to delete, a
+   *               value of 0 indicates no limit
+   * \returns the number of GL objects deleted
+   */
+  unsigned int
+  execute(unsigned int budget);
+
+  /* Delete all queued GL objects and stop queueing, called
+   * by the owning PainterBackendGL at its destruction with
+   * its GL context current. Afterwards, release() deletes
+   * immediately.
+   */
+  void
+  close(void);
+
+  /* Returns the number of GL objects whose deletion is queued */
+  unsigned int
+  number_pending(void);
+
+  /* Returns the queue current to the calling thread */
+  static
+  reference_counted_ptr<DeferredReleaseQueue>
+  current(void);
+
+  /* Set the queue current to the calling thread, called by a
+   * PainterBackendGL when its GL context is current; q is
+   * nullptr if the PainterBackendGL does not defer releases.
+   */
+  static
+  void
+  make_current(const reference_counted_ptr<DeferredReleaseQueue> &q);
+
+  static
+  void
+  delete_names(enum gl_resource_t tp, const GLuint *names, unsigned int cnt);
+
+private:
+  unsigned int
+  execute_implement(unsigned int budget);
+
+  std::mutex m_mutex;
+  bool m_closed;
+  vecN<std::vector<GLuint>, number_gl_resource_types> m_names;
+  std::vector<GLsync> m_syncs;
+};
+
+/* Records the DeferredReleaseQueue current when an object
+ * makes its GL names, so that they are released to the
+ * queue of the PainterBackendGL (and thus of the GL share
+ * group) that made them.
+ */
+class DeferredReleaseTarget
+{
+public:
+  DeferredReleaseTarget(void):
+    m_captured(false)
+  {}
+
+  /* Call when making GL names; only the first call has
+   * an effect.
+   */
+  void
+  capture(void)
+  {
+    if (!m_captured)
+      {
+        m_queue = DeferredReleaseQueue::current();
+        m_captured = true;
+      }
+  }
+
+  /* Delete (or queue the deletion of) a GL object */
+  void
+  release(enum gl_resource_t tp, GLuint name) const;
+
+  /* Delete (or queue the deletion of) a GL sync object */
+  void
+  release(GLsync sync) const;
+
+private:
+  bool m_captured;
+  reference_counted_ptr<DeferredReleaseQueue> m_queue;
+};
+
+} //namespace detail
+} //namespace gl
+} //namespace fastuidraw
@@ -0,0 +1,261 @@
+/*!
+ * \file gpu_timer.cpp
+ * \brief file gpu_timer.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <map>
+#include <fastuidraw/gl_backend/gl_get.hpp>
+#include "gpu_timer.hpp"
+
+namespace
+{
+  void
+  query_timestamp(GLuint q)
+  {
+    #ifdef FASTUIDRAW_GL_USE_GLES
+      {
+        glQueryCounterEXT(q, GL_TIMESTAMP_EXT);
+      }
+    #else
+      {
+        glQueryCounter(q, GL_TIMESTAMP);
+      }
+    #endif
+  }
+
+  uint64_t
+  query_result(GLuint q)
+  {
+    GLuint64 return_value(0);
+    #ifdef FASTUIDRAW_GL_USE_GLES
+      {
+        glGetQueryObjectui64vEXT(q, GL_QUERY_RESULT, &return_value);
+      }
+    #else
+      {
+        glGetQueryObjectui64v(q, GL_QUERY_RESULT, &return_value);
+      }
+    #endif
+    return return_value;
+  }
+
+  /* GL_EXT_disjoint_timer_query reports when the timer values
+   * are not reliable (for example from a change of GPU clock),
+   * desktop GL does not have such a notion.
+   */
+  bool
+  timer_disjoint(void)
+  {
+    #ifdef FASTUIDRAW_GL_USE_GLES
+      {
+        return fastuidraw::gl::context_get<GLint>(GL_GPU_DISJOINT_EXT) != 0;
+      }
+    #else
+      {
+        return false;
+      }
+    #endif
+  }
+}
+
+//////////////////////////////////////
+// fastuidraw::gl::detail::GPUTimer methods
+fastuidraw::gl::detail::GPUTimer::
+GPUTimer(unsigned int max_pending_frames):
+  m_max_pending_frames(t_max(1u, max_pending_frames)),
+  m_number_timed_frames(0),
+  m_number_dropped_frames(0),
+  m_last_frame_time_ns(0)
+{
+  /* clear the disjoint state so that it only reflects
+   * what happens after the first query is issued.
+   */
+  timer_disjoint();
+}
+
+fastuidraw::gl::detail::GPUTimer::
+~GPUTimer()
+{
+  recycle(m_current);
+  for(Frame &frame : m_pending)
+    {
+      recycle(frame);
+    }
+
+  if (!m_free_queries.empty())
+    {
+      glDeleteQueries(m_free_queries.size(), &m_free_queries[0]);
+    }
+}
+
+void
+fastuidraw::gl::detail::GPUTimer::
+issue(bool begin_command, uint32_t group)
+{
+  Query Q;
+
+  if (m_free_queries.empty())
+    {
+      Q.m_name = 0;
+      glGenQueries(1, &Q.m_name);
+      FASTUIDRAWassert(Q.m_name != 0);
+    }
+  else
+    {
+      Q.m_name = m_free_queries.back();
+      m_free_queries.pop_back();
+    }
+
+  Q.m_begin_command = begin_command;
+  Q.m_group = group;
+  query_timestamp(Q.m_name);
+  m_current.m_queries.push_back(Q);
+}
+
+void
+fastuidraw::gl::detail::GPUTimer::
+begin_command(void)
+{
+  issue(true, 0u);
+}
+
+void
+fastuidraw::gl::detail::GPUTimer::
+end_range(uint32_t group)
+{
+  FASTUIDRAWassert(!m_current.m_queries.empty());
+  issue(false, group);
+}
+
+void
+fastuidraw::gl::detail::GPUTimer::
+recycle(Frame &frame)
+{
+  for(const Query &Q : frame.m_queries)
+    {
+      m_free_queries.push_back(Q.m_name);
+    }
+  frame.m_queries.clear();
+}
+
+bool
+fastuidraw::gl::detail::GPUTimer::
+results_available(const Frame &frame)
+{
+  GLuint available(GL_FALSE);
+
+  /* queries complete in the order they are issued, so
+   * it is enough to check the last query of the frame.
+   */
+  FASTUIDRAWassert(!frame.m_queries.empty());
+  glGetQueryObjectuiv(frame.m_queries.back().m_name,
+                      GL_QUERY_RESULT_AVAILABLE, &available);
+  return available == GL_TRUE;
+}
+
+void
+fastuidraw::gl::detail::GPUTimer::
+collect(const Frame &frame)
+{
+  std::map<uint32_t, uint64_t> group_times;
+  uint64_t command_start(0), prev(0);
+  bool in_command(false);
+
+  m_last_frame_time_ns = 0;
+  m_last_frame_command_times_ns.clear();
+  for(const Query &Q : frame.m_queries)
+    {
+      uint64_t t;
+
+      t = query_result(Q.m_name);
+      if (Q.m_begin_command)
+        {
+          if (in_command)
+            {
+              m_last_frame_command_times_ns.push_back(prev - command_start);
+            }
+          in_command = true;
+          command_start = t;
+        }
+      else
+        {
+          group_times[Q.m_group] += t - prev;
+        }
+      prev = t;
+    }
+
+  if (in_command)
+    {
+      m_last_frame_command_times_ns.push_back(prev - command_start);
+    }
+
+  for(uint64_t v : m_last_frame_command_times_ns)
+    {
+      m_last_frame_time_ns += v;
+    }
+
+  m_last_frame_groups.clear();
+  m_last_frame_group_times_ns.clear();
+  for(const auto &v : group_times)
+    {
+      m_last_frame_groups.push_back(v.first);
+      m_last_frame_group_times_ns.push_back(v.second);
+    }
+  ++m_number_timed_frames;
+}
+
+void
+fastuidraw::gl::detail::GPUTimer::
+end_frame(void)
+{
+  if (!m_current.m_queries.empty())
+    {
+      m_pending.push_back(Frame());
+      std::swap(m_pending.back().m_queries, m_current.m_queries);
+    }
+
+  /* Collect every frame whose results are available; because
+   * frames complete in order, stop at the first that is not.
+   * If the timer was disjoint, the results are not reliable and
+   * the frames are dropped.
+   */
+  if (!m_pending.empty() && results_available(m_pending.front()))
+    {
+      bool disjoint(timer_disjoint());
+
+      do
+        {
+          if (!disjoint)
+            {
+              collect(m_pending.front());
+            }
+          else
+            {
+              ++m_number_dropped_frames;
+            }
+          recycle(m_pending.front());
+          m_pending.pop_front();
+        }
+      while(!m_pending.empty() && results_available(m_pending.front()));
+    }
+
+  while(m_pending.size() > m_max_pending_frames)
+    {
+      recycle(m_pending.front());
+      m_pending.pop_front();
+      ++m_number_dropped_frames;
+    }
+}
@@ -0,0 +1,148 @@
+/*!
+ * \file gpu_timer.hpp
+ * \brief file gpu_timer.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <list>
+#include <vector>
+#include <stdint.h>
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/gl_backend/ngl_header.hpp>
+#include "../../private/util_private.hpp"
+
+namespace fastuidraw { namespace gl { namespace detail {
+
+/* GPUTimer issues GL_TIMESTAMP queries around the draw calls of
+ * each DrawCommand and around each range of draws of an item
+ * shader group. The queries of a frame are only read back once
+ * their results are available, which is typically a few frames
+ * later; the results are never waited on. If the results of
+ * too many frames are pending, the oldest frame is dropped.
+ * A GL context must be current for all methods, including the
+ * dtor.
+ */
+class GPUTimer:fastuidraw::noncopyable
+{
+public:
+  /* \param max_pending_frames maximum number of frames whose
+   *                           queries are waiting for results
+   */
+  explicit
+  GPUTimer(unsigned int max_pending_frames);
+
+  ~GPUTimer();
+
+  /* Issue the timestamp that starts the draws of a DrawCommand */
+  void
+  begin_command(void);
+
+  /* Issue a timestamp, the time since the previous timestamp
+   * of the DrawCommand is attributed to the item shader group.
+   */
+  void
+  end_range(uint32_t group);
+
+  /* Mark the end of a frame and collect the results of those
+   * previous frames whose results are available.
+   */
+  void
+  end_frame(void);
+
+  /* number of frames whose results have been collected */
+  unsigned int
+  number_timed_frames(void) const
+  {
+    return m_number_timed_frames;
+  }
+
+  /* number of frames whose queries were dropped */
+  unsigned int
+  number_dropped_frames(void) const
+  {
+    return m_number_dropped_frames;
+  }
+
+  /* values of the most recent frame whose results are collected */
+  uint64_t
+  last_frame_time_ns(void) const
+  {
+    return m_last_frame_time_ns;
+  }
+
+  c_array<const uint64_t>
+  last_frame_command_times_ns(void) const
+  {
+    return make_c_array(m_last_frame_command_times_ns);
+  }
+
+  c_array<const uint32_t>
+  last_frame_groups(void) const
+  {
+    return make_c_array(m_last_frame_groups);
+  }
+
+  c_array<const uint64_t>
+  last_frame_group_times_ns(void) const
+  {
+    return make_c_array(m_last_frame_group_times_ns);
+  }
+
+private:
+  class Query
+  {
+  public:
+    GLuint m_name;
+    bool m_begin_command;
+    uint32_t m_group;
+  };
+
+  class Frame
+  {
+  public:
+    std::vector<Query> m_queries;
+  };
+
+  void
+  issue(bool begin_command, uint32_t group);
+
+  bool
+  results_available(const Frame &frame);
+
+  void
+  collect(const Frame &frame);
+
+  void
+  recycle(Frame &frame);
+
+  unsigned int m_max_pending_frames;
+  Frame m_current;
+  std::list<Frame> m_pending;
+  std::vector<GLuint> m_free_queries;
+
+  unsigned int m_number_timed_frames, m_number_dropped_frames;
+  uint64_t m_last_frame_time_ns;
+  std::vector<uint64_t> m_last_frame_command_times_ns;
+  std::vector<uint32_t> m_last_frame_groups;
+  std::vector<uint64_t> m_last_frame_group_times_ns;
+};
+
+} //namespace detail
+} //namespace gl
+} //namespace fastuidraw
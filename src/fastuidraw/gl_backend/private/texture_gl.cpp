@@ -222,6 +222,60 @@ type_from_internal_format(GLenum fmt)
     }
 }
 
+unsigned int
+fastuidraw::gl::detail::
+bytes_per_texel(GLenum external_format, GLenum external_type)
+{
+  unsigned int num_components, component_size;
+
+  switch(external_type)
+    {
+    case GL_UNSIGNED_INT_24_8:
+      return 4;
+
+    case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+      return 8;
+
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+      component_size = 1;
+      break;
+
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+    case GL_HALF_FLOAT:
+      component_size = 2;
+      break;
+
+    default:
+      component_size = 4;
+    }
+
+  switch(external_format)
+    {
+    case GL_RED:
+    case GL_RED_INTEGER:
+    case GL_DEPTH_COMPONENT:
+      num_components = 1;
+      break;
+
+    case GL_RG:
+    case GL_RG_INTEGER:
+      num_components = 2;
+      break;
+
+    case GL_RGB:
+    case GL_RGB_INTEGER:
+      num_components = 3;
+      break;
+
+    default:
+      num_components = 4;
+    }
+
+  return num_components * component_size;
+}
+
 ////////////////////////////////
 // CopyImageSubData methods
 fastuidraw::gl::detail::CopyImageSubData::
@@ -370,3 +424,119 @@ compute_type(void)
     }
   #endif
 }
+
+///////////////////////////////////
+// PixelUnpackStaging methods
+fastuidraw::gl::detail::PixelUnpackStaging::
+PixelUnpackStaging(void):
+  m_current(0)
+{}
+
+fastuidraw::gl::detail::PixelUnpackStaging::
+~PixelUnpackStaging()
+{
+  for(Buffer &B : m_buffers)
+    {
+      m_release_target.release(B.m_fence);
+      m_release_target.release(buffer_resource, B.m_bo);
+    }
+}
+
+bool
+fastuidraw::gl::detail::PixelUnpackStaging::
+buffer_ready(Buffer &B, bool wait)
+{
+  if (B.m_fence)
+    {
+      GLenum status;
+      GLuint64 timeout(wait ? 1000000u : 0u);
+
+      do
+        {
+          status = glClientWaitSync(B.m_fence, 0, timeout);
+        }
+      while (wait && status == GL_TIMEOUT_EXPIRED);
+
+      if (status == GL_TIMEOUT_EXPIRED)
+        {
+          return false;
+        }
+      glDeleteSync(B.m_fence);
+      B.m_fence = nullptr;
+    }
+  return true;
+}
+
+uint8_t*
+fastuidraw::gl::detail::PixelUnpackStaging::
+map(unsigned int size)
+{
+  unsigned int num(m_buffers.size());
+  bool found(false);
+  void *p;
+
+  /* look for a buffer GL has finished sourcing from, starting
+   * after the one used last so that buffers are cycled.
+   */
+  for(unsigned int i = 1; i <= num && !found; ++i)
+    {
+      unsigned int c((m_current + i) % num);
+      if (buffer_ready(m_buffers[c], false))
+        {
+          m_current = c;
+          found = true;
+        }
+    }
+
+  if (!found)
+    {
+      if (num < max_number_buffers)
+        {
+          m_current = num;
+          m_buffers.push_back(Buffer());
+          m_release_target.capture();
+          glGenBuffers(1, &m_buffers.back().m_bo);
+        }
+      else
+        {
+          m_current = (m_current + 1) % num;
+          buffer_ready(m_buffers[m_current], true);
+        }
+    }
+
+  Buffer &B(m_buffers[m_current]);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, B.m_bo);
+  if (B.m_size < size)
+    {
+      B.m_size = t_max(size, 2u * B.m_size);
+      glBufferData(GL_PIXEL_UNPACK_BUFFER, B.m_size, nullptr, GL_STREAM_DRAW);
+    }
+
+  /* the fence guarantees GL is not reading from the buffer,
+   * so there is no need for GL to synchronize the map.
+   */
+  p = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+                       GL_MAP_WRITE_BIT
+                       | GL_MAP_INVALIDATE_BUFFER_BIT
+                       | GL_MAP_UNSYNCHRONIZED_BIT);
+  FASTUIDRAWassert(p);
+  return static_cast<uint8_t*>(p);
+}
+
+void
+fastuidraw::gl::detail::PixelUnpackStaging::
+unmap(void)
+{
+  glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+}
+
+void
+fastuidraw::gl::detail::PixelUnpackStaging::
+release(void)
+{
+  Buffer &B(m_buffers[m_current]);
+
+  FASTUIDRAWassert(!B.m_fence);
+  B.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
@@ -22,10 +22,18 @@
 #include <list>
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/fastuidraw_memory.hpp>
+#include <fastuidraw/util/math.hpp>
 #include <fastuidraw/util/c_array.hpp>
 #include <fastuidraw/gl_backend/ngl_header.hpp>
 #include <fastuidraw/gl_backend/gl_context_properties.hpp>
+#include <fastuidraw/gl_backend/gl_get.hpp>
+#include <fastuidraw/gl_backend/opengl_trait.hpp>
+#include "deferred_release.hpp"
 
 namespace fastuidraw { namespace gl { namespace detail {
 
@@ -35,6 +43,9 @@ format_from_internal_format(GLenum fmt);
 GLenum
 type_from_internal_format(GLenum fmt);
 
+unsigned int
+bytes_per_texel(GLenum external_format, GLenum external_type);
+
 class CopyImageSubData
 {
 public:
@@ -93,6 +104,66 @@ private:
 
 
 
+/* A PixelUnpackStaging is a small set of buffer objects through
+ * which texture uploads are staged with GL_PIXEL_UNPACK_BUFFER.
+ * A staging buffer is reused only once the fence placed after
+ * the uploads that last sourced from it has signaled; if all the
+ * buffers are still in use by GL, another buffer is created.
+ */
+class PixelUnpackStaging:fastuidraw::noncopyable
+{
+public:
+  PixelUnpackStaging(void);
+  ~PixelUnpackStaging();
+
+  /* Binds a staging buffer of at least the given size
+   * to GL_PIXEL_UNPACK_BUFFER and maps it for writing.
+   */
+  uint8_t*
+  map(unsigned int size);
+
+  /* Unmaps the staging buffer, leaving it bound to
+   * GL_PIXEL_UNPACK_BUFFER so that the texture uploads
+   * can source from it.
+   */
+  void
+  unmap(void);
+
+  /* To be called after the uploads that source from
+   * the staging buffer are issued; places the fence
+   * guarding the staging buffer and unbinds it.
+   */
+  void
+  release(void);
+
+private:
+  enum
+    {
+      max_number_buffers = 8
+    };
+
+  class Buffer
+  {
+  public:
+    Buffer(void):
+      m_bo(0),
+      m_size(0),
+      m_fence(nullptr)
+    {}
+
+    GLuint m_bo;
+    unsigned int m_size;
+    GLsync m_fence;
+  };
+
+  bool
+  buffer_ready(Buffer &B, bool wait);
+
+  std::vector<Buffer> m_buffers;
+  unsigned int m_current;
+  DeferredReleaseTarget m_release_target;
+};
+
 template<GLenum texture_target>
 class TextureTargetDimension
 {};
@@ -333,7 +404,8 @@ public:
                    GLenum external_format,
                    GLenum external_type,
                    GLenum filter,
-                   DimensionType dims, bool delayed);
+                   DimensionType dims, bool delayed,
+                   bool use_pixel_buffer = false);
   ~TextureGLGeneric();
 
   void
@@ -359,11 +431,88 @@ public:
     m_dims = new_num_layers;
   }
 
+  /* number of bytes of texel data sent to GL */
+  uint64_t
+  bytes_uploaded(void) const
+  {
+    return m_bytes_uploaded;
+  }
+
+  /* time spent issuing the uploads of texel data */
+  uint64_t
+  upload_time_ns(void) const
+  {
+    return m_upload_time_ns;
+  }
+
+  /* number of times the GL texture was re-created
+   * (and its contents copied) because of a resize
+   */
+  unsigned int
+  number_reallocations(void) const
+  {
+    return m_number_reallocations;
+  }
+
+  /* number of bytes copied on the GPU from old
+   * textures to their replacements on re-creation
+   */
+  uint64_t
+  bytes_copied_on_reallocation(void) const
+  {
+    return m_bytes_copied_on_reallocation;
+  }
+
 private:
+  /* A rectangle (box for N = 3) of the texture together with
+   * the unflushed commands whose union is that rectangle.
+   */
+  class UploadGroup
+  {
+  public:
+    explicit
+    UploadGroup(const typename EntryLocation::with_data &cmd):
+      m_box(cmd.first),
+      m_members(1, &cmd)
+    {}
+
+    EntryLocation m_box;
+    std::vector<const typename EntryLocation::with_data*> m_members;
+  };
 
   void
   create_texture(void) const;
 
+  void
+  record_upload(std::chrono::steady_clock::time_point start, uint64_t bytes)
+  {
+    std::chrono::steady_clock::duration d(std::chrono::steady_clock::now() - start);
+    m_upload_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    m_bytes_uploaded += bytes;
+  }
+
+  void
+  flush_through_pixel_buffer(void);
+
+  static
+  void
+  coalesce(unsigned int dim, std::vector<UploadGroup> &groups);
+
+  static
+  bool
+  overlaps(const EntryLocation &a, const EntryLocation &b)
+  {
+    for(unsigned int i = 0; i < N; ++i)
+      {
+        if (a.m_location[i] >= b.m_location[i] + b.m_size[i]
+            || b.m_location[i] >= a.m_location[i] + a.m_size[i])
+          {
+            return false;
+          }
+      }
+    return true;
+  }
+
   void
   tex_subimage(const EntryLocation &loc,
                c_array<const uint8_t> data);
@@ -371,15 +520,44 @@ private:
   void
   flush_size_change(void);
 
+  /* For array textures, the number of layers of the GL
+   * texture grows geometrically so that adding layers
+   * one at a time does not re-create the texture each
+   * time; the dimension of the layers is N - 1.
+   */
+  static
+  bool
+  grows_by_layers(void)
+  {
+    #ifdef GL_TEXTURE_1D_ARRAY
+      {
+        if (texture_target == GL_TEXTURE_1D_ARRAY)
+          {
+            return true;
+          }
+      }
+    #endif
+    return texture_target == GL_TEXTURE_2D_ARRAY;
+  }
+
+  bool
+  storage_fits(const vecN<int, N> &dims) const;
+
+  vecN<int, N>
+  storage_dims_for(const vecN<int, N> &dims) const;
+
   GLenum m_internal_format;
   GLenum m_external_format;
   GLenum m_external_type;
   GLenum m_filter;
 
   bool m_delayed;
+  bool m_use_pixel_buffer;
   vecN<int, N> m_dims;
   vecN<int, N> m_texture_dimension;
+  vecN<int, N> m_storage_dimension;
   mutable GLuint m_texture;
+  mutable DeferredReleaseTarget m_release_target;
   mutable bool m_use_tex_storage;
   mutable int m_number_times_create_texture_called;
   CopyImageSubData m_blitter;
@@ -388,6 +566,10 @@ private:
   typedef std::list<with_data> list_type;
 
   list_type m_unflushed_commands;
+  PixelUnpackStaging *m_staging;
+  uint64_t m_bytes_uploaded, m_upload_time_ns;
+  unsigned int m_number_reallocations;
+  uint64_t m_bytes_copied_on_reallocation;
 };
 
 ///////////////////////////////////////
@@ -398,21 +580,29 @@ TextureGLGeneric(GLenum internal_format,
                  GLenum external_format,
                  GLenum external_type,
                  GLenum filter,
-                 vecN<int, N> dims, bool delayed):
+                 vecN<int, N> dims, bool delayed,
+                 bool use_pixel_buffer):
   m_internal_format(internal_format),
   m_external_format(external_format),
   m_external_type(external_type),
   m_filter(filter),
   m_delayed(delayed),
+  m_use_pixel_buffer(use_pixel_buffer && delayed),
   m_dims(dims),
+  m_texture_dimension(dims),
+  m_storage_dimension(dims),
   m_texture(0),
-  m_number_times_create_texture_called(0)
+  m_number_times_create_texture_called(0),
+  m_staging(nullptr),
+  m_bytes_uploaded(0),
+  m_upload_time_ns(0),
+  m_number_reallocations(0),
+  m_bytes_copied_on_reallocation(0)
 {
   if (!m_delayed)
     {
       create_texture();
     }
-  m_texture_dimension = m_dims;
 }
 
 template<GLenum texture_target>
@@ -423,6 +613,51 @@ TextureGLGeneric<texture_target>::
     {
       delete_texture();
     }
+
+  if (m_staging)
+    {
+      FASTUIDRAWdelete(m_staging);
+    }
+}
+
+template<GLenum texture_target>
+bool
+TextureGLGeneric<texture_target>::
+storage_fits(const DimensionType &dims) const
+{
+  for(unsigned int i = 0; i < N; ++i)
+    {
+      if (grows_by_layers() && i == N - 1)
+        {
+          if (dims[i] > m_storage_dimension[i])
+            {
+              return false;
+            }
+        }
+      else if (dims[i] != m_storage_dimension[i])
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+template<GLenum texture_target>
+typename TextureGLGeneric<texture_target>::DimensionType
+TextureGLGeneric<texture_target>::
+storage_dims_for(const DimensionType &dims) const
+{
+  DimensionType return_value(dims);
+
+  if (grows_by_layers())
+    {
+      int max_layers, layers;
+
+      max_layers = context_get<GLint>(GL_MAX_ARRAY_TEXTURE_LAYERS);
+      layers = t_min(max_layers, 2 * m_storage_dimension[N - 1]);
+      return_value[N - 1] = t_max(dims[N - 1], layers);
+    }
+  return return_value;
 }
 
 template<GLenum texture_target>
@@ -432,11 +667,16 @@ flush_size_change(void)
 {
   if (m_texture_dimension != m_dims)
     {
-      /* only need to issue GL commands to resize
-       *  the underlying GL texture IF we do not have
-       *  a texture yet.
+      /* only need to issue GL commands to resize the underlying
+       * GL texture IF we have a texture and the texture cannot
+       * hold the new size. A sequence of resizes between flushes
+       * is realized with a single re-creation of the texture.
        */
-      if (m_texture != 0)
+      if (m_texture == 0)
+        {
+          m_storage_dimension = m_dims;
+        }
+      else if (!storage_fits(m_dims))
         {
           GLuint old_texture;
 
@@ -444,9 +684,12 @@ flush_size_change(void)
           /* create a new texture for the new size,
            */
           m_texture = 0;
+          m_storage_dimension = storage_dims_for(m_dims);
           create_texture();
 
-          /* copy the contents of old_texture to m_texture
+          /* copy the contents of old_texture to m_texture;
+           * the copy is done entirely by the GPU, only the
+           * region that holds data is copied.
            */
           vecN<GLint, 3> blit_dims;
           for(unsigned int i = 0; i < N; ++i)
@@ -482,6 +725,10 @@ flush_size_change(void)
                     0, 0, 0, //dst
                     blit_dims[0], blit_dims[1], blit_dims[2]);
 
+          ++m_number_reallocations;
+          m_bytes_copied_on_reallocation += uint64_t(blit_dims[0]) * blit_dims[1] * blit_dims[2]
+            * bytes_per_texel(m_external_format, m_external_type);
+
           /* now delete old_texture
            */
           glDeleteTextures(1, &old_texture);
@@ -496,7 +743,7 @@ TextureGLGeneric<texture_target>::
 delete_texture(void)
 {
   FASTUIDRAWassert(m_texture != 0);
-  glDeleteTextures(1, &m_texture);
+  m_release_target.release(texture_resource, m_texture);
   m_texture = 0;
 }
 
@@ -517,6 +764,7 @@ TextureGLGeneric<texture_target>::
 create_texture(void) const
 {
   FASTUIDRAWassert(m_texture == 0);
+  m_release_target.capture();
   glGenTextures(1, &m_texture);
   FASTUIDRAWassert(m_texture!=0);
   glBindTexture(texture_target, m_texture);
@@ -526,7 +774,7 @@ create_texture(void) const
       m_use_tex_storage = ctx.is_es() || ctx.version() >= ivec2(4, 2)
         || ctx.has_extension("GL_ARB_texture_storage");
     }
-  tex_storage(m_use_tex_storage, texture_target, m_internal_format, m_dims);
+  tex_storage(m_use_tex_storage, texture_target, m_internal_format, m_storage_dimension);
   glTexParameteri(texture_target, GL_TEXTURE_MIN_FILTER, m_filter);
   glTexParameteri(texture_target, GL_TEXTURE_MAG_FILTER, m_filter);
   ++m_number_times_create_texture_called;
@@ -544,8 +792,22 @@ flush(void)
       create_texture();
     }
 
+  if (m_use_pixel_buffer && !m_staging)
+    {
+      m_staging = FASTUIDRAWnew PixelUnpackStaging();
+    }
+
   if (!m_unflushed_commands.empty())
     {
+      if (m_use_pixel_buffer)
+        {
+          flush_through_pixel_buffer();
+          return;
+        }
+
+      std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+      uint64_t bytes(0);
+
       glBindTexture(texture_target, m_texture);
       glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
       for(const auto &cmd : m_unflushed_commands)
@@ -556,11 +818,218 @@ flush(void)
                         cmd.first.m_size,
                         m_external_format, m_external_type,
                         &cmd.second[0]);
+          bytes += cmd.second.size();
         }
       m_unflushed_commands.clear();
+      record_upload(start, bytes);
     }
 }
 
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+coalesce(unsigned int dim, std::vector<UploadGroup> &groups)
+{
+  /* two groups can be merged along dim if they match in all
+   * other dimensions and are adjacent along dim; sort so that
+   * such groups are consecutive. The groups passed do not
+   * overlap, so their order of upload does not matter, but
+   * the sort is stable so that the result is deterministic.
+   */
+  std::stable_sort(groups.begin(), groups.end(),
+            [dim](const UploadGroup &a, const UploadGroup &b)
+            {
+              for(unsigned int i = 0; i < N; ++i)
+                {
+                  if (i != dim)
+                    {
+                      if (a.m_box.m_location[i] != b.m_box.m_location[i])
+                        {
+                          return a.m_box.m_location[i] < b.m_box.m_location[i];
+                        }
+                      if (a.m_box.m_size[i] != b.m_box.m_size[i])
+                        {
+                          return a.m_box.m_size[i] < b.m_box.m_size[i];
+                        }
+                    }
+                }
+              return a.m_box.m_location[dim] < b.m_box.m_location[dim];
+            });
+
+  unsigned int dst(0);
+  for(unsigned int src = 1, end = groups.size(); src < end; ++src)
+    {
+      UploadGroup &last(groups[dst]);
+      const UploadGroup &G(groups[src]);
+      bool can_merge(last.m_box.m_location[dim] + last.m_box.m_size[dim] == G.m_box.m_location[dim]);
+
+      for(unsigned int i = 0; i < N && can_merge; ++i)
+        {
+          can_merge = (i == dim)
+            || (last.m_box.m_location[i] == G.m_box.m_location[i]
+                && last.m_box.m_size[i] == G.m_box.m_size[i]);
+        }
+
+      if (can_merge)
+        {
+          last.m_box.m_size[dim] += G.m_box.m_size[dim];
+          last.m_members.insert(last.m_members.end(), G.m_members.begin(), G.m_members.end());
+        }
+      else
+        {
+          ++dst;
+          if (dst != src)
+            {
+              groups[dst] = G;
+            }
+        }
+    }
+
+  if (!groups.empty())
+    {
+      groups.erase(groups.begin() + dst + 1, groups.end());
+    }
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+flush_through_pixel_buffer(void)
+{
+  std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+  std::vector<UploadGroup> groups;
+  std::vector<unsigned int> offsets;
+  unsigned int total_size(0), texel_size(0);
+  uint64_t bytes(0);
+  uint8_t *dst;
+
+  /* coalesce adjacent rectangles (for example consecutive glyphs
+   * or image tiles uploaded to the same layer) so that fewer
+   * glTexSubImage calls are issued. Coalescing reorders the
+   * uploads, so the commands are split, in submission order,
+   * into batches of commands that do not overlap (a region
+   * freed and allocated again before a flush is written more
+   * than once); each batch is coalesced on its own and the
+   * batches are uploaded in order so that later writes win.
+   */
+  groups.reserve(m_unflushed_commands.size());
+  for(typename list_type::const_iterator begin = m_unflushed_commands.begin(),
+        end = m_unflushed_commands.end(); begin != end;)
+    {
+      std::vector<UploadGroup> batch;
+      typename list_type::const_iterator c;
+
+      for(c = begin; c != end; ++c)
+        {
+          const auto &cmd(*c);
+          unsigned int volume(1);
+          bool hits_batch(false);
+
+          for(typename list_type::const_iterator b = begin; b != c && !hits_batch; ++b)
+            {
+              hits_batch = overlaps(cmd.first, b->first);
+            }
+
+          if (hits_batch)
+            {
+              break;
+            }
+
+          FASTUIDRAWassert(!cmd.second.empty());
+          for(unsigned int i = 0; i < N; ++i)
+            {
+              volume *= cmd.first.m_size[i];
+            }
+          FASTUIDRAWassert(volume > 0 && cmd.second.size() % volume == 0);
+          FASTUIDRAWassert(texel_size == 0 || texel_size == cmd.second.size() / volume);
+          texel_size = cmd.second.size() / volume;
+
+          batch.push_back(UploadGroup(cmd));
+        }
+
+      for(unsigned int pass = 0; pass < 2; ++pass)
+        {
+          for(unsigned int dim = 0; dim < N; ++dim)
+            {
+              coalesce(dim, batch);
+            }
+        }
+      groups.insert(groups.end(), batch.begin(), batch.end());
+      begin = c;
+    }
+
+  offsets.reserve(groups.size());
+  for(const UploadGroup &G : groups)
+    {
+      unsigned int volume(1);
+      for(unsigned int i = 0; i < N; ++i)
+        {
+          volume *= G.m_box.m_size[i];
+        }
+      offsets.push_back(total_size);
+      /* keep each region aligned for any texel type */
+      total_size += (volume * texel_size + 15u) & ~15u;
+    }
+
+  /* copy the data of each member into its place within the
+   * rectangle of its group, each row (along dimension 0) of
+   * a member is contiguous in both source and destination.
+   */
+  dst = m_staging->map(total_size);
+  for(unsigned int g = 0, endg = groups.size(); g < endg; ++g)
+    {
+      const UploadGroup &G(groups[g]);
+      vecN<int, 3> box_size(1, 1, 1);
+
+      for(unsigned int i = 0; i < N; ++i)
+        {
+          box_size[i] = G.m_box.m_size[i];
+        }
+
+      for(const auto *member : G.m_members)
+        {
+          vecN<int, 3> rel(0, 0, 0), sz(1, 1, 1);
+          unsigned int row_bytes;
+          const uint8_t *src(&member->second[0]);
+
+          for(unsigned int i = 0; i < N; ++i)
+            {
+              rel[i] = member->first.m_location[i] - G.m_box.m_location[i];
+              sz[i] = member->first.m_size[i];
+            }
+          row_bytes = sz[0] * texel_size;
+
+          for(int z = 0; z < sz[2]; ++z)
+            {
+              for(int y = 0; y < sz[1]; ++y, src += row_bytes)
+                {
+                  unsigned int texel;
+
+                  texel = ((rel[2] + z) * box_size[1] + rel[1] + y) * box_size[0] + rel[0];
+                  std::memcpy(dst + offsets[g] + texel * texel_size, src, row_bytes);
+                }
+            }
+          bytes += member->second.size();
+        }
+    }
+  m_staging->unmap();
+
+  glBindTexture(texture_target, m_texture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  for(unsigned int g = 0, endg = groups.size(); g < endg; ++g)
+    {
+      tex_sub_image(texture_target,
+                    groups[g].m_box.m_location,
+                    groups[g].m_box.m_size,
+                    m_external_format, m_external_type,
+                    offset_as_void_pointer(offsets[g]));
+    }
+  m_staging->release();
+
+  m_unflushed_commands.clear();
+  record_upload(start, bytes);
+}
+
 
 template<GLenum texture_target>
 void
@@ -582,6 +1051,8 @@ set_data_vector(const EntryLocation &loc,
     }
   else
     {
+      std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+
       flush_size_change();
       glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
       glBindTexture(texture_target, m_texture);
@@ -590,6 +1061,7 @@ set_data_vector(const EntryLocation &loc,
                     loc.m_size,
                     m_external_format, m_external_type,
                     &data[0]);
+      record_upload(start, data.size());
     }
 }
 
@@ -613,6 +1085,8 @@ set_data_c_array(const EntryLocation &loc,
     }
   else
     {
+      std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+
       flush_size_change();
       glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
       glBindTexture(texture_target, m_texture);
@@ -621,7 +1095,7 @@ set_data_c_array(const EntryLocation &loc,
                     loc.m_size,
                     m_external_format, m_external_type,
                     data.c_ptr());
-
+      record_upload(start, data.size());
     }
 }
 
@@ -633,10 +1107,11 @@ template<GLenum texture_target,
 class TextureGL:public TextureGLGeneric<texture_target>
 {
 public:
-  TextureGL(typename TextureGLGeneric<texture_target>::DimensionType dims, bool delayed):
+  TextureGL(typename TextureGLGeneric<texture_target>::DimensionType dims, bool delayed,
+            bool use_pixel_buffer = false):
     TextureGLGeneric<texture_target>(internal_format, external_format,
                                      external_type, filter,
-                                     dims, delayed)
+                                     dims, delayed, use_pixel_buffer)
   {}
 };
 
@@ -322,9 +322,14 @@ stream_uber(bool use_switch, ShaderSource &dst, array_type shaders,
       << uber_func_with_args << "\n"
       << "{\n";
 
+  /* initialize the return value so that a shader ID not
+   * in the uber-shader (for example a shader registered
+   * after the uber-shader was built) gives a degenerate
+   * vertex position and the item is not drawn.
+   */
   if (has_return_value)
     {
-      str << "    " << return_type << " p;\n";
+      str << "    " << return_type << " p = " << return_type << "(0.0);\n";
     }
 
   for(const auto &sh : shaders)
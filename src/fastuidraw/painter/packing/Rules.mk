@@ -4,7 +4,8 @@ dirstack_$(sp)	:= $(d)
 d		:= $(dir)
 # End standard header
 
-FASTUIDRAW_SOURCES += $(call filelist, painter_backend.cpp painter_draw.cpp painter_packer.cpp)
+FASTUIDRAW_SOURCES += $(call filelist, painter_backend.cpp painter_draw.cpp painter_packer.cpp \
+	painter_packing_stats.cpp)
 
 # Begin standard footer
 d		:= $(dirstack_$(sp))
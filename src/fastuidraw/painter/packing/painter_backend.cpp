@@ -53,6 +53,7 @@ namespace
     fastuidraw::reference_counted_ptr<fastuidraw::ColorStopAtlas> m_colorstop_atlas;
     fastuidraw::PainterBackend::ConfigurationBase m_config;
     fastuidraw::PainterBackend::PerformanceHints m_hints;
+    fastuidraw::PainterPackingStats m_packing_stats;
     fastuidraw::PainterShaderSet m_default_shaders;
     bool m_default_shaders_registered;
   };
@@ -63,12 +64,14 @@ namespace
     ConfigurationPrivate(void):
       m_brush_shader_mask(0),
       m_alignment(4),
-      m_blend_type(fastuidraw::PainterBlendShader::dual_src)
+      m_blend_type(fastuidraw::PainterBlendShader::dual_src),
+      m_reorder_window(0)
     {}
 
     uint32_t m_brush_shader_mask;
     int m_alignment;
     enum fastuidraw::PainterBlendShader::shader_type m_blend_type;
+    unsigned int m_reorder_window;
   };
 }
 
@@ -137,6 +140,9 @@ setget_implement(fastuidraw::PainterBackend::ConfigurationBase,
 setget_implement(fastuidraw::PainterBackend::ConfigurationBase,
                  ConfigurationPrivate,
                  enum fastuidraw::PainterBlendShader::shader_type, blend_type)
+setget_implement(fastuidraw::PainterBackend::ConfigurationBase,
+                 ConfigurationPrivate,
+                 unsigned int, reorder_window)
 
 ////////////////////////////////////
 // fastuidraw::PainterBackend methods
@@ -346,3 +352,21 @@ configuration_base(void) const
   d = static_cast<PainterBackendPrivate*>(m_d);
   return d->m_config;
 }
+
+const fastuidraw::PainterPackingStats&
+fastuidraw::PainterBackend::
+packing_stats(void) const
+{
+  PainterBackendPrivate *d;
+  d = static_cast<PainterBackendPrivate*>(m_d);
+  return d->m_packing_stats;
+}
+
+void
+fastuidraw::PainterBackend::
+packing_stats(const PainterPackingStats &st)
+{
+  PainterBackendPrivate *d;
+  d = static_cast<PainterBackendPrivate*>(m_d);
+  d->m_packing_stats = st;
+}
@@ -21,10 +21,12 @@
 #include <vector>
 #include <list>
 #include <cstring>
+#include <chrono>
 
 #include <fastuidraw/painter/packing/painter_packer.hpp>
 #include <fastuidraw/painter/painter_header.hpp>
 #include "../../private/util_private.hpp"
+#include "../../private/clip.hpp"
 
 namespace
 {
@@ -331,6 +333,45 @@ namespace
 
   class PainterPackerPrivate;
 
+  /* A draw whose index data is held back by the reorder
+   * window, see PainterBackend::ConfigurationBase::reorder_window().
+   */
+  class pending_draw
+  {
+  public:
+    bool
+    intersects(const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax) const
+    {
+      return m_min.x() <= pmax.x() && pmin.x() <= m_max.x()
+        && m_min.y() <= pmax.y() && pmin.y() <= m_max.y();
+    }
+
+    PainterShaderGroupPrivate m_state;
+
+    /* conservative bounding box in normalized device
+     * coordinates of the region the draw can affect,
+     * if m_min > m_max then the region is empty.
+     */
+    fastuidraw::vec2 m_min, m_max;
+
+    std::vector<fastuidraw::PainterIndex> m_indices;
+
+    /* next pending_draw in the same reorder_run, -1
+     * indicates the end of the list.
+     */
+    int m_next;
+  };
+
+  /* A sequence of pending_draw values sharing the same
+   * shader groups, linked by pending_draw::m_next.
+   */
+  class reorder_run
+  {
+  public:
+    unsigned int m_first, m_last;
+    fastuidraw::vec2 m_min, m_max;
+  };
+
   class per_draw_command
   {
   public:
@@ -347,8 +388,8 @@ namespace
     unsigned int
     index_room(void)
     {
-      FASTUIDRAWassert(m_indices_written <= m_draw_command->m_indices.size());
-      return m_draw_command->m_indices.size() - m_indices_written;
+      FASTUIDRAWassert(m_indices_written + m_indices_pending <= m_draw_command->m_indices.size());
+      return m_draw_command->m_indices.size() - m_indices_written - m_indices_pending;
     }
 
     unsigned int
@@ -369,9 +410,64 @@ namespace
     void
     unmap(void)
     {
+      FASTUIDRAWassert(m_indices_pending == 0);
       m_draw_command->unmap(m_attributes_written, m_indices_written, store_written());
     }
 
+    /* returns true if changing from the shader groups
+     * a to b requires a call to PainterDraw::draw_break().
+     */
+    bool
+    requires_draw_break(const PainterShaderGroupPrivate &a,
+                        const PainterShaderGroupPrivate &b) const
+    {
+      return a.m_item_group != b.m_item_group
+        || a.m_blend_group != b.m_blend_group
+        || (m_brush_shader_mask & (a.m_brush ^ b.m_brush)) != 0u
+        || a.m_blend_mode != b.m_blend_mode;
+    }
+
+    /* set the shader groups for the indices written next,
+     * calling PainterDraw::draw_break() if necessary.
+     */
+    void
+    shader_group(const PainterShaderGroupPrivate &current,
+                 fastuidraw::PainterPackingStats &stats)
+    {
+      if (requires_draw_break(m_prev_state, current))
+        {
+          record_break_reasons(m_prev_state, current, stats);
+          m_draw_command->draw_break(m_prev_state, current,
+                                     m_indices_written);
+        }
+      m_prev_state = current;
+    }
+
+    void
+    record_break_reasons(const PainterShaderGroupPrivate &a,
+                         const PainterShaderGroupPrivate &b,
+                         fastuidraw::PainterPackingStats &stats) const
+    {
+      if (a.m_item_group != b.m_item_group)
+        {
+          ++stats.m_break_counts[fastuidraw::PainterPackingStats::item_shader_change];
+        }
+      if (a.m_blend_group != b.m_blend_group || a.m_blend_mode != b.m_blend_mode)
+        {
+          ++stats.m_break_counts[fastuidraw::PainterPackingStats::blend_change];
+        }
+      if ((m_brush_shader_mask & (a.m_brush ^ b.m_brush)) != 0u)
+        {
+          ++stats.m_break_counts[fastuidraw::PainterPackingStats::brush_mask_change];
+        }
+    }
+
+    const PainterShaderGroupPrivate&
+    shader_group(void) const
+    {
+      return m_prev_state;
+    }
+
     void
     pack_painter_state(const fastuidraw::PainterPackerData &state,
                        PainterPackerPrivate *p, painter_state_location &out_data);
@@ -384,17 +480,44 @@ namespace
                 const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &item_shader,
                 int z,
                 const painter_state_location &loc,
-                const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+                const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back,
+                PainterShaderGroupPrivate &out_shader_group);
 
     void
-    draw_break(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw::Action> &action)
+    draw_break(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw::Action> &action,
+               fastuidraw::PainterPackingStats &stats)
     {
+      if (action && action->barrier())
+        {
+          ++stats.m_break_counts[fastuidraw::PainterPackingStats::barrier_action];
+        }
+      else
+        {
+          ++stats.m_break_counts[fastuidraw::PainterPackingStats::draw_break_action];
+        }
       m_draw_command->draw_break(action, m_indices_written);
     }
 
+    void
+    record_fill(fastuidraw::PainterPackingStats &stats)
+    {
+      ++stats.m_number_draws;
+      stats.record_fill(fastuidraw::PainterPackingStats::attribute_buffer,
+                        m_attributes_written, m_draw_command->m_attributes.size());
+      stats.record_fill(fastuidraw::PainterPackingStats::index_buffer,
+                        m_indices_written, m_draw_command->m_indices.size());
+      stats.record_fill(fastuidraw::PainterPackingStats::store_buffer,
+                        store_written(), m_draw_command->m_store.size());
+    }
+
     fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> m_draw_command;
     unsigned int m_attributes_written, m_indices_written;
 
+    /* number of indices held back by the reorder window;
+     * room for them is reserved in m_draw_command->m_indices.
+     */
+    unsigned int m_indices_pending;
+
   private:
     fastuidraw::c_array<fastuidraw::generic_data>
     allocate_store(unsigned int num_elements);
@@ -455,6 +578,10 @@ namespace
   {
   public:
     std::vector<unsigned int> m_attribs_loaded;
+    std::vector<reorder_run> m_reorder_runs;
+    std::vector<fastuidraw::vec2> m_clip_pts;
+    std::vector<float> m_clipper_floats;
+    fastuidraw::vecN<std::vector<fastuidraw::vec2>, 2> m_clipper_vec2s;
   };
 
   class AttributeIndexSrcFromArray
@@ -556,6 +683,33 @@ namespace
     void
     start_new_command(void);
 
+    void
+    start_new_command(enum fastuidraw::PainterPackingStats::break_reason_t reason)
+    {
+      ++m_packing_stats.m_break_counts[reason];
+      start_new_command();
+    }
+
+    void
+    unmap_current_command(void);
+
+    bool
+    reorder_enabled(void) const
+    {
+      return m_reorder_window > 1u;
+    }
+
+    void
+    compute_clip_bounding_box(const fastuidraw::PainterPackerData &draw_state,
+                              fastuidraw::vec2 &out_min, fastuidraw::vec2 &out_max);
+
+    pending_draw&
+    add_pending_draw(const PainterShaderGroupPrivate &st,
+                     const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax);
+
+    void
+    flush_pending_draws(void);
+
     void
     upload_draw_state(const fastuidraw::PainterPackerData &draw_state);
 
@@ -616,6 +770,35 @@ namespace
 
     PainterPackerPrivateWorkroom m_work_room;
     fastuidraw::vecN<unsigned int, fastuidraw::PainterPacker::num_stats> m_stats;
+
+    unsigned int m_reorder_window;
+    std::vector<pending_draw> m_pending_draws;
+    unsigned int m_number_pending_draws;
+
+    fastuidraw::PainterPackingStats m_packing_stats;
+  };
+
+  /* Adds the time from ctor to dtor to a counter of nanoseconds.
+   */
+  class packing_timer:fastuidraw::noncopyable
+  {
+  public:
+    explicit
+    packing_timer(uint64_t &counter):
+      m_counter(counter),
+      m_start(std::chrono::steady_clock::now())
+    {}
+
+    ~packing_timer()
+    {
+      std::chrono::nanoseconds ns;
+      ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+      m_counter += ns.count();
+    }
+
+  private:
+    uint64_t &m_counter;
+    std::chrono::steady_clock::time_point m_start;
   };
 }
 
@@ -628,6 +811,7 @@ per_draw_command(const fastuidraw::reference_counted_ptr<const fastuidraw::Paint
   m_draw_command(r),
   m_attributes_written(0),
   m_indices_written(0),
+  m_indices_pending(0),
   m_store_blocks_written(0),
   m_alignment(config.alignment()),
   m_brush_shader_mask(config.brush_shader_mask())
@@ -700,7 +884,8 @@ pack_header(unsigned int header_size,
             const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &item_shader,
             int z,
             const painter_state_location &loc,
-            const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+            const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back,
+            PainterShaderGroupPrivate &current)
 {
   unsigned int return_value;
   fastuidraw::c_array<fastuidraw::generic_data> dst;
@@ -714,7 +899,6 @@ pack_header(unsigned int header_size,
       call_back->current_draw(m_draw_command);
     }
 
-  PainterShaderGroupPrivate current;
   fastuidraw::PainterShader::Tag blend;
 
   if (blend_shader)
@@ -737,17 +921,6 @@ pack_header(unsigned int header_size,
   header.m_z = z;
   header.pack_data(m_alignment, dst);
 
-  if (current.m_item_group != m_prev_state.m_item_group
-     || current.m_blend_group != m_prev_state.m_blend_group
-     || (m_brush_shader_mask & (current.m_brush ^ m_prev_state.m_brush)) != 0u
-     || current.m_blend_mode != m_prev_state.m_blend_mode)
-    {
-      m_draw_command->draw_break(m_prev_state, current,
-                                 m_indices_written);
-    }
-
-  m_prev_state = current;
-
   if (call_back)
     {
       call_back->header_added(header, dst);
@@ -774,22 +947,192 @@ PainterPackerPrivate(fastuidraw::reference_counted_ptr<fastuidraw::PainterBacken
   // the shaders as well.
   m_default_shaders = m_backend->default_shaders();
   m_number_begins = 0;
+  m_reorder_window = m_backend->configuration_base().reorder_window();
+  m_number_pending_draws = 0;
 }
 
 void
 PainterPackerPrivate::
-start_new_command(void)
+unmap_current_command(void)
 {
-  if (!m_accumulated_draws.empty())
+  FASTUIDRAWassert(!m_accumulated_draws.empty());
+  flush_pending_draws();
+
+  per_draw_command &c(m_accumulated_draws.back());
+
+  m_stats[fastuidraw::PainterPacker::num_attributes] += c.m_attributes_written;
+  m_stats[fastuidraw::PainterPacker::num_indices] += c.m_indices_written;
+  m_stats[fastuidraw::PainterPacker::num_generic_datas] += c.store_written();
+  m_stats[fastuidraw::PainterPacker::num_draws] += 1u;
+  c.record_fill(m_packing_stats);
+
+  c.unmap();
+}
+
+void
+PainterPackerPrivate::
+compute_clip_bounding_box(const fastuidraw::PainterPackerData &draw_state,
+                          fastuidraw::vec2 &out_min, fastuidraw::vec2 &out_max)
+{
+  /* The clip equations are in clip coordinates; the region
+   * of normalized device coordinates they leave unclipped
+   * is the square [-1, 1]x[-1, 1] clipped against them.
+   */
+  const fastuidraw::PainterClipEquations &clip(fetch_value(draw_state.m_clip));
+  fastuidraw::vecN<fastuidraw::vec2, 4> square;
+
+  square[0] = fastuidraw::vec2(-1.0f, -1.0f);
+  square[1] = fastuidraw::vec2(-1.0f, +1.0f);
+  square[2] = fastuidraw::vec2(+1.0f, +1.0f);
+  square[3] = fastuidraw::vec2(+1.0f, -1.0f);
+  fastuidraw::detail::clip_against_planes(fastuidraw::c_array<const fastuidraw::vec3>(&clip.m_clip_equations[0], 4),
+                                          fastuidraw::c_array<const fastuidraw::vec2>(&square[0], 4),
+                                          m_work_room.m_clip_pts,
+                                          m_work_room.m_clipper_floats,
+                                          m_work_room.m_clipper_vec2s);
+
+  out_min = fastuidraw::vec2(+1.0f, +1.0f);
+  out_max = fastuidraw::vec2(-1.0f, -1.0f);
+  for(const fastuidraw::vec2 &p : m_work_room.m_clip_pts)
+    {
+      out_min.x() = fastuidraw::t_min(out_min.x(), p.x());
+      out_min.y() = fastuidraw::t_min(out_min.y(), p.y());
+      out_max.x() = fastuidraw::t_max(out_max.x(), p.x());
+      out_max.y() = fastuidraw::t_max(out_max.y(), p.y());
+    }
+}
+
+pending_draw&
+PainterPackerPrivate::
+add_pending_draw(const PainterShaderGroupPrivate &st,
+                 const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax)
+{
+  if (m_number_pending_draws == m_reorder_window)
+    {
+      flush_pending_draws();
+    }
+
+  if (m_number_pending_draws == m_pending_draws.size())
+    {
+      m_pending_draws.resize(m_number_pending_draws + 1);
+    }
+
+  pending_draw &return_value(m_pending_draws[m_number_pending_draws]);
+  ++m_number_pending_draws;
+
+  return_value.m_state = st;
+  return_value.m_min = pmin;
+  return_value.m_max = pmax;
+  return_value.m_indices.clear();
+  return_value.m_next = -1;
+  return return_value;
+}
+
+void
+PainterPackerPrivate::
+flush_pending_draws(void)
+{
+  if (m_number_pending_draws == 0)
+    {
+      return;
+    }
+
+  per_draw_command &cmd(m_accumulated_draws.back());
+  std::vector<reorder_run> &runs(m_work_room.m_reorder_runs);
+  unsigned int breaks_before(0), breaks_after(0);
+  PainterShaderGroupPrivate prev(cmd.shader_group());
+
+  /* Greedily place each draw at the end of the last run that
+   * has the same shader groups provided that the draw does
+   * not intersect any run that comes after that run. Since
+   * every draw in those runs was added before the draw, moving
+   * the draw in front of them does not change the rendered
+   * result.
+   */
+  runs.clear();
+  for(unsigned int i = 0; i < m_number_pending_draws; ++i)
     {
-      per_draw_command &c(m_accumulated_draws.back());
+      pending_draw &draw(m_pending_draws[i]);
+      int target(-1);
+
+      if (cmd.requires_draw_break(prev, draw.m_state))
+        {
+          ++breaks_before;
+        }
+      prev = draw.m_state;
+
+      for(int r = static_cast<int>(runs.size()) - 1; r >= 0; --r)
+        {
+          if (!cmd.requires_draw_break(m_pending_draws[runs[r].m_first].m_state, draw.m_state))
+            {
+              target = r;
+              break;
+            }
+
+          if (draw.intersects(runs[r].m_min, runs[r].m_max))
+            {
+              break;
+            }
+        }
 
-      m_stats[fastuidraw::PainterPacker::num_attributes] += c.m_attributes_written;
-      m_stats[fastuidraw::PainterPacker::num_indices] += c.m_indices_written;
-      m_stats[fastuidraw::PainterPacker::num_generic_datas] += c.store_written();
-      m_stats[fastuidraw::PainterPacker::num_draws] += 1u;
+      if (target == -1)
+        {
+          reorder_run R;
 
-      c.unmap();
+          R.m_first = R.m_last = i;
+          R.m_min = draw.m_min;
+          R.m_max = draw.m_max;
+          runs.push_back(R);
+        }
+      else
+        {
+          reorder_run &R(runs[target]);
+
+          m_pending_draws[R.m_last].m_next = i;
+          R.m_last = i;
+          R.m_min.x() = fastuidraw::t_min(R.m_min.x(), draw.m_min.x());
+          R.m_min.y() = fastuidraw::t_min(R.m_min.y(), draw.m_min.y());
+          R.m_max.x() = fastuidraw::t_max(R.m_max.x(), draw.m_max.x());
+          R.m_max.y() = fastuidraw::t_max(R.m_max.y(), draw.m_max.y());
+        }
+    }
+
+  for(const reorder_run &R : runs)
+    {
+      if (cmd.requires_draw_break(cmd.shader_group(), m_pending_draws[R.m_first].m_state))
+        {
+          ++breaks_after;
+        }
+      cmd.shader_group(m_pending_draws[R.m_first].m_state, m_packing_stats);
+
+      for(int i = R.m_first; i != -1; i = m_pending_draws[i].m_next)
+        {
+          fastuidraw::c_array<const fastuidraw::PainterIndex> src;
+          fastuidraw::c_array<fastuidraw::PainterIndex> dst;
+
+          src = fastuidraw::make_c_array(m_pending_draws[i].m_indices);
+          dst = cmd.m_draw_command->m_indices.sub_array(cmd.m_indices_written, src.size());
+          std::copy(src.begin(), src.end(), dst.begin());
+
+          FASTUIDRAWassert(cmd.m_indices_pending >= src.size());
+          cmd.m_indices_written += src.size();
+          cmd.m_indices_pending -= src.size();
+        }
+    }
+
+  FASTUIDRAWassert(cmd.m_indices_pending == 0);
+  FASTUIDRAWassert(breaks_after <= breaks_before);
+  m_stats[fastuidraw::PainterPacker::num_draw_breaks_avoided] += breaks_before - breaks_after;
+  m_number_pending_draws = 0;
+}
+
+void
+PainterPackerPrivate::
+start_new_command(void)
+{
+  if (!m_accumulated_draws.empty())
+    {
+      unmap_current_command();
     }
 
   fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> r;
@@ -820,7 +1163,7 @@ upload_draw_state(const fastuidraw::PainterPackerData &draw_state)
   needed_room = compute_room_needed_for_packing(draw_state);
   if (needed_room > m_accumulated_draws.back().store_room())
     {
-      start_new_command();
+      start_new_command(fastuidraw::PainterPackingStats::store_full);
     }
   m_accumulated_draws.back().pack_painter_state(draw_state, this, m_painter_state_location);
 }
@@ -835,9 +1178,11 @@ draw_generic_implement(const fastuidraw::reference_counted_ptr<fastuidraw::Paint
                        const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
 {
   bool allocate_header;
-  unsigned int header_loc;
+  unsigned int header_loc(0);
   const unsigned int NOT_LOADED = ~0u;
   unsigned int number_index_chunks, number_attribute_chunks;
+  pending_draw *pending(nullptr);
+  fastuidraw::vec2 clip_min, clip_max;
 
   number_index_chunks = src.number_index_chunks();
   number_attribute_chunks = src.number_attribute_chunks();
@@ -854,6 +1199,11 @@ draw_generic_implement(const fastuidraw::reference_counted_ptr<fastuidraw::Paint
 
   FASTUIDRAWassert(shader);
 
+  if (reorder_enabled())
+    {
+      compute_clip_bounding_box(draw, clip_min, clip_max);
+    }
+
   upload_draw_state(draw);
   allocate_header = true;
 
@@ -883,7 +1233,18 @@ draw_generic_implement(const fastuidraw::reference_counted_ptr<fastuidraw::Paint
       if (attrib_room < needed_attrib_room || index_room < num_indices
          || (allocate_header && data_room < m_header_size))
         {
-          start_new_command();
+          if (attrib_room < needed_attrib_room)
+            {
+              start_new_command(fastuidraw::PainterPackingStats::attributes_full);
+            }
+          else if (index_room < num_indices)
+            {
+              start_new_command(fastuidraw::PainterPackingStats::indices_full);
+            }
+          else
+            {
+              start_new_command(fastuidraw::PainterPackingStats::store_full);
+            }
           upload_draw_state(draw);
 
           /* reset attribs_loaded[] and recompute needed_attrib_room
@@ -908,6 +1269,8 @@ draw_generic_implement(const fastuidraw::reference_counted_ptr<fastuidraw::Paint
       per_draw_command &cmd(m_accumulated_draws.back());
       if (allocate_header)
         {
+          PainterShaderGroupPrivate shader_group;
+
           ++m_stats[fastuidraw::PainterPacker::num_headers];
           allocate_header = false;
           header_loc = cmd.pack_header(m_header_size,
@@ -916,7 +1279,15 @@ draw_generic_implement(const fastuidraw::reference_counted_ptr<fastuidraw::Paint
                                        m_blend_mode,
                                        shader,
                                        z, m_painter_state_location,
-                                       call_back);
+                                       call_back, shader_group);
+          if (reorder_enabled())
+            {
+              pending = &add_pending_draw(shader_group, clip_min, clip_max);
+            }
+          else
+            {
+              cmd.shader_group(shader_group, m_packing_stats);
+            }
         }
 
       /* copy attribute data and get offset into attribute buffer
@@ -951,9 +1322,21 @@ draw_generic_implement(const fastuidraw::reference_counted_ptr<fastuidraw::Paint
        */
       fastuidraw::c_array<fastuidraw::PainterIndex> index_dst_ptr;
 
-      index_dst_ptr = cmd.m_draw_command->m_indices.sub_array(cmd.m_indices_written, num_indices);
-      src.write_indices(index_dst_ptr, attrib_offset, chunk);
-      cmd.m_indices_written += index_dst_ptr.size();
+      if (pending)
+        {
+          unsigned int sz(pending->m_indices.size());
+
+          pending->m_indices.resize(sz + num_indices);
+          index_dst_ptr = fastuidraw::make_c_array(pending->m_indices).sub_array(sz, num_indices);
+          src.write_indices(index_dst_ptr, attrib_offset, chunk);
+          cmd.m_indices_pending += index_dst_ptr.size();
+        }
+      else
+        {
+          index_dst_ptr = cmd.m_draw_command->m_indices.sub_array(cmd.m_indices_written, num_indices);
+          src.write_indices(index_dst_ptr, attrib_offset, chunk);
+          cmd.m_indices_written += index_dst_ptr.size();
+        }
     }
 }
 
@@ -1025,6 +1408,7 @@ begin(const reference_counted_ptr<PainterBackend::Surface> &surface,
   d->m_backend->image_atlas()->delay_tile_freeing();
   d->m_backend->colorstop_atlas()->delay_interval_freeing();
   std::fill(d->m_stats.begin(), d->m_stats.end(), 0u);
+  d->m_packing_stats.reset();
   d->m_surface = surface;
   d->m_clear_color_buffer = clear_color_buffer;
   d->start_new_command();
@@ -1043,13 +1427,22 @@ query_stat(enum stats_t st) const
     {
       per_draw_command &c(d->m_accumulated_draws.back());
       tmp[num_attributes] = c.m_attributes_written;
-      tmp[num_indices] = c.m_indices_written;
+      tmp[num_indices] = c.m_indices_written + c.m_indices_pending;
       tmp[num_generic_datas] = c.store_written();
       tmp[num_draws] = 1u;
     }
   return d->m_stats[st] + tmp[st];
 }
 
+const fastuidraw::PainterPackingStats&
+fastuidraw::PainterPacker::
+packing_stats(void) const
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  return d->m_packing_stats;
+}
+
 void
 fastuidraw::PainterPacker::
 end(void)
@@ -1058,16 +1451,10 @@ end(void)
   d = static_cast<PainterPackerPrivate*>(m_d);
   if (!d->m_accumulated_draws.empty())
     {
-      per_draw_command &c(d->m_accumulated_draws.back());
-
-      d->m_stats[fastuidraw::PainterPacker::num_attributes] += c.m_attributes_written;
-      d->m_stats[fastuidraw::PainterPacker::num_indices] += c.m_indices_written;
-      d->m_stats[fastuidraw::PainterPacker::num_generic_datas] += c.store_written();
-      d->m_stats[fastuidraw::PainterPacker::num_draws] += 1u;
-
-      c.unmap();
+      d->unmap_current_command();
     }
 
+  d->m_backend->packing_stats(d->m_packing_stats);
   d->m_backend->on_pre_draw(d->m_surface, d->m_clear_color_buffer);
   for(per_draw_command &cmd : d->m_accumulated_draws)
     {
@@ -1087,7 +1474,8 @@ draw_break(const reference_counted_ptr<const PainterDraw::Action> &action)
 {
   PainterPackerPrivate *d;
   d = static_cast<PainterPackerPrivate*>(m_d);
-  d->m_accumulated_draws.back().draw_break(action);
+  d->flush_pending_draws();
+  d->m_accumulated_draws.back().draw_break(action, d->m_packing_stats);
 }
 
 void
@@ -1119,6 +1507,7 @@ draw_generic(const reference_counted_ptr<PainterItemShader> &shader,
   PainterPackerPrivate *d;
   d = static_cast<PainterPackerPrivate*>(m_d);
 
+  packing_timer timer(d->m_packing_stats.m_packing_time_ns);
   AttributeIndexSrcFromArray src(attrib_chunks, index_chunks, index_adjusts, attrib_chunk_selector);
   d->draw_generic_implement(shader, draw, src, z, call_back);
 }
@@ -1133,6 +1522,8 @@ draw_generic(const reference_counted_ptr<PainterItemShader> &shader,
 {
   PainterPackerPrivate *d;
   d = static_cast<PainterPackerPrivate*>(m_d);
+
+  packing_timer timer(d->m_packing_stats.m_packing_time_ns);
   d->draw_generic_implement(shader, data, src, z, call_back);
 }
 
@@ -0,0 +1,92 @@
+/*!
+ * \file painter_packing_stats.cpp
+ * \brief file painter_packing_stats.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <algorithm>
+#include <fastuidraw/painter/packing/painter_packing_stats.hpp>
+#include "../../private/util_private.hpp"
+
+///////////////////////////////////////
+// fastuidraw::PainterPackingStats methods
+fastuidraw::PainterPackingStats::
+PainterPackingStats(void)
+{
+  reset();
+}
+
+void
+fastuidraw::PainterPackingStats::
+reset(void)
+{
+  std::fill(m_break_counts.begin(), m_break_counts.end(), 0u);
+  for(auto &h : m_fill_histogram)
+    {
+      std::fill(h.begin(), h.end(), 0u);
+    }
+  m_number_draws = 0;
+  m_packing_time_ns = 0;
+}
+
+void
+fastuidraw::PainterPackingStats::
+record_fill(enum buffer_t b, unsigned int written, unsigned int size)
+{
+  unsigned int bin;
+
+  FASTUIDRAWassert(b < number_buffers);
+  FASTUIDRAWassert(written <= size);
+  bin = (size > 0u) ?
+    (number_histogram_bins * written) / size :
+    number_histogram_bins - 1;
+  bin = t_min(bin, static_cast<unsigned int>(number_histogram_bins - 1));
+  ++m_fill_histogram[b][bin];
+}
+
+const char*
+fastuidraw::PainterPackingStats::
+label(enum break_reason_t r)
+{
+  static const char *labels[number_break_reasons] =
+    {
+      "item_shader_change",
+      "blend_change",
+      "brush_mask_change",
+      "attributes_full",
+      "indices_full",
+      "store_full",
+      "draw_break_action",
+      "barrier_action",
+    };
+
+  FASTUIDRAWassert(r < number_break_reasons);
+  return labels[r];
+}
+
+const char*
+fastuidraw::PainterPackingStats::
+label(enum buffer_t b)
+{
+  static const char *labels[number_buffers] =
+    {
+      "attributes",
+      "indices",
+      "store",
+    };
+
+  FASTUIDRAWassert(b < number_buffers);
+  return labels[b];
+}
@@ -508,14 +508,36 @@ namespace
     std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PainterDraw::DelayedAction> > m_set_occluder_z;
   };
 
+  /* A state_stack_entry is copy-on-write: Painter::save() only
+   * records the occluder stack position and each of the other
+   * values is copied into the entry the first time it is modified
+   * while the entry is the top of the stack. Thus a save()/restore()
+   * pair that does not modify anything is O(1).
+   */
   class state_stack_entry
   {
   public:
+    enum saved_state_t
+      {
+        saved_clip_rect_state,
+        saved_clip_store,
+        saved_blend,
+        saved_curve_flatness,
+
+        number_saved_states
+      };
+
+    void
+    reset(unsigned int occluder_stack_position)
+    {
+      m_occluder_stack_position = occluder_stack_position;
+      m_saved.reset();
+    }
+
     unsigned int m_occluder_stack_position;
+    std::bitset<number_saved_states> m_saved;
     fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader> m_blend;
     fastuidraw::BlendMode::packed_value m_blend_mode;
-    fastuidraw::range_type<unsigned int> m_clip_equation_series;
-
     clip_rect_state m_clip_rect_state;
     float m_curve_flatness;
   };
@@ -656,6 +678,54 @@ namespace
     std::vector<int> m_fill_aa_fuzz_start_zs;
     std::vector<int> m_fill_aa_fuzz_z_increments;
 
+    // work room for glyph runs
+    fastuidraw::PainterGlyphRun::ScratchSpace m_glyph_run_scratch;
+    std::vector<unsigned int> m_glyph_chunk_selector;
+  };
+
+  class PainterClipPrivate
+  {
+  public:
+    PainterClipPrivate(void):
+      m_mode(fastuidraw::PainterClip::clip_in),
+      m_fill_rule(fastuidraw::PainterEnums::nonzero_fill_rule),
+      m_painter(nullptr),
+      m_number_selections(0),
+      m_selected(false)
+    {}
+
+    /* returns true if the occluder chunks need to be selected
+     * again for the passed transformation and clip equations.
+     */
+    bool
+    selection_dirty(const fastuidraw::float3x3 &matrix,
+                    fastuidraw::c_array<const fastuidraw::vec3> clip_equations) const;
+
+    enum fastuidraw::PainterClip::clip_mode_t m_mode;
+    enum fastuidraw::PainterEnums::fill_rule_t m_fill_rule;
+    const fastuidraw::Painter *m_painter;
+
+    /* the path is kept (copying a Path shares its contours and
+     * tessellations) so that a finer tessellation can be fetched
+     * when the transformation magnifies the path more than when
+     * m_tessellation was selected.
+     */
+    fastuidraw::Path m_path;
+    fastuidraw::reference_counted_ptr<const fastuidraw::TessellatedPath> m_tessellation;
+    fastuidraw::vec2 m_bb_min, m_bb_max;
+    unsigned int m_number_selections;
+
+    /* transformation and clip equations against which
+     * the occluder chunks were selected.
+     */
+    bool m_selected;
+    fastuidraw::float3x3 m_matrix;
+    std::vector<fastuidraw::vec3> m_clip_equations;
+
+    /* occluder chunks */
+    std::vector<fastuidraw::c_array<const fastuidraw::PainterAttribute> > m_attrib_chunks;
+    std::vector<fastuidraw::c_array<const fastuidraw::PainterIndex> > m_index_chunks;
+    std::vector<int> m_index_adjusts;
   };
 
   class PainterPrivate
@@ -704,6 +774,30 @@ namespace
     update_clip_equation_series(const fastuidraw::vec2 &pmin,
                                 const fastuidraw::vec2 &pmax);
 
+    /* Each of the save_ methods copies the named value into the
+     * top of the state stack if it has not yet been saved there;
+     * they must be called before the value is modified.
+     */
+    void
+    save_clip_rect_state(void);
+
+    void
+    save_clip_store(void);
+
+    void
+    save_blend(void);
+
+    void
+    save_curve_flatness(void);
+
+    state_stack_entry*
+    state_stack_top(void)
+    {
+      return (m_state_stack_size > 0u) ?
+        &m_state_stack[m_state_stack_size - 1u] :
+        nullptr;
+    }
+
     float
     compute_path_magnification(const fastuidraw::Path &path);
 
@@ -722,6 +816,22 @@ namespace
     const fastuidraw::FilledPath&
     select_filled_path(const fastuidraw::Path &path);
 
+    fastuidraw::reference_counted_ptr<const fastuidraw::TessellatedPath>
+    select_fill_tessellation(const fastuidraw::Path &path);
+
+    /* selects the subsets of filled_path against the current
+     * clip equations and transformation and appends the chunks
+     * for the fill rule to the passed arrays; the return value
+     * is the list of subsets selected which is backed by
+     * m_work_room.m_fill_subset_selector.
+     */
+    fastuidraw::c_array<const unsigned int>
+    select_fill_chunks(const fastuidraw::FilledPath &filled_path,
+                       enum fastuidraw::PainterEnums::fill_rule_t fill_rule,
+                       std::vector<fastuidraw::c_array<const fastuidraw::PainterAttribute> > &attrib_chunks,
+                       std::vector<fastuidraw::c_array<const fastuidraw::PainterIndex> > &index_chunks,
+                       std::vector<int> &index_adjusts);
+
     fastuidraw::vec2 m_resolution;
     fastuidraw::vec2 m_one_pixel_width;
     float m_curve_flatness;
@@ -729,6 +839,7 @@ namespace
     clip_rect_state m_clip_rect_state;
     std::vector<occluder_stack_entry> m_occluder_stack;
     std::vector<state_stack_entry> m_state_stack;
+    unsigned int m_state_stack_size;
     fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker> m_core;
     fastuidraw::PainterPackedValuePool m_pool;
     fastuidraw::PainterPackedValue<fastuidraw::PainterBrush> m_reset_brush, m_black_brush;
@@ -994,6 +1105,20 @@ clip_against_current(const fastuidraw::float3x3 &clip_matrix_local,
   return src;
 }
 
+//////////////////////////////////
+// PainterClipPrivate methods
+bool
+PainterClipPrivate::
+selection_dirty(const fastuidraw::float3x3 &matrix,
+                fastuidraw::c_array<const fastuidraw::vec3> clip_equations) const
+{
+  return !m_selected
+    || m_matrix.raw_data() != matrix.raw_data()
+    || m_clip_equations.size() != clip_equations.size()
+    || !std::equal(clip_equations.begin(), clip_equations.end(),
+                   m_clip_equations.begin());
+}
+
 //////////////////////////////////
 // PainterPrivate methods
 PainterPrivate::
@@ -1001,6 +1126,7 @@ PainterPrivate(fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend> bac
   m_resolution(1.0f, 1.0f),
   m_one_pixel_width(1.0f, 1.0f),
   m_curve_flatness(1.0f),
+  m_state_stack_size(0),
   m_pool(backend->configuration_base().alignment())
 {
   m_core = FASTUIDRAWnew fastuidraw::PainterPacker(backend);
@@ -1013,6 +1139,55 @@ PainterPrivate(fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend> bac
   m_max_indices_per_block = backend->indices_per_mapping();
 }
 
+void
+PainterPrivate::
+save_clip_rect_state(void)
+{
+  state_stack_entry *st(state_stack_top());
+  if (st && !st->m_saved[state_stack_entry::saved_clip_rect_state])
+    {
+      st->m_clip_rect_state = m_clip_rect_state;
+      st->m_saved[state_stack_entry::saved_clip_rect_state] = true;
+    }
+}
+
+void
+PainterPrivate::
+save_clip_store(void)
+{
+  state_stack_entry *st(state_stack_top());
+  if (st && !st->m_saved[state_stack_entry::saved_clip_store])
+    {
+      m_clip_store.push();
+      st->m_saved[state_stack_entry::saved_clip_store] = true;
+    }
+}
+
+void
+PainterPrivate::
+save_blend(void)
+{
+  state_stack_entry *st(state_stack_top());
+  if (st && !st->m_saved[state_stack_entry::saved_blend])
+    {
+      st->m_blend = m_core->blend_shader();
+      st->m_blend_mode = m_core->blend_mode();
+      st->m_saved[state_stack_entry::saved_blend] = true;
+    }
+}
+
+void
+PainterPrivate::
+save_curve_flatness(void)
+{
+  state_stack_entry *st(state_stack_top());
+  if (st && !st->m_saved[state_stack_entry::saved_curve_flatness])
+    {
+      st->m_curve_flatness = m_curve_flatness;
+      st->m_saved[state_stack_entry::saved_curve_flatness] = true;
+    }
+}
+
 bool
 PainterPrivate::
 update_clip_equation_series(const fastuidraw::vec2 &pmin,
@@ -1247,16 +1422,60 @@ select_stroked_path(const fastuidraw::Path &path,
   return tess->stroked().get();
 }
 
-const fastuidraw::FilledPath&
+fastuidraw::reference_counted_ptr<const fastuidraw::TessellatedPath>
 PainterPrivate::
-select_filled_path(const fastuidraw::Path &path)
+select_fill_tessellation(const fastuidraw::Path &path)
 {
   using namespace fastuidraw;
   float mag, thresh;
 
   mag = compute_path_magnification(path);
   thresh = m_curve_flatness / mag;
-  return *path.tessellation(thresh, TessellatedPath::threshhold_curve_distance)->filled();
+  return path.tessellation(thresh, TessellatedPath::threshhold_curve_distance);
+}
+
+const fastuidraw::FilledPath&
+PainterPrivate::
+select_filled_path(const fastuidraw::Path &path)
+{
+  return *select_fill_tessellation(path)->filled();
+}
+
+fastuidraw::c_array<const unsigned int>
+PainterPrivate::
+select_fill_chunks(const fastuidraw::FilledPath &filled_path,
+                   enum fastuidraw::PainterEnums::fill_rule_t fill_rule,
+                   std::vector<fastuidraw::c_array<const fastuidraw::PainterAttribute> > &attrib_chunks,
+                   std::vector<fastuidraw::c_array<const fastuidraw::PainterIndex> > &index_chunks,
+                   std::vector<int> &index_adjusts)
+{
+  using namespace fastuidraw;
+  unsigned int idx_chunk, atr_chunk, num_subsets;
+  c_array<const unsigned int> subset_list;
+
+  idx_chunk = FilledPath::Subset::fill_chunk_from_fill_rule(fill_rule);
+  atr_chunk = 0;
+
+  m_work_room.m_fill_subset_selector.resize(filled_path.number_subsets());
+  num_subsets = filled_path.select_subsets(m_work_room.m_filled_path_scratch,
+                                           m_clip_store.current(),
+                                           m_clip_rect_state.item_matrix(),
+                                           m_max_attribs_per_block,
+                                           m_max_indices_per_block,
+                                           make_c_array(m_work_room.m_fill_subset_selector));
+
+  subset_list = make_c_array(m_work_room.m_fill_subset_selector).sub_array(0, num_subsets);
+  for(unsigned int s : subset_list)
+    {
+      FilledPath::Subset subset(filled_path.subset(s));
+      const PainterAttributeData &data(subset.painter_data());
+
+      attrib_chunks.push_back(data.attribute_data_chunk(atr_chunk));
+      index_chunks.push_back(data.index_data_chunk(idx_chunk));
+      index_adjusts.push_back(data.index_adjust_chunk(idx_chunk));
+    }
+
+  return subset_list;
 }
 
 void
@@ -1367,6 +1586,50 @@ draw_generic_z_layered(const fastuidraw::reference_counted_ptr<fastuidraw::Paint
     }
 }
 
+//////////////////////////////////
+// fastuidraw::PainterClip methods
+fastuidraw::PainterClip::
+PainterClip(void)
+{
+  m_d = FASTUIDRAWnew PainterClipPrivate();
+}
+
+fastuidraw::PainterClip::
+~PainterClip()
+{
+  PainterClipPrivate *d;
+  d = static_cast<PainterClipPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+enum fastuidraw::PainterClip::clip_mode_t
+fastuidraw::PainterClip::
+clip_mode(void) const
+{
+  PainterClipPrivate *d;
+  d = static_cast<PainterClipPrivate*>(m_d);
+  return d->m_mode;
+}
+
+enum fastuidraw::PainterEnums::fill_rule_t
+fastuidraw::PainterClip::
+fill_rule(void) const
+{
+  PainterClipPrivate *d;
+  d = static_cast<PainterClipPrivate*>(m_d);
+  return d->m_fill_rule;
+}
+
+unsigned int
+fastuidraw::PainterClip::
+number_selections(void) const
+{
+  PainterClipPrivate *d;
+  d = static_cast<PainterClipPrivate*>(m_d);
+  return d->m_number_selections;
+}
+
 //////////////////////////////////
 // fastuidraw::Painter methods
 fastuidraw::Painter::
@@ -1428,7 +1691,11 @@ end(void)
     }
   /* clear state stack as well. */
   d->m_clip_store.clear();
-  d->m_state_stack.clear();
+  for(unsigned int i = 0; i < d->m_state_stack_size; ++i)
+    {
+      d->m_state_stack[i].m_blend = reference_counted_ptr<PainterBlendShader>();
+    }
+  d->m_state_stack_size = 0;
   d->m_core->end();
 }
 
@@ -2031,7 +2298,7 @@ fill_path(const PainterFillShader &shader, const PainterData &draw,
           const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
   PainterPrivate *d;
-  unsigned int idx_chunk, atr_chunk, num_subsets, incr_z;
+  unsigned int incr_z;
 
   d = static_cast<PainterPrivate*>(m_d);
   if (d->m_clip_rect_state.m_all_content_culled)
@@ -2039,36 +2306,18 @@ fill_path(const PainterFillShader &shader, const PainterData &draw,
       return;
     }
 
-  idx_chunk = FilledPath::Subset::fill_chunk_from_fill_rule(fill_rule);
-  atr_chunk = 0;
-
-  d->m_work_room.m_fill_subset_selector.resize(filled_path.number_subsets());
-  num_subsets = filled_path.select_subsets(d->m_work_room.m_filled_path_scratch,
-                                           d->m_clip_store.current(),
-                                           d->m_clip_rect_state.item_matrix(),
-                                           d->m_max_attribs_per_block,
-                                           d->m_max_indices_per_block,
-                                           make_c_array(d->m_work_room.m_fill_subset_selector));
-
-  if (num_subsets == 0)
-    {
-      return;
-    }
-
   fastuidraw::c_array<const unsigned int> subset_list;
-  subset_list = make_c_array(d->m_work_room.m_fill_subset_selector).sub_array(0, num_subsets);
 
   d->m_work_room.m_fill_attrib_chunks.clear();
   d->m_work_room.m_fill_index_chunks.clear();
   d->m_work_room.m_fill_index_adjusts.clear();
-  for(unsigned int s : subset_list)
+  subset_list = d->select_fill_chunks(filled_path, fill_rule,
+                                      d->m_work_room.m_fill_attrib_chunks,
+                                      d->m_work_room.m_fill_index_chunks,
+                                      d->m_work_room.m_fill_index_adjusts);
+  if (subset_list.empty())
     {
-      FilledPath::Subset subset(filled_path.subset(s));
-      const PainterAttributeData &data(subset.painter_data());
-
-      d->m_work_room.m_fill_attrib_chunks.push_back(data.attribute_data_chunk(atr_chunk));
-      d->m_work_room.m_fill_index_chunks.push_back(data.index_data_chunk(idx_chunk));
-      d->m_work_room.m_fill_index_adjusts.push_back(data.index_adjust_chunk(idx_chunk));
+      return;
     }
 
   if (with_anti_aliasing)
@@ -2315,6 +2564,65 @@ draw_glyphs(const PainterData &draw,
     }
 }
 
+void
+fastuidraw::Painter::
+draw_glyphs(const PainterGlyphShader &shader, const PainterData &pdraw,
+            const PainterGlyphRun &run,
+            const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  PainterPrivate *d;
+  unsigned int num_chunks;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  if (d->m_clip_rect_state.m_all_content_culled)
+    {
+      return;
+    }
+
+  d->m_work_room.m_glyph_chunk_selector.resize(run.number_chunks());
+  num_chunks = run.select_chunks(d->m_work_room.m_glyph_run_scratch,
+                                 d->m_clip_store.current(),
+                                 d->m_clip_rect_state.item_matrix(),
+                                 make_c_array(d->m_work_room.m_glyph_chunk_selector));
+  if (num_chunks == 0)
+    {
+      return;
+    }
+
+  /* the PainterData is used for each chunk, make it
+   * packed so that it is not packed again for each.
+   */
+  PainterData draw(pdraw);
+  if (num_chunks > 1)
+    {
+      draw.make_packed(d->m_pool);
+    }
+
+  for(unsigned int i = 0; i < num_chunks; ++i)
+    {
+      unsigned int k(d->m_work_room.m_glyph_chunk_selector[i]);
+
+      run.update_chunk(k);
+      draw_glyphs(shader, draw, run.chunk_data(k), call_back);
+    }
+}
+
+void
+fastuidraw::Painter::
+draw_glyphs(const PainterData &draw,
+            const PainterGlyphRun &run, bool use_anistopic_antialias,
+            const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  if (use_anistopic_antialias)
+    {
+      draw_glyphs(default_shaders().glyph_shader_anisotropic(), draw, run, call_back);
+    }
+  else
+    {
+      draw_glyphs(default_shaders().glyph_shader(), draw, run, call_back);
+    }
+}
+
 const fastuidraw::PainterItemMatrix&
 fastuidraw::Painter::
 transformation(void)
@@ -2330,6 +2638,7 @@ transformation(const float3x3 &m)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_clip_rect_state();
   d->m_clip_rect_state.item_matrix(m, true);
 }
 
@@ -2348,6 +2657,7 @@ transformation_state(const PainterPackedValue<PainterItemMatrix> &h)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_clip_rect_state();
   d->m_clip_rect_state.item_matrix_state(h, true);
 }
 
@@ -2365,6 +2675,7 @@ concat(const float3x3 &tr)
             || tr(2, 0) != 0.0f || tr(2, 1) != 0.0f
             || tr(2, 2) != 1.0f);
 
+  d->save_clip_rect_state();
   m = d->m_clip_rect_state.item_matrix() * tr;
   d->m_clip_rect_state.item_matrix(m, tricky);
 
@@ -2382,6 +2693,7 @@ translate(const vec2 &p)
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
+  d->save_clip_rect_state();
   float3x3 m(d->m_clip_rect_state.item_matrix());
   m.translate(p.x(), p.y());
   d->m_clip_rect_state.item_matrix(m, false);
@@ -2395,6 +2707,7 @@ scale(float s)
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
+  d->save_clip_rect_state();
   float3x3 m(d->m_clip_rect_state.item_matrix());
   m.scale(s);
   d->m_clip_rect_state.item_matrix(m, false);
@@ -2408,6 +2721,7 @@ shear(float sx, float sy)
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
+  d->save_clip_rect_state();
   float3x3 m(d->m_clip_rect_state.item_matrix());
   m.shear(sx, sy);
   d->m_clip_rect_state.item_matrix(m, false);
@@ -2433,6 +2747,7 @@ rotate(float angle)
   tr(0, 1) = -s;
   tr(1, 1) = c;
 
+  d->save_clip_rect_state();
   float3x3 m(d->m_clip_rect_state.item_matrix());
   m = m * tr;
   d->m_clip_rect_state.item_matrix(m, true);
@@ -2444,6 +2759,7 @@ curveFlatness(float thresh)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_curve_flatness();
   d->m_curve_flatness = thresh;
 }
 
@@ -2463,15 +2779,16 @@ save(void)
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
-  state_stack_entry st;
-  st.m_occluder_stack_position = d->m_occluder_stack.size();
-  st.m_blend = d->m_core->blend_shader();
-  st.m_blend_mode = d->m_core->blend_mode();
-  st.m_clip_rect_state = d->m_clip_rect_state;
-  st.m_curve_flatness = d->m_curve_flatness;
-
-  d->m_state_stack.push_back(st);
-  d->m_clip_store.push();
+  /* the values of the state are only copied to the
+   * stack entry when they are first modified, see
+   * PainterPrivate::save_clip_rect_state() and friends.
+   */
+  if (d->m_state_stack_size == d->m_state_stack.size())
+    {
+      d->m_state_stack.push_back(state_stack_entry());
+    }
+  d->m_state_stack[d->m_state_stack_size].reset(d->m_occluder_stack.size());
+  ++d->m_state_stack_size;
 }
 
 void
@@ -2481,19 +2798,36 @@ restore(void)
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
-  FASTUIDRAWassert(!d->m_state_stack.empty());
-  const state_stack_entry &st(d->m_state_stack.back());
+  FASTUIDRAWassert(d->m_state_stack_size > 0u);
+  state_stack_entry &st(d->m_state_stack[d->m_state_stack_size - 1u]);
+
+  if (st.m_saved[state_stack_entry::saved_clip_rect_state])
+    {
+      d->m_clip_rect_state = st.m_clip_rect_state;
+    }
+
+  if (st.m_saved[state_stack_entry::saved_clip_store])
+    {
+      d->m_clip_store.pop();
+    }
+
+  if (st.m_saved[state_stack_entry::saved_blend])
+    {
+      d->m_core->blend_shader(st.m_blend, st.m_blend_mode);
+      st.m_blend = reference_counted_ptr<PainterBlendShader>();
+    }
+
+  if (st.m_saved[state_stack_entry::saved_curve_flatness])
+    {
+      d->m_curve_flatness = st.m_curve_flatness;
+    }
 
-  d->m_clip_rect_state = st.m_clip_rect_state;
-  d->m_core->blend_shader(st.m_blend, st.m_blend_mode);
-  d->m_curve_flatness = st.m_curve_flatness;
   while(d->m_occluder_stack.size() > st.m_occluder_stack_position)
     {
       d->m_occluder_stack.back().on_pop(this);
       d->m_occluder_stack.pop_back();
     }
-  d->m_state_stack.pop_back();
-  d->m_clip_store.pop();
+  --d->m_state_stack_size;
 }
 
 /* How we handle clipping.
@@ -2631,6 +2965,128 @@ clipInPath(const Path &path, const CustomFillRuleBase &fill_rule)
   clipOutPath(path, ComplementFillRule(&fill_rule));
 }
 
+fastuidraw::reference_counted_ptr<fastuidraw::PainterClip>
+fastuidraw::Painter::
+make_clip(const Path &path, enum PainterEnums::fill_rule_t fill_rule,
+          enum PainterClip::clip_mode_t mode)
+{
+  PainterPrivate *d;
+  PainterClipPrivate *c;
+  reference_counted_ptr<PainterClip> return_value;
+
+  d = static_cast<PainterPrivate*>(m_d);
+  return_value = FASTUIDRAWnew PainterClip();
+  c = static_cast<PainterClipPrivate*>(return_value->m_d);
+
+  c->m_mode = mode;
+  c->m_fill_rule = fill_rule;
+  c->m_painter = this;
+  c->m_path = path;
+  c->m_tessellation = d->select_fill_tessellation(path);
+  c->m_bb_min = path.tessellation()->bounding_box_min();
+  c->m_bb_max = path.tessellation()->bounding_box_max();
+
+  return return_value;
+}
+
+void
+fastuidraw::Painter::
+applyClip(const reference_counted_ptr<PainterClip> &clip)
+{
+  PainterPrivate *d;
+  PainterClipPrivate *c;
+
+  d = static_cast<PainterPrivate*>(m_d);
+  FASTUIDRAWassert(clip);
+  c = static_cast<PainterClipPrivate*>(clip->m_d);
+  FASTUIDRAWassert(c->m_painter == this);
+
+  if (d->m_clip_rect_state.m_all_content_culled)
+    {
+      /* everything is clipped anyways, adding more clipping does not matter
+       */
+      return;
+    }
+
+  if (c->m_mode == PainterClip::clip_in)
+    {
+      clipInRect(c->m_bb_min, c->m_bb_max - c->m_bb_min);
+      if (d->m_clip_rect_state.m_all_content_culled)
+        {
+          return;
+        }
+    }
+
+  /* the tessellation needs to be finer if the curve distance
+   * it achieves is more than what the curve flatness requires
+   * under the current transformation; a coarser requirement
+   * keeps the finer tessellation.
+   */
+  float thresh;
+
+  thresh = d->m_curve_flatness / d->compute_path_magnification(c->m_path);
+  if (c->m_tessellation->effective_threshhold(TessellatedPath::threshhold_curve_distance) > thresh)
+    {
+      reference_counted_ptr<const TessellatedPath> tess;
+
+      tess = c->m_path.tessellation(thresh, TessellatedPath::threshhold_curve_distance);
+      if (tess != c->m_tessellation)
+        {
+          c->m_tessellation = tess;
+          c->m_selected = false;
+        }
+    }
+
+  /* only select the occluder chunks again if the tessellation,
+   * transformation or clip equations changed since the last
+   * selection.
+   */
+  if (c->selection_dirty(d->m_clip_rect_state.item_matrix(), d->m_clip_store.current()))
+    {
+      enum PainterEnums::fill_rule_t occluder_fill_rule;
+      c_array<const vec3> clip_equations(d->m_clip_store.current());
+
+      occluder_fill_rule = (c->m_mode == PainterClip::clip_in) ?
+        PainterEnums::complement_fill_rule(c->m_fill_rule) :
+        c->m_fill_rule;
+
+      c->m_attrib_chunks.clear();
+      c->m_index_chunks.clear();
+      c->m_index_adjusts.clear();
+      d->select_fill_chunks(*c->m_tessellation->filled(), occluder_fill_rule,
+                            c->m_attrib_chunks, c->m_index_chunks, c->m_index_adjusts);
+
+      c->m_matrix = d->m_clip_rect_state.item_matrix();
+      c->m_clip_equations.resize(clip_equations.size());
+      std::copy(clip_equations.begin(), clip_equations.end(), c->m_clip_equations.begin());
+      c->m_selected = true;
+      ++c->m_number_selections;
+    }
+
+  reference_counted_ptr<PainterBlendShader> old_blend;
+  BlendMode::packed_value old_blend_mode;
+  reference_counted_ptr<ZDataCallBack> zdatacallback;
+
+  zdatacallback = FASTUIDRAWnew ZDataCallBack();
+  if (!c->m_index_chunks.empty())
+    {
+      old_blend = blend_shader();
+      old_blend_mode = blend_mode();
+
+      blend_shader(PainterEnums::blend_porter_duff_dst);
+      d->draw_generic(default_shaders().fill_shader().item_shader(),
+                      PainterData(d->m_black_brush),
+                      make_c_array(c->m_attrib_chunks),
+                      make_c_array(c->m_index_chunks),
+                      make_c_array(c->m_index_adjusts),
+                      c_array<const unsigned int>(),
+                      d->m_current_z, zdatacallback);
+      blend_shader(old_blend, old_blend_mode);
+    }
+
+  d->m_occluder_stack.push_back(occluder_stack_entry(zdatacallback->m_actions));
+}
+
 void
 fastuidraw::Painter::
 clipInRect(const vec2 &pmin, const vec2 &wh)
@@ -2640,6 +3096,8 @@ clipInRect(const vec2 &pmin, const vec2 &wh)
 
   vec2 pmax(pmin + wh);
 
+  d->save_clip_rect_state();
+  d->save_clip_store();
   d->m_clip_rect_state.m_all_content_culled =
     d->m_clip_rect_state.m_all_content_culled ||
     wh.x() <= 0.0f || wh.y() <= 0.0f ||
@@ -2824,6 +3282,7 @@ blend_shader(const fastuidraw::reference_counted_ptr<PainterBlendShader> &h,
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_blend();
   d->m_core->blend_shader(h, mode);
 }
 
@@ -2845,6 +3304,15 @@ query_stat(enum PainterPacker::stats_t st) const
   return d->m_core->query_stat(st);
 }
 
+const fastuidraw::PainterPackingStats&
+fastuidraw::Painter::
+packing_stats(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_core->packing_stats();
+}
+
 int
 fastuidraw::Painter::
 current_z(void) const
@@ -137,9 +137,25 @@ namespace
     fastuidraw::c_array<const float> m_scale_factors;
     enum fastuidraw::PainterEnums::glyph_orientation m_orientation;
     std::pair<bool, float> m_render_pixel_size;
+    /* index of the first glyph that cannot be uploaded */
     unsigned int m_number_glyphs;
+
+    /* number of glyphs before m_number_glyphs that are drawn,
+     * i.e. that are valid and not pending.
+     */
+    unsigned int m_number_drawn;
+
+    /* number of glyphs before m_number_glyphs that are pending */
+    unsigned int m_number_pending;
     std::vector<unsigned int> m_cnt_by_type;
   };
+
+  inline
+  bool
+  glyph_is_drawn(const fastuidraw::Glyph &G)
+  {
+    return G.valid() && !G.pending();
+  }
 }
 
 //////////////////////////////////
@@ -154,7 +170,9 @@ FillGlyphsPrivate(fastuidraw::c_array<const fastuidraw::vec2> glyph_positions,
   m_scale_factors(scale_factors),
   m_orientation(orientation),
   m_render_pixel_size(false, 1.0f),
-  m_number_glyphs(0)
+  m_number_glyphs(0),
+  m_number_drawn(0),
+  m_number_pending(0)
 {
   FASTUIDRAWassert(glyph_positions.size() == glyphs.size());
   FASTUIDRAWassert(scale_factors.empty() || scale_factors.size() == glyphs.size());
@@ -169,7 +187,9 @@ FillGlyphsPrivate(fastuidraw::c_array<const fastuidraw::vec2> glyph_positions,
   m_glyphs(glyphs),
   m_orientation(orientation),
   m_render_pixel_size(true, render_pixel_size),
-  m_number_glyphs(0)
+  m_number_glyphs(0),
+  m_number_drawn(0),
+  m_number_pending(0)
 {
   FASTUIDRAWassert(glyph_positions.size() == glyphs.size());
 }
@@ -182,7 +202,9 @@ FillGlyphsPrivate(fastuidraw::c_array<const fastuidraw::vec2> glyph_positions,
   m_glyphs(glyphs),
   m_orientation(orientation),
   m_render_pixel_size(false, 1.0f),
-  m_number_glyphs(0)
+  m_number_glyphs(0),
+  m_number_drawn(0),
+  m_number_pending(0)
 {
   FASTUIDRAWassert(glyph_positions.size() == glyphs.size());
 }
@@ -191,18 +213,22 @@ void
 FillGlyphsPrivate::
 compute_number_glyphs(void)
 {
+  m_number_glyphs = 0;
+  m_number_drawn = 0;
+  m_number_pending = 0;
+  m_cnt_by_type.clear();
   for(const auto &G : m_glyphs)
     {
       enum fastuidraw::return_code R;
 
-      if (G.valid())
+      if (glyph_is_drawn(G))
         {
           R = G.upload_to_atlas();
           if (R != fastuidraw::routine_success)
             {
               return;
             }
-          ++m_number_glyphs;
+          ++m_number_drawn;
 
           if (m_cnt_by_type.size() <= G.type())
             {
@@ -210,6 +236,11 @@ compute_number_glyphs(void)
             }
           ++m_cnt_by_type[G.type()];
         }
+      else if (G.valid())
+        {
+          ++m_number_pending;
+        }
+      ++m_number_glyphs;
     }
 }
 
@@ -251,6 +282,24 @@ fastuidraw::PainterAttributeDataFillerGlyphs::
   m_d = nullptr;
 }
 
+unsigned int
+fastuidraw::PainterAttributeDataFillerGlyphs::
+number_glyphs(void) const
+{
+  FillGlyphsPrivate *d;
+  d = static_cast<FillGlyphsPrivate*>(m_d);
+  return d->m_number_glyphs;
+}
+
+unsigned int
+fastuidraw::PainterAttributeDataFillerGlyphs::
+number_pending_glyphs(void) const
+{
+  FillGlyphsPrivate *d;
+  d = static_cast<FillGlyphsPrivate*>(m_d);
+  return d->m_number_pending;
+}
+
 void
 fastuidraw::PainterAttributeDataFillerGlyphs::
 compute_sizes(unsigned int &number_attributes,
@@ -263,8 +312,8 @@ compute_sizes(unsigned int &number_attributes,
   d = static_cast<FillGlyphsPrivate*>(m_d);
 
   d->compute_number_glyphs();
-  number_attributes = 4 * d->m_number_glyphs;
-  number_indices = 6 * d->m_number_glyphs;
+  number_attributes = 4 * d->m_number_drawn;
+  number_indices = 6 * d->m_number_drawn;
   number_attribute_chunks = d->m_cnt_by_type.size();
   number_index_chunks = d->m_cnt_by_type.size();
   number_z_ranges = 0;
@@ -295,7 +344,7 @@ fill_data(c_array<PainterAttribute> attribute_data,
   std::vector<unsigned int> current(attrib_chunks.size(), 0);
   for(unsigned int g = 0; g < d->m_number_glyphs; ++g)
     {
-      if (d->m_glyphs[g].valid())
+      if (glyph_is_drawn(d->m_glyphs[g]))
         {
           float scale;
           unsigned int t;
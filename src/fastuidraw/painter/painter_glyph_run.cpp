@@ -0,0 +1,518 @@
+/*!
+ * \file painter_glyph_run.cpp
+ * \brief file painter_glyph_run.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <algorithm>
+#include <fastuidraw/painter/painter_glyph_run.hpp>
+#include <fastuidraw/painter/painter_attribute_data.hpp>
+#include <fastuidraw/painter/painter_attribute_data_filler_glyphs.hpp>
+#include "../private/util_private.hpp"
+#include "../private/bounding_box.hpp"
+#include "../private/clip.hpp"
+
+namespace
+{
+  class ScratchSpacePrivate
+  {
+  public:
+    std::vector<fastuidraw::vec3> m_adjusted_clip_eqs;
+    std::vector<fastuidraw::vec2> m_clipped_rect;
+
+    fastuidraw::vecN<std::vector<fastuidraw::vec2>, 2> m_clip_scratch_vec2s;
+    std::vector<float> m_clip_scratch_floats;
+  };
+
+  /* the location of a glyph in the GlyphAtlas when the
+   * attribute data of a chunk was filled.
+   */
+  class GlyphAtlasState
+  {
+  public:
+    explicit
+    GlyphAtlasState(const fastuidraw::Glyph &G)
+    {
+      if (G.valid() && !G.pending())
+        {
+          m_location[0] = G.atlas_location().location();
+          m_location[1] = G.secondary_atlas_location().location();
+          m_layer[0] = G.atlas_location().layer();
+          m_layer[1] = G.secondary_atlas_location().layer();
+          m_geometry_offset = G.geometry_offset();
+        }
+      else
+        {
+          m_location[0] = m_location[1] = fastuidraw::ivec2(-1, -1);
+          m_layer[0] = m_layer[1] = -1;
+          m_geometry_offset = -1;
+        }
+    }
+
+    bool
+    operator==(const GlyphAtlasState &rhs) const
+    {
+      return m_location[0] == rhs.m_location[0]
+        && m_location[1] == rhs.m_location[1]
+        && m_layer[0] == rhs.m_layer[0]
+        && m_layer[1] == rhs.m_layer[1]
+        && m_geometry_offset == rhs.m_geometry_offset;
+    }
+
+  private:
+    fastuidraw::vecN<fastuidraw::ivec2, 2> m_location;
+    fastuidraw::ivec2 m_layer;
+    int m_geometry_offset;
+  };
+
+  class GlyphChunk
+  {
+  public:
+    GlyphChunk(void):
+      m_data(FASTUIDRAWnew fastuidraw::PainterAttributeData()),
+      m_number_filled(0),
+      m_number_pending(0)
+    {}
+
+    /* the bounding box is computed from the positions
+     * of the attributes, see PainterAttributeDataFillerGlyphs
+     * for how the positions are packed.
+     */
+    void
+    compute_bounding_box(void);
+
+    /* uploads the glyphs of the chunk, which also marks them
+     * as used in the current frame of their GlyphCache, and
+     * returns true if a glyph is not at the atlas location
+     * with which the attribute data was filled or if not all
+     * glyphs were filled.
+     */
+    bool
+    atlas_changed(void) const;
+
+    fastuidraw::PainterAttributeData *m_data;
+    fastuidraw::BoundingBox<float> m_bounds;
+
+    /* the glyphs are kept so that the chunk can be
+     * filled again when the glyphs move in the atlas.
+     */
+    std::vector<fastuidraw::Glyph> m_glyphs;
+    std::vector<fastuidraw::vec2> m_positions;
+    std::vector<float> m_scale_factors;
+    std::vector<GlyphAtlasState> m_atlas_state;
+    unsigned int m_number_filled;
+
+    /* number of glyphs that were pending when filled */
+    unsigned int m_number_pending;
+  };
+
+  class PainterGlyphRunPrivate
+  {
+  public:
+    PainterGlyphRunPrivate(fastuidraw::c_array<const fastuidraw::vec2> glyph_positions,
+                           fastuidraw::c_array<const fastuidraw::Glyph> glyphs,
+                           fastuidraw::c_array<const float> scale_factors,
+                           float render_pixel_size,
+                           enum fastuidraw::PainterEnums::glyph_orientation orientation,
+                           unsigned int glyphs_per_chunk);
+
+    ~PainterGlyphRunPrivate();
+
+    /* fills the attribute data of a chunk from its glyphs */
+    void
+    fill_chunk(GlyphChunk &chunk);
+
+    /* recomputes m_bounds and m_number_glyphs from the chunks */
+    void
+    compute_totals(void);
+
+    /* returns true if the bounding box is completely clipped
+     * and sets unclipped to true if the bounding box is
+     * completely unclipped.
+     */
+    static
+    bool
+    bounds_clipped(ScratchSpacePrivate &scratch,
+                   const fastuidraw::BoundingBox<float> &bounds,
+                   bool *unclipped);
+
+    std::vector<GlyphChunk> m_chunks;
+    fastuidraw::BoundingBox<float> m_bounds;
+    unsigned int m_number_glyphs, m_number_pending;
+
+    /* if positive, the glyphs are scaled to the pixel
+     * size, otherwise by the scale factors of the chunks
+     */
+    float m_render_pixel_size;
+    enum fastuidraw::PainterEnums::glyph_orientation m_orientation;
+  };
+}
+
+/////////////////////////////////////
+// GlyphChunk methods
+void
+GlyphChunk::
+compute_bounding_box(void)
+{
+  using namespace fastuidraw;
+
+  c_array<const c_array<const PainterAttribute> > chunks;
+
+  chunks = m_data->attribute_data_chunks();
+  for(c_array<const PainterAttribute> chunk : chunks)
+    {
+      for(const PainterAttribute &attr : chunk)
+        {
+          m_bounds.union_point(vec2(unpack_float(attr.m_attrib1.x()),
+                                    unpack_float(attr.m_attrib1.y())));
+        }
+    }
+}
+
+bool
+GlyphChunk::
+atlas_changed(void) const
+{
+  bool return_value(m_number_filled < m_glyphs.size());
+
+  FASTUIDRAWassert(m_atlas_state.size() == m_glyphs.size());
+  for(unsigned int i = 0, endi = m_glyphs.size(); i < endi; ++i)
+    {
+      const fastuidraw::Glyph &g(m_glyphs[i]);
+
+      /* a glyph that was pending when the chunk was filled
+       * has an invalid GlyphAtlasState, so the chunk is filled
+       * again once the glyph is generated and uploaded.
+       */
+      if (g.valid() && !g.pending())
+        {
+          /* every glyph is uploaded, even after a change is
+           * found, so that all glyphs of the chunk are marked
+           * as used before any of them is filled again.
+           */
+          g.upload_to_atlas();
+          if (!(GlyphAtlasState(g) == m_atlas_state[i]))
+            {
+              return_value = true;
+            }
+        }
+    }
+  return return_value;
+}
+
+/////////////////////////////////////
+// PainterGlyphRunPrivate methods
+PainterGlyphRunPrivate::
+PainterGlyphRunPrivate(fastuidraw::c_array<const fastuidraw::vec2> glyph_positions,
+                       fastuidraw::c_array<const fastuidraw::Glyph> glyphs,
+                       fastuidraw::c_array<const float> scale_factors,
+                       float render_pixel_size,
+                       enum fastuidraw::PainterEnums::glyph_orientation orientation,
+                       unsigned int glyphs_per_chunk):
+  m_number_glyphs(0),
+  m_number_pending(0),
+  m_render_pixel_size(render_pixel_size),
+  m_orientation(orientation)
+{
+  using namespace fastuidraw;
+
+  FASTUIDRAWassert(glyph_positions.size() == glyphs.size());
+  FASTUIDRAWassert(scale_factors.empty() || scale_factors.size() == glyphs.size());
+
+  glyphs_per_chunk = t_max(1u, glyphs_per_chunk);
+  m_chunks.reserve(1 + glyphs.size() / glyphs_per_chunk);
+
+  for(unsigned int start = 0; start < glyphs.size(); start += glyphs_per_chunk)
+    {
+      unsigned int cnt;
+      c_array<const vec2> pos;
+      c_array<const Glyph> gl;
+
+      cnt = t_min(glyphs_per_chunk, static_cast<unsigned int>(glyphs.size()) - start);
+      pos = glyph_positions.sub_array(start, cnt);
+      gl = glyphs.sub_array(start, cnt);
+
+      m_chunks.push_back(GlyphChunk());
+      m_chunks.back().m_glyphs.assign(gl.begin(), gl.end());
+      m_chunks.back().m_positions.assign(pos.begin(), pos.end());
+      if (m_render_pixel_size <= 0.0f && !scale_factors.empty())
+        {
+          c_array<const float> sc(scale_factors.sub_array(start, cnt));
+          m_chunks.back().m_scale_factors.assign(sc.begin(), sc.end());
+        }
+      fill_chunk(m_chunks.back());
+    }
+  compute_totals();
+}
+
+PainterGlyphRunPrivate::
+~PainterGlyphRunPrivate()
+{
+  for(GlyphChunk &chunk : m_chunks)
+    {
+      FASTUIDRAWdelete(chunk.m_data);
+    }
+}
+
+void
+PainterGlyphRunPrivate::
+fill_chunk(GlyphChunk &chunk)
+{
+  using namespace fastuidraw;
+
+  c_array<const vec2> pos(make_c_array(chunk.m_positions));
+  c_array<const Glyph> gl(make_c_array(chunk.m_glyphs));
+
+  if (m_render_pixel_size > 0.0f)
+    {
+      PainterAttributeDataFillerGlyphs filler(pos, gl, m_render_pixel_size, m_orientation);
+      chunk.m_data->set_data(filler);
+      chunk.m_number_filled = filler.number_glyphs();
+      chunk.m_number_pending = filler.number_pending_glyphs();
+    }
+  else
+    {
+      PainterAttributeDataFillerGlyphs filler(pos, gl, make_c_array(chunk.m_scale_factors), m_orientation);
+      chunk.m_data->set_data(filler);
+      chunk.m_number_filled = filler.number_glyphs();
+      chunk.m_number_pending = filler.number_pending_glyphs();
+    }
+
+  /* filling uploads the glyphs, so the state of
+   * the atlas is taken after filling.
+   */
+  chunk.m_atlas_state.clear();
+  chunk.m_atlas_state.reserve(chunk.m_glyphs.size());
+  for(const Glyph &g : chunk.m_glyphs)
+    {
+      chunk.m_atlas_state.push_back(GlyphAtlasState(g));
+    }
+
+  chunk.m_bounds = BoundingBox<float>();
+  chunk.compute_bounding_box();
+}
+
+void
+PainterGlyphRunPrivate::
+compute_totals(void)
+{
+  m_bounds = fastuidraw::BoundingBox<float>();
+  m_number_glyphs = 0;
+  m_number_pending = 0;
+  for(const GlyphChunk &chunk : m_chunks)
+    {
+      m_bounds.union_box(chunk.m_bounds);
+      m_number_glyphs += chunk.m_number_filled;
+      m_number_pending += chunk.m_number_pending;
+    }
+}
+
+bool
+PainterGlyphRunPrivate::
+bounds_clipped(ScratchSpacePrivate &scratch,
+               const fastuidraw::BoundingBox<float> &bounds,
+               bool *unclipped)
+{
+  using namespace fastuidraw;
+  using namespace fastuidraw::detail;
+
+  vecN<vec2, 4> bb;
+
+  if (bounds.empty())
+    {
+      *unclipped = false;
+      return true;
+    }
+
+  bounds.inflated_polygon(bb, 0.0f);
+  *unclipped = clip_against_planes(make_c_array(scratch.m_adjusted_clip_eqs),
+                                   bb, scratch.m_clipped_rect,
+                                   scratch.m_clip_scratch_floats,
+                                   scratch.m_clip_scratch_vec2s);
+  return scratch.m_clipped_rect.empty();
+}
+
+/////////////////////////////////////
+// fastuidraw::PainterGlyphRun::ScratchSpace methods
+fastuidraw::PainterGlyphRun::ScratchSpace::
+ScratchSpace(void)
+{
+  m_d = FASTUIDRAWnew ScratchSpacePrivate();
+}
+
+fastuidraw::PainterGlyphRun::ScratchSpace::
+~ScratchSpace(void)
+{
+  ScratchSpacePrivate *d;
+  d = static_cast<ScratchSpacePrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+/////////////////////////////////////
+// fastuidraw::PainterGlyphRun methods
+fastuidraw::PainterGlyphRun::
+PainterGlyphRun(c_array<const vec2> glyph_positions,
+                c_array<const Glyph> glyphs,
+                c_array<const float> scale_factors,
+                enum PainterEnums::glyph_orientation orientation,
+                unsigned int glyphs_per_chunk)
+{
+  m_d = FASTUIDRAWnew PainterGlyphRunPrivate(glyph_positions, glyphs, scale_factors,
+                                             -1.0f, orientation, glyphs_per_chunk);
+}
+
+fastuidraw::PainterGlyphRun::
+PainterGlyphRun(c_array<const vec2> glyph_positions,
+                c_array<const Glyph> glyphs,
+                float render_pixel_size,
+                enum PainterEnums::glyph_orientation orientation,
+                unsigned int glyphs_per_chunk)
+{
+  FASTUIDRAWassert(render_pixel_size > 0.0f);
+  m_d = FASTUIDRAWnew PainterGlyphRunPrivate(glyph_positions, glyphs, c_array<const float>(),
+                                             render_pixel_size, orientation, glyphs_per_chunk);
+}
+
+fastuidraw::PainterGlyphRun::
+~PainterGlyphRun()
+{
+  PainterGlyphRunPrivate *d;
+  d = static_cast<PainterGlyphRunPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+unsigned int
+fastuidraw::PainterGlyphRun::
+number_chunks(void) const
+{
+  PainterGlyphRunPrivate *d;
+  d = static_cast<PainterGlyphRunPrivate*>(m_d);
+  return d->m_chunks.size();
+}
+
+const fastuidraw::PainterAttributeData&
+fastuidraw::PainterGlyphRun::
+chunk_data(unsigned int I) const
+{
+  PainterGlyphRunPrivate *d;
+  d = static_cast<PainterGlyphRunPrivate*>(m_d);
+  FASTUIDRAWassert(I < d->m_chunks.size());
+  return *d->m_chunks[I].m_data;
+}
+
+fastuidraw::vec2
+fastuidraw::PainterGlyphRun::
+chunk_bounding_box_min(unsigned int I) const
+{
+  PainterGlyphRunPrivate *d;
+  d = static_cast<PainterGlyphRunPrivate*>(m_d);
+  FASTUIDRAWassert(I < d->m_chunks.size());
+  return d->m_chunks[I].m_bounds.min_point();
+}
+
+fastuidraw::vec2
+fastuidraw::PainterGlyphRun::
+chunk_bounding_box_max(unsigned int I) const
+{
+  PainterGlyphRunPrivate *d;
+  d = static_cast<PainterGlyphRunPrivate*>(m_d);
+  FASTUIDRAWassert(I < d->m_chunks.size());
+  return d->m_chunks[I].m_bounds.max_point();
+}
+
+unsigned int
+fastuidraw::PainterGlyphRun::
+number_glyphs(void) const
+{
+  PainterGlyphRunPrivate *d;
+  d = static_cast<PainterGlyphRunPrivate*>(m_d);
+  return d->m_number_glyphs;
+}
+
+unsigned int
+fastuidraw::PainterGlyphRun::
+number_pending_glyphs(void) const
+{
+  PainterGlyphRunPrivate *d;
+  d = static_cast<PainterGlyphRunPrivate*>(m_d);
+  return d->m_number_pending;
+}
+
+void
+fastuidraw::PainterGlyphRun::
+update_chunk(unsigned int I) const
+{
+  PainterGlyphRunPrivate *d;
+  d = static_cast<PainterGlyphRunPrivate*>(m_d);
+  FASTUIDRAWassert(I < d->m_chunks.size());
+
+  GlyphChunk &chunk(d->m_chunks[I]);
+  if (chunk.atlas_changed())
+    {
+      d->fill_chunk(chunk);
+      d->compute_totals();
+    }
+}
+
+unsigned int
+fastuidraw::PainterGlyphRun::
+select_chunks(ScratchSpace &scratch_space,
+              c_array<const vec3> clip_equations,
+              const float3x3 &clip_matrix_local,
+              c_array<unsigned int> dst) const
+{
+  PainterGlyphRunPrivate *d;
+  ScratchSpacePrivate *scratch;
+  unsigned int return_value(0);
+  bool unclipped;
+
+  d = static_cast<PainterGlyphRunPrivate*>(m_d);
+  scratch = static_cast<ScratchSpacePrivate*>(scratch_space.m_d);
+  FASTUIDRAWassert(dst.size() >= d->m_chunks.size());
+
+  scratch->m_adjusted_clip_eqs.resize(clip_equations.size());
+  for(unsigned int i = 0; i < clip_equations.size(); ++i)
+    {
+      /* transform clip equations from clip coordinates to
+       *  local coordinates.
+       */
+      scratch->m_adjusted_clip_eqs[i] = clip_equations[i] * clip_matrix_local;
+    }
+
+  /* first check against the bounding box of the entire
+   * run to avoid checking each chunk when the run is
+   * entirely clipped or entirely unclipped.
+   */
+  if (PainterGlyphRunPrivate::bounds_clipped(*scratch, d->m_bounds, &unclipped))
+    {
+      return 0;
+    }
+
+  for(unsigned int i = 0, endi = d->m_chunks.size(); i < endi; ++i)
+    {
+      bool chunk_unclipped;
+
+      if (unclipped
+          || !PainterGlyphRunPrivate::bounds_clipped(*scratch, d->m_chunks[i].m_bounds, &chunk_unclipped))
+        {
+          dst[return_value] = i;
+          ++return_value;
+        }
+    }
+  return return_value;
+}
@@ -0,0 +1,447 @@
+/*!
+ * \file painter_text_run_cache.cpp
+ * \brief file painter_text_run_cache.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <list>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <unordered_map>
+#include <fastuidraw/painter/painter_text_run_cache.hpp>
+#include "../private/util_private.hpp"
+
+namespace
+{
+  class TextRun
+  {
+  public:
+    /* lays out the glyphs and fills the attribute data */
+    void
+    create(fastuidraw::GlyphSelector &selector,
+           fastuidraw::c_array<const uint32_t> character_codes,
+           fastuidraw::GlyphSelector::FontGroup group, float pixel_size,
+           fastuidraw::GlyphRender render,
+           enum fastuidraw::PainterEnums::glyph_orientation orientation);
+
+    std::string m_key;
+    std::vector<fastuidraw::Glyph> m_glyphs;
+    std::vector<fastuidraw::vec2> m_positions;
+    bool m_has_pending;
+    fastuidraw::reference_counted_ptr<const fastuidraw::PainterGlyphRun> m_run;
+  };
+
+  class PainterTextRunCachePrivate
+  {
+  public:
+    typedef std::list<TextRun> list_type;
+    typedef std::unordered_map<std::string, list_type::iterator> map_type;
+
+    PainterTextRunCachePrivate(const fastuidraw::reference_counted_ptr<fastuidraw::GlyphSelector> &selector,
+                               unsigned int max_glyphs):
+      m_selector(selector),
+      m_max_glyphs(max_glyphs),
+      m_number_glyphs(0),
+      m_number_hits(0),
+      m_number_misses(0),
+      m_number_evictions(0)
+    {}
+
+    static
+    void
+    make_key(fastuidraw::c_array<const uint32_t> character_codes,
+             const fastuidraw::FontProperties &props, float pixel_size,
+             fastuidraw::GlyphRender render,
+             enum fastuidraw::PainterEnums::glyph_orientation orientation,
+             std::string &dst);
+
+    /* removes the least recently used text runs until
+     * m_number_glyphs is no more than max_glyphs
+     */
+    void
+    evict(unsigned int max_glyphs);
+
+    fastuidraw::reference_counted_ptr<const fastuidraw::PainterGlyphRun>
+    fetch(fastuidraw::c_array<const uint32_t> character_codes,
+          const fastuidraw::FontProperties &props, float pixel_size,
+          fastuidraw::GlyphRender render,
+          enum fastuidraw::PainterEnums::glyph_orientation orientation);
+
+    fastuidraw::reference_counted_ptr<fastuidraw::GlyphSelector> m_selector;
+    unsigned int m_max_glyphs;
+    unsigned int m_number_glyphs;
+
+    /* front is the most recently used */
+    list_type m_runs;
+    map_type m_map;
+    std::string m_key_work_room;
+    std::vector<uint32_t> m_codes_work_room;
+
+    unsigned int m_number_hits;
+    unsigned int m_number_misses;
+    unsigned int m_number_evictions;
+  };
+
+  template<typename T>
+  void
+  append_bytes(const T &v, std::string &dst)
+  {
+    dst.append(reinterpret_cast<const char*>(&v), sizeof(T));
+  }
+
+  /* decodes a UTF-8 encoded string to code points; an invalid
+   * or truncated sequence, an overlong encoding or an encoded
+   * surrogate is decoded as U+FFFD and decoding resumes at the
+   * byte following the first byte of the sequence.
+   */
+  void
+  decode_utf8(fastuidraw::c_string text, std::vector<uint32_t> &dst)
+  {
+    const uint32_t replacement_character(0xFFFD);
+    const unsigned char *p;
+
+    p = reinterpret_cast<const unsigned char*>(text);
+    while(p && *p)
+      {
+        uint32_t code, min_code;
+        unsigned int length;
+
+        if (*p < 0x80u)
+          {
+            dst.push_back(*p);
+            ++p;
+            continue;
+          }
+        else if ((*p & 0xE0u) == 0xC0u)
+          {
+            code = *p & 0x1Fu;
+            length = 2;
+            min_code = 0x80u;
+          }
+        else if ((*p & 0xF0u) == 0xE0u)
+          {
+            code = *p & 0x0Fu;
+            length = 3;
+            min_code = 0x800u;
+          }
+        else if ((*p & 0xF8u) == 0xF0u)
+          {
+            code = *p & 0x07u;
+            length = 4;
+            min_code = 0x10000u;
+          }
+        else
+          {
+            dst.push_back(replacement_character);
+            ++p;
+            continue;
+          }
+
+        unsigned int i;
+        for(i = 1; i < length && (p[i] & 0xC0u) == 0x80u; ++i)
+          {
+            code = (code << 6u) | (p[i] & 0x3Fu);
+          }
+
+        if (i < length || code < min_code || code > 0x10FFFFu
+            || (code >= 0xD800u && code <= 0xDFFFu))
+          {
+            dst.push_back(replacement_character);
+            ++p;
+          }
+        else
+          {
+            dst.push_back(code);
+            p += length;
+          }
+      }
+  }
+
+  void
+  append_string(fastuidraw::c_string s, std::string &dst)
+  {
+    /* include the terminator so that consecutive
+     * strings cannot be confused.
+     */
+    if (s)
+      {
+        dst.append(s);
+      }
+    dst.push_back('\0');
+  }
+}
+
+///////////////////////////////////////
+// TextRun methods
+void
+TextRun::
+create(fastuidraw::GlyphSelector &selector,
+       fastuidraw::c_array<const uint32_t> character_codes,
+       fastuidraw::GlyphSelector::FontGroup group, float pixel_size,
+       fastuidraw::GlyphRender render,
+       enum fastuidraw::PainterEnums::glyph_orientation orientation)
+{
+  fastuidraw::vec2 pen(0.0f, 0.0f);
+
+  m_has_pending = false;
+  m_glyphs.resize(character_codes.size());
+  m_positions.resize(character_codes.size());
+
+  selector.create_glyph_sequence(render, group,
+                                 character_codes.begin(), character_codes.end(),
+                                 m_glyphs.begin());
+  for(unsigned int i = 0, endi = m_glyphs.size(); i < endi; ++i)
+    {
+      fastuidraw::Glyph &g(m_glyphs[i]);
+
+      m_positions[i] = pen;
+      if (g.valid())
+        {
+          if (g.pending())
+            {
+              /* the advance of a pending glyph is not known,
+               * so it is kept out of the run; otherwise the
+               * run would add it (see PainterGlyphRun::update_chunk())
+               * at a position overlapping the glyph after it.
+               * The run is laid out again by the next fetch.
+               */
+              m_has_pending = true;
+              g = fastuidraw::Glyph();
+            }
+          else
+            {
+              float ratio;
+
+              ratio = pixel_size / g.layout().m_units_per_EM;
+              pen.x() += ratio * g.layout().m_advance.x();
+            }
+        }
+    }
+  m_run = FASTUIDRAWnew fastuidraw::PainterGlyphRun(fastuidraw::make_c_array(m_positions),
+                                                    fastuidraw::make_c_array(m_glyphs),
+                                                    pixel_size, orientation);
+}
+
+///////////////////////////////////////////////
+// PainterTextRunCachePrivate methods
+void
+PainterTextRunCachePrivate::
+make_key(fastuidraw::c_array<const uint32_t> character_codes,
+         const fastuidraw::FontProperties &props, float pixel_size,
+         fastuidraw::GlyphRender render,
+         enum fastuidraw::PainterEnums::glyph_orientation orientation,
+         std::string &dst)
+{
+  uint32_t flags;
+
+  dst.clear();
+  append_string(props.foundry(), dst);
+  append_string(props.family(), dst);
+  append_string(props.style(), dst);
+  append_string(props.source_label(), dst);
+
+  flags = (props.bold() ? 1u : 0u) | (props.italic() ? 2u : 0u);
+  append_bytes(flags, dst);
+  append_bytes(pixel_size, dst);
+  append_bytes(render.m_type, dst);
+  if (!fastuidraw::GlyphRender::scalable(render.m_type))
+    {
+      append_bytes(render.m_pixel_size, dst);
+    }
+  append_bytes(orientation, dst);
+  dst.append(reinterpret_cast<const char*>(character_codes.c_ptr()),
+             sizeof(uint32_t) * character_codes.size());
+}
+
+void
+PainterTextRunCachePrivate::
+evict(unsigned int max_glyphs)
+{
+  while(m_number_glyphs > max_glyphs && !m_runs.empty())
+    {
+      TextRun &R(m_runs.back());
+
+      FASTUIDRAWassert(m_number_glyphs >= R.m_glyphs.size());
+      m_number_glyphs -= R.m_glyphs.size();
+      m_map.erase(R.m_key);
+      m_runs.pop_back();
+      ++m_number_evictions;
+    }
+}
+
+fastuidraw::reference_counted_ptr<const fastuidraw::PainterGlyphRun>
+PainterTextRunCachePrivate::
+fetch(fastuidraw::c_array<const uint32_t> character_codes,
+      const fastuidraw::FontProperties &props, float pixel_size,
+      fastuidraw::GlyphRender render,
+      enum fastuidraw::PainterEnums::glyph_orientation orientation)
+{
+  map_type::iterator iter;
+
+  make_key(character_codes, props, pixel_size, render, orientation, m_key_work_room);
+  iter = m_map.find(m_key_work_room);
+  if (iter != m_map.end())
+    {
+      list_type::iterator R(iter->second);
+
+      m_runs.splice(m_runs.begin(), m_runs, R);
+      if (R->m_has_pending)
+        {
+          ++m_number_misses;
+          R->create(*m_selector, character_codes,
+                    m_selector->fetch_group(props, false),
+                    pixel_size, render, orientation);
+        }
+      else
+        {
+          ++m_number_hits;
+        }
+      return R->m_run;
+    }
+
+  ++m_number_misses;
+  m_runs.push_front(TextRun());
+  m_runs.front().m_key = m_key_work_room;
+  m_runs.front().create(*m_selector, character_codes,
+                        m_selector->fetch_group(props, false),
+                        pixel_size, render, orientation);
+  m_map[m_key_work_room] = m_runs.begin();
+  m_number_glyphs += character_codes.size();
+
+  /* never evict the text run just created */
+  evict(fastuidraw::t_max(m_max_glyphs, static_cast<unsigned int>(character_codes.size())));
+  return m_runs.front().m_run;
+}
+
+///////////////////////////////////////////////
+// fastuidraw::PainterTextRunCache methods
+fastuidraw::PainterTextRunCache::
+PainterTextRunCache(const reference_counted_ptr<GlyphSelector> &selector,
+                    unsigned int pmax_glyphs)
+{
+  m_d = FASTUIDRAWnew PainterTextRunCachePrivate(selector, pmax_glyphs);
+}
+
+fastuidraw::PainterTextRunCache::
+~PainterTextRunCache()
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+fastuidraw::reference_counted_ptr<const fastuidraw::PainterGlyphRun>
+fastuidraw::PainterTextRunCache::
+fetch(c_array<const uint32_t> character_codes,
+      const FontProperties &props, float pixel_size,
+      GlyphRender render,
+      enum PainterEnums::glyph_orientation orientation)
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+  return d->fetch(character_codes, props, pixel_size, render, orientation);
+}
+
+fastuidraw::reference_counted_ptr<const fastuidraw::PainterGlyphRun>
+fastuidraw::PainterTextRunCache::
+fetch(c_string text,
+      const FontProperties &props, float pixel_size,
+      GlyphRender render,
+      enum PainterEnums::glyph_orientation orientation)
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+
+  d->m_codes_work_room.clear();
+  decode_utf8(text, d->m_codes_work_room);
+  return d->fetch(make_c_array(d->m_codes_work_room), props, pixel_size, render, orientation);
+}
+
+unsigned int
+fastuidraw::PainterTextRunCache::
+max_glyphs(void) const
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+  return d->m_max_glyphs;
+}
+
+void
+fastuidraw::PainterTextRunCache::
+max_glyphs(unsigned int v)
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+  d->m_max_glyphs = v;
+  d->evict(v);
+}
+
+unsigned int
+fastuidraw::PainterTextRunCache::
+number_glyphs(void) const
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+  return d->m_number_glyphs;
+}
+
+unsigned int
+fastuidraw::PainterTextRunCache::
+number_runs(void) const
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+  return d->m_runs.size();
+}
+
+void
+fastuidraw::PainterTextRunCache::
+clear(void)
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+  d->m_map.clear();
+  d->m_runs.clear();
+  d->m_number_glyphs = 0;
+}
+
+unsigned int
+fastuidraw::PainterTextRunCache::
+number_hits(void) const
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+  return d->m_number_hits;
+}
+
+unsigned int
+fastuidraw::PainterTextRunCache::
+number_misses(void) const
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+  return d->m_number_misses;
+}
+
+unsigned int
+fastuidraw::PainterTextRunCache::
+number_evictions(void) const
+{
+  PainterTextRunCachePrivate *d;
+  d = static_cast<PainterTextRunCachePrivate*>(m_d);
+  return d->m_number_evictions;
+}
@@ -34,6 +34,7 @@
 
 #include <iterator>
 #include <set>
+#include <thread>
 #include "int_path.hpp"
 #include "util_private_ostream.hpp"
 
@@ -336,6 +337,21 @@ namespace
                                int step, int count,
                                uint32_t solution_types_accepted,
                                const IntBezierCurve::transformation<int> &tr,
+                               std::vector<std::vector<solution_pt> > *out_value) const
+    {
+      compute_lines_intersection(line_type, step, count, 0, count,
+                                 solution_types_accepted, tr, out_value);
+    }
+
+    /* only compute the intersections against the lines
+     * c with line_begin <= c < line_end.
+     */
+    void
+    compute_lines_intersection(enum coordinate_type line_type,
+                               int step, int count,
+                               int line_begin, int line_end,
+                               uint32_t solution_types_accepted,
+                               const IntBezierCurve::transformation<int> &tr,
                                std::vector<std::vector<solution_pt> > *out_value) const;
 
   private:
@@ -389,6 +405,37 @@ namespace
     const IntBezierCurve &m_curve;
   };
 
+  /* Partitions [0, count) into at most number_threads ranges
+   * of at least min_per_range elements each and calls f(begin, end)
+   * on each range concurrently, one of the ranges on the calling
+   * thread. The ranges must be safe to process concurrently.
+   */
+  template<typename F>
+  void
+  parallel_ranges(unsigned int number_threads, int count, int min_per_range, const F &f)
+  {
+    int n;
+
+    n = fastuidraw::t_min(static_cast<int>(number_threads),
+                          count / fastuidraw::t_max(1, min_per_range));
+    if (n <= 1)
+      {
+        f(0, count);
+        return;
+      }
+
+    std::vector<std::thread> threads;
+    for(int i = 1; i < n; ++i)
+      {
+        threads.push_back(std::thread(f, (i * count) / n, ((i + 1) * count) / n));
+      }
+    f(0, count / n);
+    for(std::thread &t : threads)
+      {
+        t.join();
+      }
+  }
+
   class distance_value
   {
   public:
@@ -481,11 +528,22 @@ namespace
     typedef fastuidraw::ivec2 ivec2;
     typedef fastuidraw::vec2 vec2;
 
-    explicit
-    DistanceFieldGenerator(const std::vector<IntContour> &p):
-      m_contours(p)
+    /* lines of texels are computed by up to number_threads
+     * threads, the values computed do not depend on the
+     * number of threads.
+     */
+    DistanceFieldGenerator(const std::vector<IntContour> &p,
+                           unsigned int number_threads):
+      m_contours(p),
+      m_number_threads(number_threads)
     {}
 
+    /* minimum number of lines of texels a thread processes */
+    enum { min_lines_per_thread = 16 };
+
+    /* maximum value for the radius argument of compute_distance_values() */
+    enum { max_radius = 8 };
+
     /*
      * Compute distance_value for the domain
      *   D = { (x(i), y(j)) : 0 <= i < count.x(), 0 <= j < count.y() }
@@ -505,23 +563,27 @@ namespace
     pixel_value_from_distance(float dist, bool outside);
 
   private:
+    /* the candidate functions only modify the texels (x, y)
+     * with x_begin <= x < x_end.
+     */
     template<typename T>
     static
     void
     record_distance_value_from_canidate(const fastuidraw::vecN<T, 2> &p, int radius,
                                         const ivec2 &step,
                                         const ivec2 &count,
+                                        int x_begin, int x_end,
                                         fastuidraw::array2d<distance_value> &dst);
 
     void
     compute_outline_point_values(const ivec2 &step, const ivec2 &count,
                                  const IntBezierCurve::transformation<int> &tr,
-                                 int radius,
+                                 int radius, int x_begin, int x_end,
                                  fastuidraw::array2d<distance_value> &dst) const;
     void
     compute_derivative_cancel_values(const ivec2 &step, const ivec2 &count,
                                      const IntBezierCurve::transformation<int> &tr,
-                                     int radius,
+                                     int radius, int x_begin, int x_end,
                                      fastuidraw::array2d<distance_value> &dst) const;
     void
     compute_fixed_line_values(const ivec2 &step, const ivec2 &count,
@@ -534,7 +596,17 @@ namespace
                               const IntBezierCurve::transformation<int> &tr,
                               fastuidraw::array2d<distance_value> &dst) const;
 
+    /* computes the lines c with line_begin <= c < line_end */
+    void
+    compute_fixed_line_values(enum Solver::coordinate_type tp,
+                              std::vector<std::vector<Solver::solution_pt> > &work_room,
+                              const ivec2 &step, const ivec2 &count,
+                              const IntBezierCurve::transformation<int> &tr,
+                              int line_begin, int line_end,
+                              fastuidraw::array2d<distance_value> &dst) const;
+
     const std::vector<fastuidraw::detail::IntContour> &m_contours;
+    unsigned int m_number_threads;
   };
 
   class CurvePairGenerator
@@ -1162,6 +1234,7 @@ compute_line_intersection(int pt, enum coordinate_type line_type,
 void
 Solver::
 compute_lines_intersection(enum coordinate_type tp, int step, int count,
+                           int line_begin, int line_end,
                            uint32_t solution_types_accepted,
                            const IntBezierCurve::transformation<int> &tr,
                            std::vector<std::vector<solution_pt> > *out_value) const
@@ -1200,6 +1273,8 @@ compute_lines_intersection(enum coordinate_type tp, int step, int count,
       cend = count;
     }
 
+  cstart = fastuidraw::t_max(cstart, line_begin);
+  cend = fastuidraw::t_min(cend, line_end);
   for(int c = cstart; c < cend; ++c)
     {
       int v;
@@ -1217,22 +1292,45 @@ DistanceFieldGenerator::
 record_distance_value_from_canidate(const fastuidraw::vecN<T, 2> &p, int radius,
                                     const ivec2 &step,
                                     const ivec2 &count,
+                                    int x_begin, int x_end,
                                     fastuidraw::array2d<distance_value> &dst)
 {
+  /* The L1-distance is the sum of a term depending only on x
+   * and a term depending only on y; the y-terms are computed
+   * once into a small array (a loop the compiler vectorizes)
+   * and then added to each x-term. The sum is the same
+   * expression (in the same order) as computing the distance
+   * of each texel directly, so the values are identical.
+   */
   ivec2 ip(p);
-  for(int x = fastuidraw::t_max(0, ip.x() - radius),
-        maxx = fastuidraw::t_min(count.x(), ip.x() + radius);
-      x < maxx; ++x)
+  int minx, maxx, miny, maxy;
+  T dy[2 * max_radius];
+
+  FASTUIDRAWassert(radius <= max_radius);
+  minx = fastuidraw::t_max(x_begin, ip.x() - radius);
+  maxx = fastuidraw::t_min(x_end, fastuidraw::t_min(count.x(), ip.x() + radius));
+  miny = fastuidraw::t_max(0, ip.y() - radius);
+  maxy = fastuidraw::t_min(count.y(), ip.y() + radius);
+  if (minx >= maxx || miny >= maxy)
     {
-      for(int y = fastuidraw::t_max(0, ip.y() - radius),
-            maxy = fastuidraw::t_min(count.y(), ip.y() + radius);
-          y < maxy; ++y)
-        {
-          T v;
+      return;
+    }
 
-          v = fastuidraw::t_abs(T(x * step.x()) - p.x())
-            + fastuidraw::t_abs(T(y * step.y()) - p.y());
-          dst(x, y).record_distance_value(static_cast<float>(v));
+  for(int y = miny; y < maxy; ++y)
+    {
+      dy[y - miny] = fastuidraw::t_abs(T(y * step.y()) - p.y());
+    }
+
+  for(int x = minx; x < maxx; ++x)
+    {
+      T dx;
+      distance_value *column;
+
+      dx = fastuidraw::t_abs(T(x * step.x()) - p.x());
+      column = &dst(x, miny);
+      for(int y = 0, endy = maxy - miny; y < endy; ++y)
+        {
+          column[y].record_distance_value(static_cast<float>(dx + dy[y]));
         }
     }
 }
@@ -1280,8 +1378,12 @@ compute_distance_values(const ivec2 &step, const ivec2 &count,
    *  then just count.x (for 1) plus count.y (for 2). The items
    *  from (3) and (4) are already stored in IntBezierCurve
    */
-  compute_outline_point_values(step, count, tr, radius, dst);
-  compute_derivative_cancel_values(step, count, tr, radius, dst);
+  parallel_ranges(m_number_threads, count.x(), min_lines_per_thread,
+                  [&](int x_begin, int x_end)
+                  {
+                    compute_outline_point_values(step, count, tr, radius, x_begin, x_end, dst);
+                    compute_derivative_cancel_values(step, count, tr, radius, x_begin, x_end, dst);
+                  });
   compute_fixed_line_values(step, count, tr, dst);
 }
 
@@ -1289,7 +1391,8 @@ void
 DistanceFieldGenerator::
 compute_outline_point_values(const ivec2 &step, const ivec2 &count,
                              const IntBezierCurve::transformation<int> &tr,
-                             int radius, fastuidraw::array2d<distance_value> &dst) const
+                             int radius, int x_begin, int x_end,
+                             fastuidraw::array2d<distance_value> &dst) const
 {
   for(const IntContour &contour: m_contours)
     {
@@ -1297,7 +1400,7 @@ compute_outline_point_values(const ivec2 &step, const ivec2 &count,
       for(const IntBezierCurve &curve : curves)
         {
           record_distance_value_from_canidate(tr(curve.control_pts().front()),
-                                              radius, step, count, dst);
+                                              radius, step, count, x_begin, x_end, dst);
         }
     }
 }
@@ -1306,7 +1409,7 @@ void
 DistanceFieldGenerator::
 compute_derivative_cancel_values(const ivec2 &step, const ivec2 &count,
                                  const IntBezierCurve::transformation<int> &tr,
-                                 int radius,
+                                 int radius, int x_begin, int x_end,
                                  fastuidraw::array2d<distance_value> &dst) const
 {
   IntBezierCurve::transformation<float> ftr(tr.cast<float>());
@@ -1318,7 +1421,7 @@ compute_derivative_cancel_values(const ivec2 &step, const ivec2 &count,
           fastuidraw::c_array<const vec2> derivatives_cancel(curve.derivatives_cancel());
           for(const vec2 &p : derivatives_cancel)
             {
-              record_distance_value_from_canidate(ftr(p), radius, step, count, dst);
+              record_distance_value_from_canidate(ftr(p), radius, step, count, x_begin, x_end, dst);
             }
         }
     }
@@ -1345,6 +1448,34 @@ compute_fixed_line_values(enum Solver::coordinate_type tp,
                           const ivec2 &step, const ivec2 &count,
                           const IntBezierCurve::transformation<int> &tr,
                           fastuidraw::array2d<distance_value> &dst) const
+{
+  const int fixed_coord(Solver::fixed_coordinate(tp));
+
+  work_room.resize(count[fixed_coord]);
+  for(int i = 0; i < count[fixed_coord]; ++i)
+    {
+      work_room[i].clear();
+    }
+
+  /* each line only modifies the texels on the line, so
+   * different lines can be computed concurrently.
+   */
+  parallel_ranges(m_number_threads, count[fixed_coord], min_lines_per_thread,
+                  [&](int line_begin, int line_end)
+                  {
+                    compute_fixed_line_values(tp, work_room, step, count, tr,
+                                              line_begin, line_end, dst);
+                  });
+}
+
+void
+DistanceFieldGenerator::
+compute_fixed_line_values(enum Solver::coordinate_type tp,
+                          std::vector<std::vector<Solver::solution_pt> > &work_room,
+                          const ivec2 &step, const ivec2 &count,
+                          const IntBezierCurve::transformation<int> &tr,
+                          int line_begin, int line_end,
+                          fastuidraw::array2d<distance_value> &dst) const
 {
   const enum distance_value::winding_ray_t ray_types[2][2] =
     {
@@ -1356,13 +1487,10 @@ compute_fixed_line_values(enum Solver::coordinate_type tp,
   const int varying_coord(Solver::varying_coordinate(tp));
   const int winding_sgn((tp == Solver::x_fixed) ? 1 : -1);
 
-  work_room.resize(count[fixed_coord]);
-  for(int i = 0; i < count[fixed_coord]; ++i)
-    {
-      work_room[i].clear();
-    }
-
-  /* record the solutions for each fixed line */
+  /* record the solutions for each fixed line; the curves are
+   * walked in the same order regardless of the line range, so
+   * the solutions of each line are in the same order too.
+   */
   for(const IntContour &contour: m_contours)
     {
       const std::vector<IntBezierCurve> &curves(contour.curves());
@@ -1370,13 +1498,14 @@ compute_fixed_line_values(enum Solver::coordinate_type tp,
         {
           Solver(curve).compute_lines_intersection(tp, step[fixed_coord],
                                                    count[fixed_coord],
+                                                   line_begin, line_end,
                                                    Solver::within_0_1,
                                                    tr, &work_room);
         }
     }
 
   /* now for each line, do the distance computation along the line. */
-  for(int c = 0; c < count[fixed_coord]; ++c)
+  for(int c = line_begin; c < line_end; ++c)
     {
       std::vector<Solver::solution_pt> &L(work_room[c]);
       int total_cnt(0), winding(0);
@@ -2271,9 +2400,10 @@ extract_render_data(const ivec2 &step, const ivec2 &image_sz,
                     float max_distance,
                     IntBezierCurve::transformation<int> tr,
                     const CustomFillRuleBase &fill_rule,
-                    GlyphRenderDataDistanceField *dst) const
+                    GlyphRenderDataDistanceField *dst,
+                    unsigned int number_threads) const
 {
-  DistanceFieldGenerator compute(m_contours);
+  DistanceFieldGenerator compute(m_contours, number_threads);
   array2d<distance_value> dist_values(image_sz.x(), image_sz.y());
   int radius(2);
 
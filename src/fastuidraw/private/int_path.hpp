@@ -426,13 +426,18 @@ namespace fastuidraw
        *                    AFTER tr is applied
        *  \param image_sz size of the distance field to make
        *  \param tr transformation to apply to data of path
+       *  \param number_threads maximum number of threads used to
+       *                        compute the distance values; the
+       *                        values do not depend on the number
+       *                        of threads
        */
       void
       extract_render_data(const ivec2 &texel_size, const ivec2 &image_sz,
                           float max_distance,
                           IntBezierCurve::transformation<int> tr,
                           const CustomFillRuleBase &fill_rule,
-                          GlyphRenderDataDistanceField *dst) const;
+                          GlyphRenderDataDistanceField *dst,
+                          unsigned int number_threads = 1) const;
 
 
       /* Compute curve-pair render data. The caller should have applied
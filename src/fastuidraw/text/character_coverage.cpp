@@ -0,0 +1,128 @@
+/*!
+ * \file character_coverage.cpp
+ * \brief file character_coverage.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <fastuidraw/text/character_coverage.hpp>
+#include "../private/util_private.hpp"
+
+namespace
+{
+  enum
+    {
+      page_bits = 12,
+      page_size = 1u << page_bits,
+      words_per_page = page_size / 64u,
+    };
+
+  class CharacterCoveragePrivate
+  {
+  public:
+    CharacterCoveragePrivate(void):
+      m_count(0)
+    {}
+
+    /* a page that is not yet used is an empty vector */
+    std::vector<std::vector<uint64_t> > m_pages;
+    unsigned int m_count;
+  };
+}
+
+////////////////////////////////////////
+// fastuidraw::CharacterCoverage methods
+fastuidraw::CharacterCoverage::
+CharacterCoverage(void)
+{
+  m_d = FASTUIDRAWnew CharacterCoveragePrivate();
+}
+
+fastuidraw::CharacterCoverage::
+~CharacterCoverage()
+{
+  CharacterCoveragePrivate *d;
+  d = static_cast<CharacterCoveragePrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+void
+fastuidraw::CharacterCoverage::
+add(uint32_t character_code)
+{
+  CharacterCoveragePrivate *d;
+  uint32_t page, word;
+  uint64_t bit;
+
+  d = static_cast<CharacterCoveragePrivate*>(m_d);
+  page = character_code >> page_bits;
+  word = (character_code & (page_size - 1u)) >> 6u;
+  bit = uint64_t(1u) << (character_code & 63u);
+
+  if (page >= d->m_pages.size())
+    {
+      d->m_pages.resize(page + 1);
+    }
+
+  std::vector<uint64_t> &P(d->m_pages[page]);
+  if (P.empty())
+    {
+      P.resize(words_per_page, 0u);
+    }
+
+  if ((P[word] & bit) == 0u)
+    {
+      P[word] |= bit;
+      ++d->m_count;
+    }
+}
+
+void
+fastuidraw::CharacterCoverage::
+add_range(uint32_t begin, uint32_t end)
+{
+  for(uint32_t c = begin; c < end; ++c)
+    {
+      add(c);
+    }
+}
+
+bool
+fastuidraw::CharacterCoverage::
+contains(uint32_t character_code) const
+{
+  CharacterCoveragePrivate *d;
+  uint32_t page, word;
+
+  d = static_cast<CharacterCoveragePrivate*>(m_d);
+  page = character_code >> page_bits;
+  if (page >= d->m_pages.size() || d->m_pages[page].empty())
+    {
+      return false;
+    }
+
+  word = (character_code & (page_size - 1u)) >> 6u;
+  return (d->m_pages[page][word] & (uint64_t(1u) << (character_code & 63u))) != 0u;
+}
+
+unsigned int
+fastuidraw::CharacterCoverage::
+number_character_codes(void) const
+{
+  CharacterCoveragePrivate *d;
+  d = static_cast<CharacterCoveragePrivate*>(m_d);
+  return d->m_count;
+}
@@ -0,0 +1,50 @@
+/*!
+ * \file font.cpp
+ * \brief file font.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <fastuidraw/text/font.hpp>
+#include <fastuidraw/text/glyph_layout_data.hpp>
+
+/////////////////////////////////////
+// fastuidraw::FontBase methods
+void
+fastuidraw::FontBase::
+compute_path(GlyphRender render, uint32_t glyph_code, Path &path) const
+{
+  GlyphLayoutData layout;
+  GlyphRenderData *data;
+
+  data = compute_rendering_data(render, glyph_code, layout, path);
+  if (data)
+    {
+      FASTUIDRAWdelete(data);
+    }
+}
+
+uint64_t
+fastuidraw::FontBase::
+persistent_id(void) const
+{
+  return 0;
+}
+
+bool
+fastuidraw::FontBase::
+compute_character_coverage(CharacterCoverage&) const
+{
+  return false;
+}
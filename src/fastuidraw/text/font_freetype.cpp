@@ -17,6 +17,8 @@
  */
 
 #include <sstream>
+#include <thread>
+#include <condition_variable>
 #include <fastuidraw/text/font_freetype.hpp>
 #include <fastuidraw/text/glyph_layout_data.hpp>
 #include <fastuidraw/text/glyph_render_data.hpp>
@@ -30,6 +32,7 @@
 
 #include <ft2build.h>
 #include FT_OUTLINE_H
+#include FT_TRUETYPE_TABLES_H
 
 namespace
 {
@@ -65,18 +68,48 @@ namespace
     float m_factor;
   };
 
+  /* FNV-1a, used to compute FontFreeType::persistent_id();
+   * a hash starts at fnv1a_offset_basis and each call
+   * continues the hash h of the bytes hashed before.
+   */
+  const uint64_t fnv1a_offset_basis = 0xcbf29ce484222325ull;
+
+  uint64_t
+  hash_bytes(const void *pdata, size_t length, uint64_t h)
+  {
+    const uint8_t *data(static_cast<const uint8_t*>(pdata));
+
+    for(size_t i = 0; i < length; ++i)
+      {
+        h ^= data[i];
+        h *= 0x100000001b3ull;
+      }
+    return h;
+  }
+
+  template<typename T>
+  uint64_t
+  hash_value(T v, uint64_t h)
+  {
+    return hash_bytes(&v, sizeof(v), h);
+  }
+
   class RenderParamsPrivate
   {
   public:
     RenderParamsPrivate(void):
       m_distance_field_pixel_size(48),
       m_distance_field_max_distance(96.0f),
-      m_curve_pair_pixel_size(32)
+      m_curve_pair_pixel_size(32),
+      m_number_faces(8),
+      m_distance_field_threads(1)
     {}
 
     unsigned int m_distance_field_pixel_size;
     float m_distance_field_max_distance;
     unsigned int m_curve_pair_pixel_size;
+    unsigned int m_number_faces;
+    unsigned int m_distance_field_threads;
   };
 
   class IntPathCreator
@@ -169,6 +202,14 @@ namespace
   {
   public:
 
+    /* A FaceGrabber takes a FreeTypeFace from the pool of
+     * faces of a FontFreeTypePrivate for its lifetime. If all
+     * faces are in use and the pool is at its maximum size,
+     * the ctor blocks until a face is returned to the pool.
+     * A new face is created without holding the lock of the
+     * pool; if creating it fails, the pool stops growing and
+     * an existing face is used instead.
+     */
     class FaceGrabber
     {
     public:
@@ -176,6 +217,21 @@ namespace
       ~FaceGrabber();
 
       fastuidraw::FreeTypeFace *m_p;
+
+    private:
+      FontFreeTypePrivate *m_q;
+    };
+
+    /* An element of the free list of the face pool, records
+     * the thread that last used the face so that a thread
+     * gets back the same face (whose FreeType internal caches
+     * are then warm for that thread's glyphs) when it can.
+     */
+    class FreeFace
+    {
+    public:
+      fastuidraw::FreeTypeFace *m_face;
+      std::thread::id m_last_user;
     };
 
     FontFreeTypePrivate(fastuidraw::FontFreeType *p,
@@ -209,16 +265,71 @@ namespace
                            fastuidraw::GlyphRenderDataCurvePair &output,
                            fastuidraw::Path &path);
 
+    void
+    compute_path(fastuidraw::GlyphRender render, uint32_t glyph_code,
+                 fastuidraw::Path &path);
+
+    uint64_t
+    persistent_id(void);
+
+    /* The outline of a glyph in font units together with the
+     * values needed to create its scalable rendering data;
+     * shared between creating the rendering data and creating
+     * only the Path of a glyph.
+     */
+    class ScalableOutline
+    {
+    public:
+      fastuidraw::detail::IntPath m_path;
+      int m_units_per_EM;
+      fastuidraw::ivec2 m_layout_offset;
+      int m_outline_flags;
+
+      /* only set by load_curve_pair_outline() */
+      fastuidraw::ivec2 m_image_size;
+      fastuidraw::detail::IntBezierCurve::transformation<int> m_tr;
+      fastuidraw::ivec2 m_texel_distance;
+    };
+
+    bool
+    load_scalable_outline(uint32_t glyph_code,
+                          fastuidraw::GlyphLayoutData &layout,
+                          ScalableOutline &output);
+
+    bool
+    load_distance_field_outline(uint32_t glyph_code,
+                                fastuidraw::GlyphLayoutData &layout,
+                                ScalableOutline &output);
+
+    bool
+    load_curve_pair_outline(uint32_t glyph_code,
+                            fastuidraw::GlyphLayoutData &layout,
+                            ScalableOutline &output);
+
     fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeFace::GeneratorBase> m_generator;
     fastuidraw::FontFreeType::RenderParams m_render_params;
     fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeLib> m_lib;
     fastuidraw::FontFreeType *m_p;
 
-    /* for now we have a static number of m_faces we use for parallel
-     *  glyph generation
+    /* Pool of faces for parallel glyph generation; faces are
+     * created on demand up to m_max_number_faces and are never
+     * released until the FontFreeTypePrivate is deleted.
      */
-    fastuidraw::vecN<fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeFace>, 8> m_faces;
+    fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeFace>
+    create_face(void);
+
+    fastuidraw::mutex m_faces_mutex;
+    std::condition_variable_any m_faces_released;
+    unsigned int m_max_number_faces;
+    unsigned int m_number_faces_creating;
+    std::vector<fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeFace> > m_faces;
+    std::vector<FreeFace> m_free_faces;
     bool m_all_faces_null;
+
+    /* computed on first call to persistent_id() */
+    fastuidraw::mutex m_persistent_id_mutex;
+    bool m_persistent_id_ready;
+    uint64_t m_persistent_id;
   };
 }
 
@@ -226,19 +337,77 @@ namespace
 // FontFreeTypePrivate::FaceGrabber methods
 FontFreeTypePrivate::FaceGrabber::
 FaceGrabber(FontFreeTypePrivate *q):
-  m_p(nullptr)
+  m_p(nullptr),
+  m_q(q)
 {
-  while(!m_p && !q->m_all_faces_null)
+  std::thread::id me(std::this_thread::get_id());
+
+  if (m_q->m_all_faces_null)
     {
-      for(unsigned int i = 0; i < q->m_faces.size() && !m_p; ++i)
+      return;
+    }
+
+  m_q->m_faces_mutex.lock();
+  while(!m_p)
+    {
+      std::vector<FreeFace>::iterator iter;
+
+      /* first choice: the face this thread used last,
+       * second choice: a new face if the pool is not full,
+       * third choice: any free face; if there are none,
+       * wait until a face is released.
+       */
+      for(iter = m_q->m_free_faces.begin();
+          iter != m_q->m_free_faces.end() && iter->m_last_user != me;
+          ++iter)
+        {}
+
+      if (iter != m_q->m_free_faces.end())
         {
-          const fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeFace> &face(q->m_faces[i]);
-          if (face && face->try_lock())
+          m_p = iter->m_face;
+          *iter = m_q->m_free_faces.back();
+          m_q->m_free_faces.pop_back();
+        }
+      else if (m_q->m_faces.size() + m_q->m_number_faces_creating < m_q->m_max_number_faces)
+        {
+          fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeFace> face;
+
+          /* the slot in the pool is reserved by incrementing
+           * m_number_faces_creating so that the face can be
+           * created without holding the lock.
+           */
+          ++m_q->m_number_faces_creating;
+          m_q->m_faces_mutex.unlock();
+          face = m_q->create_face();
+          m_q->m_faces_mutex.lock();
+          --m_q->m_number_faces_creating;
+
+          if (face && face->face())
             {
+              m_q->m_faces.push_back(face);
               m_p = face.get();
             }
+          else
+            {
+              /* the generator failed, do not try again; the pool
+               * is not empty because the ctor of FontFreeTypePrivate
+               * created a face successfully (m_all_faces_null is false).
+               */
+              m_q->m_max_number_faces = m_q->m_faces.size() + m_q->m_number_faces_creating;
+            }
+        }
+      else if (!m_q->m_free_faces.empty())
+        {
+          m_p = m_q->m_free_faces.back().m_face;
+          m_q->m_free_faces.pop_back();
+        }
+      else
+        {
+          m_q->m_faces_released.wait(m_q->m_faces_mutex);
         }
     }
+  m_q->m_faces_mutex.unlock();
+  m_p->lock();
 }
 
 FontFreeTypePrivate::FaceGrabber::
@@ -246,7 +415,16 @@ FontFreeTypePrivate::FaceGrabber::
 {
   if (m_p)
     {
+      FreeFace F;
+
       m_p->unlock();
+      F.m_face = m_p;
+      F.m_last_user = std::this_thread::get_id();
+
+      m_q->m_faces_mutex.lock();
+      m_q->m_free_faces.push_back(F);
+      m_q->m_faces_mutex.unlock();
+      m_q->m_faces_released.notify_one();
     }
 }
 
@@ -261,22 +439,27 @@ FontFreeTypePrivate(fastuidraw::FontFreeType *p,
   m_render_params(render_params),
   m_lib(lib),
   m_p(p),
-  m_all_faces_null(true)
+  m_max_number_faces(fastuidraw::t_max(1u, render_params.number_faces())),
+  m_number_faces_creating(0),
+  m_all_faces_null(true),
+  m_persistent_id_ready(false),
+  m_persistent_id(0)
 {
+  FreeFace F;
+
   if (!m_lib)
     {
       m_lib = FASTUIDRAWnew fastuidraw::FreeTypeLib();
     }
 
-  for(unsigned int i = 0; i < m_faces.size(); ++i)
-    {
-      m_faces[i] = m_generator->create_face(m_lib);
-      if (m_faces[i] && m_faces[i]->face())
-        {
-          m_all_faces_null = false;
-          FT_Set_Transform(m_faces[i]->face(), nullptr, nullptr);
-        }
-    }
+  /* create the first face to know if the generator
+   * can create faces at all; it is placed in the free
+   * list without a previous user.
+   */
+  m_faces.push_back(create_face());
+  m_all_faces_null = !m_faces.back() || !m_faces.back()->face();
+  F.m_face = m_faces.back().get();
+  m_free_faces.push_back(F);
 }
 
 FontFreeTypePrivate::
@@ -284,6 +467,20 @@ FontFreeTypePrivate::
 {
 }
 
+fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeFace>
+FontFreeTypePrivate::
+create_face(void)
+{
+  fastuidraw::reference_counted_ptr<fastuidraw::FreeTypeFace> return_value;
+
+  return_value = m_generator->create_face(m_lib);
+  if (return_value && return_value->face())
+    {
+      FT_Set_Transform(return_value->face(), nullptr, nullptr);
+    }
+  return return_value;
+}
+
 void
 FontFreeTypePrivate::
 common_compute_rendering_data(FT_Face face, fastuidraw::FontFreeType *p,
@@ -362,6 +559,73 @@ compute_rendering_data(int pixel_size, uint32_t glyph_code,
     }
 }
 
+bool
+FontFreeTypePrivate::
+load_scalable_outline(uint32_t glyph_code,
+                      fastuidraw::GlyphLayoutData &layout,
+                      ScalableOutline &output)
+{
+  FaceGrabber p(this);
+  if (!p.m_p || !p.m_p->face())
+    {
+      return false;
+    }
+
+  FT_Face face(p.m_p->face());
+  common_compute_rendering_data(face, m_p, layout, glyph_code);
+  output.m_units_per_EM = face->units_per_EM;
+  output.m_outline_flags = face->glyph->outline.flags;
+  output.m_layout_offset = fastuidraw::ivec2(face->glyph->metrics.horiBearingX,
+                                             face->glyph->metrics.horiBearingY);
+  output.m_layout_offset.y() -= face->glyph->metrics.height;
+  IntPathCreator::decompose_to_path(&face->glyph->outline, output.m_path);
+  return true;
+}
+
+bool
+FontFreeTypePrivate::
+load_distance_field_outline(uint32_t glyph_code,
+                            fastuidraw::GlyphLayoutData &layout,
+                            ScalableOutline &output)
+{
+  if (!load_scalable_outline(glyph_code, layout, output))
+    {
+      return false;
+    }
+
+  output.m_path.replace_cubics_with_quadratics();
+  return true;
+}
+
+bool
+FontFreeTypePrivate::
+load_curve_pair_outline(uint32_t glyph_code,
+                        fastuidraw::GlyphLayoutData &layout,
+                        ScalableOutline &output)
+{
+  if (!load_scalable_outline(glyph_code, layout, output))
+    {
+      return false;
+    }
+
+  int pixel_size(m_render_params.curve_pair_pixel_size());
+  float scale_factor(static_cast<float>(pixel_size) / static_cast<float>(output.m_units_per_EM));
+
+  /* compute how many pixels we need to store the glyph. */
+  fastuidraw::vec2 image_sz_f(layout.m_size * scale_factor);
+  output.m_image_size = fastuidraw::ivec2(ceilf(image_sz_f.x()), ceilf(image_sz_f.y()));
+
+  /* Use the same transformation as the DistanceField case */
+  int tr_scale(2 * pixel_size);
+  fastuidraw::ivec2 tr_translate(-2 * pixel_size * output.m_layout_offset);
+  float curvature_collapse(0.05f);
+
+  output.m_tr = fastuidraw::detail::IntBezierCurve::transformation<int>(tr_scale, tr_translate);
+  output.m_texel_distance = fastuidraw::ivec2(2 * output.m_units_per_EM);
+  output.m_path.filter(curvature_collapse, output.m_tr, output.m_texel_distance);
+  return true;
+}
+
 void
 FontFreeTypePrivate::
 compute_rendering_data(uint32_t glyph_code,
@@ -369,46 +633,25 @@ compute_rendering_data(uint32_t glyph_code,
                        fastuidraw::GlyphRenderDataDistanceField &output,
                        fastuidraw::Path &path)
 {
-  fastuidraw::detail::IntPath int_path_ecm;
-  int units_per_EM;
-  fastuidraw::ivec2 layout_offset;
-  int outline_flags;
+  ScalableOutline outline;
 
-
-  {
-    FaceGrabber p(this);
-    if (!p.m_p || !p.m_p->face())
-      {
-        return;
-      }
-
-    FT_Face face(p.m_p->face());
-
-    common_compute_rendering_data(face, m_p, layout, glyph_code);
-    units_per_EM = face->units_per_EM;
-    outline_flags = face->glyph->outline.flags;
-    layout_offset = fastuidraw::ivec2(face->glyph->metrics.horiBearingX,
-                                      face->glyph->metrics.horiBearingY);
-    layout_offset.y() -= face->glyph->metrics.height;
-    IntPathCreator::decompose_to_path(&face->glyph->outline, int_path_ecm);
-    int_path_ecm.replace_cubics_with_quadratics();
-  }
-
-  if (int_path_ecm.empty())
+  if (!load_distance_field_outline(glyph_code, layout, outline)
+      || outline.m_path.empty())
     {
       return;
     }
 
   fastuidraw::detail::IntBezierCurve::transformation<float> identity_tr;
-  int_path_ecm.add_to_path(identity_tr, &path);
+  outline.m_path.add_to_path(identity_tr, &path);
 
   /* choose the correct fill rule as according to outline_flags */
   enum fastuidraw::PainterEnums::fill_rule_t fill_rule;
-  fill_rule = (outline_flags & FT_OUTLINE_EVEN_ODD_FILL) ?
+  fill_rule = (outline.m_outline_flags & FT_OUTLINE_EVEN_ODD_FILL) ?
     fastuidraw::PainterEnums::odd_even_fill_rule:
     fastuidraw::PainterEnums::nonzero_fill_rule;
 
   /* compute the step value needed to create the distance field value*/
+  int units_per_EM(outline.m_units_per_EM);
   int pixel_size(m_render_params.distance_field_pixel_size());
   float scale_factor(static_cast<float>(pixel_size) / static_cast<float>(units_per_EM));
 
@@ -430,15 +673,16 @@ compute_rendering_data(uint32_t glyph_code,
    *  is then just 2 * units_per_EM.
    */
   int tr_scale(2 * pixel_size);
-  fastuidraw::ivec2 tr_translate(-2 * pixel_size * layout_offset);
+  fastuidraw::ivec2 tr_translate(-2 * pixel_size * outline.m_layout_offset);
   fastuidraw::detail::IntBezierCurve::transformation<int> tr(tr_scale, tr_translate);
   fastuidraw::ivec2 texel_distance(2 * units_per_EM);
   float max_distance = (m_render_params.distance_field_max_distance() / 64.0f)
     * static_cast<float>(2 * units_per_EM);
 
-  int_path_ecm.extract_render_data(texel_distance, image_sz, max_distance, tr,
-                                   fastuidraw::CustomFillRuleFunction(fill_rule),
-                                   &output);
+  outline.m_path.extract_render_data(texel_distance, image_sz, max_distance, tr,
+                                     fastuidraw::CustomFillRuleFunction(fill_rule),
+                                     &output,
+                                     fastuidraw::t_max(1u, m_render_params.distance_field_threads()));
 }
 
 void
@@ -448,63 +692,123 @@ compute_rendering_data(uint32_t glyph_code,
                        fastuidraw::GlyphRenderDataCurvePair &output,
                        fastuidraw::Path &path)
 {
-  fastuidraw::detail::IntPath int_path_ecm;
-  int units_per_EM;
-  fastuidraw::ivec2 layout_offset;
-  int outline_flags;
+  ScalableOutline outline;
 
-  {
-    FaceGrabber p(this);
-    if (!p.m_p || !p.m_p->face())
-      {
-        return;
-      }
+  if (!load_curve_pair_outline(glyph_code, layout, outline))
+    {
+      return;
+    }
 
-    FT_Face face(p.m_p->face());
-    common_compute_rendering_data(face, m_p, layout, glyph_code);
-    units_per_EM = face->units_per_EM;
-    outline_flags = face->glyph->outline.flags;
-    layout_offset = fastuidraw::ivec2(face->glyph->metrics.horiBearingX,
-                                      face->glyph->metrics.horiBearingY);
-    layout_offset.y() -= face->glyph->metrics.height;
-    IntPathCreator::decompose_to_path(&face->glyph->outline, int_path_ecm);
-  }
+  if (outline.m_path.empty() || outline.m_image_size.x() == 0 || outline.m_image_size.y() == 0)
+    {
+      output.resize_active_curve_pair(fastuidraw::ivec2(0, 0));
+      return;
+    }
 
   /* choose the correct fill rule as according to outline_flags */
   enum fastuidraw::PainterEnums::fill_rule_t fill_rule;
-  fill_rule = (outline_flags & FT_OUTLINE_EVEN_ODD_FILL) ?
+  fill_rule = (outline.m_outline_flags & FT_OUTLINE_EVEN_ODD_FILL) ?
     fastuidraw::PainterEnums::odd_even_fill_rule:
     fastuidraw::PainterEnums::nonzero_fill_rule;
 
-  int pixel_size(m_render_params.curve_pair_pixel_size());
-  float scale_factor(static_cast<float>(pixel_size) / static_cast<float>(units_per_EM));
+  /* extract to a Path */
+  fastuidraw::detail::IntBezierCurve::transformation<float> identity_tr;
+  outline.m_path.add_to_path(identity_tr, &path);
 
-  /* compute how many pixels we need to store the glyph. */
-  fastuidraw::vec2 image_sz_f(layout.m_size * scale_factor);
-  fastuidraw::ivec2 image_sz(ceilf(image_sz_f.x()), ceilf(image_sz_f.y()));
+  /* extract render data*/
+  outline.m_path.extract_render_data(outline.m_texel_distance, outline.m_image_size, outline.m_tr,
+                                     fastuidraw::CustomFillRuleFunction(fill_rule),
+                                     &output);
+}
 
-  /* Use the same transformation as the DistanceField case */
-  int tr_scale(2 * pixel_size);
-  fastuidraw::ivec2 tr_translate(-2 * pixel_size * layout_offset);
-  fastuidraw::detail::IntBezierCurve::transformation<int> tr(tr_scale, tr_translate);
-  fastuidraw::ivec2 texel_distance(2 * units_per_EM);
-  float curvature_collapse(0.05f);
+void
+FontFreeTypePrivate::
+compute_path(fastuidraw::GlyphRender render, uint32_t glyph_code,
+             fastuidraw::Path &path)
+{
+  fastuidraw::GlyphLayoutData layout;
+  ScalableOutline outline;
+  fastuidraw::detail::IntBezierCurve::transformation<float> identity_tr;
 
-  int_path_ecm.filter(curvature_collapse, tr, texel_distance);
-  if (int_path_ecm.empty() || image_sz.x() == 0 || image_sz.y() == 0)
+  switch(render.m_type)
     {
-      output.resize_active_curve_pair(fastuidraw::ivec2(0, 0));
-      return;
+    case fastuidraw::coverage_glyph:
+      {
+        FaceGrabber p(this);
+        if (p.m_p && p.m_p->face())
+          {
+            FT_Face face(p.m_p->face());
+            font_coordinate_converter C(face, render.m_pixel_size);
+
+            FT_Set_Pixel_Sizes(face, render.m_pixel_size, render.m_pixel_size);
+            FT_Load_Glyph(face, glyph_code, FT_LOAD_DEFAULT | FT_LOAD_IGNORE_TRANSFORM);
+            IntPathCreator::decompose_to_path(&face->glyph->outline, path, C);
+          }
+      }
+      break;
+
+    case fastuidraw::distance_field_glyph:
+      if (load_distance_field_outline(glyph_code, layout, outline)
+          && !outline.m_path.empty())
+        {
+          outline.m_path.add_to_path(identity_tr, &path);
+        }
+      break;
+
+    case fastuidraw::curve_pair_glyph:
+      if (load_curve_pair_outline(glyph_code, layout, outline)
+          && !outline.m_path.empty()
+          && outline.m_image_size.x() != 0
+          && outline.m_image_size.y() != 0)
+        {
+          outline.m_path.add_to_path(identity_tr, &path);
+        }
+      break;
+
+    default:
+      FASTUIDRAWassert(!"Invalid glyph type");
     }
+}
 
-  /* extract to a Path */
-  fastuidraw::detail::IntBezierCurve::transformation<float> identity_tr;
-  int_path_ecm.add_to_path(identity_tr, &path);
+uint64_t
+FontFreeTypePrivate::
+persistent_id(void)
+{
+  fastuidraw::autolock_mutex m(m_persistent_id_mutex);
 
-  /* extract render data*/
-  int_path_ecm.extract_render_data(texel_distance, image_sz, tr,
-                                   fastuidraw::CustomFillRuleFunction(fill_rule),
-                                    &output);
+  if (!m_persistent_id_ready)
+    {
+      FaceGrabber p(this);
+
+      m_persistent_id_ready = true;
+      m_persistent_id = 0;
+      if (p.m_p && p.m_p->face())
+        {
+          FT_Face face(p.m_p->face());
+          FT_ULong length(0);
+          std::vector<FT_Byte> bytes;
+
+          /* a tag value of 0 loads the entire font file,
+           * which is only supported for SFNT fonts; fonts
+           * of other formats get a persistent_id() of 0.
+           */
+          if (FT_Load_Sfnt_Table(face, 0, 0, nullptr, &length) == 0 && length > 0)
+            {
+              bytes.resize(length);
+              FT_Load_Sfnt_Table(face, 0, 0, &bytes[0], &length);
+              m_persistent_id = hash_bytes(&bytes[0], bytes.size(), fnv1a_offset_basis);
+              m_persistent_id = hash_value(length, m_persistent_id);
+              m_persistent_id = hash_value(face->face_index, m_persistent_id);
+              m_persistent_id = hash_value(m_render_params.distance_field_pixel_size(), m_persistent_id);
+              m_persistent_id = hash_value(m_render_params.distance_field_max_distance(), m_persistent_id);
+              m_persistent_id = hash_value(m_render_params.curve_pair_pixel_size(), m_persistent_id);
+
+              /* 0 is reserved to mean no persistent_id */
+              m_persistent_id = fastuidraw::t_max(m_persistent_id, uint64_t(1));
+            }
+        }
+    }
+  return m_persistent_id;
 }
 
 /////////////////////////////////////////////
@@ -542,6 +846,12 @@ setget_implement(fastuidraw::FontFreeType::RenderParams,
 setget_implement(fastuidraw::FontFreeType::RenderParams,
                  RenderParamsPrivate,
                  unsigned int, curve_pair_pixel_size)
+setget_implement(fastuidraw::FontFreeType::RenderParams,
+                 RenderParamsPrivate,
+                 unsigned int, number_faces)
+setget_implement(fastuidraw::FontFreeType::RenderParams,
+                 RenderParamsPrivate,
+                 unsigned int, distance_field_threads)
 
 ///////////////////////////////////////////////////
 // fastuidraw::FontFreeType methods
@@ -646,6 +956,50 @@ compute_rendering_data(GlyphRender render, uint32_t glyph_code,
     }
 }
 
+void
+fastuidraw::FontFreeType::
+compute_path(GlyphRender render, uint32_t glyph_code, Path &path) const
+{
+  FontFreeTypePrivate *d;
+  d = static_cast<FontFreeTypePrivate*>(m_d);
+  d->compute_path(render, glyph_code, path);
+}
+
+uint64_t
+fastuidraw::FontFreeType::
+persistent_id(void) const
+{
+  FontFreeTypePrivate *d;
+  d = static_cast<FontFreeTypePrivate*>(m_d);
+  return d->persistent_id();
+}
+
+bool
+fastuidraw::FontFreeType::
+compute_character_coverage(CharacterCoverage &dst) const
+{
+  FontFreeTypePrivate *d;
+  d = static_cast<FontFreeTypePrivate*>(m_d);
+
+  FontFreeTypePrivate::FaceGrabber p(d);
+  if (!p.m_p || !p.m_p->face())
+    {
+      return false;
+    }
+
+  FT_Face face(p.m_p->face());
+  FT_ULong character_code;
+  FT_UInt glyphcode;
+
+  for(character_code = FT_Get_First_Char(face, &glyphcode);
+      glyphcode != 0;
+      character_code = FT_Get_Next_Char(face, character_code, &glyphcode))
+    {
+      dst.add(character_code);
+    }
+  return true;
+}
+
 const fastuidraw::FontFreeType::RenderParams&
 fastuidraw::FontFreeType::
 render_params(void) const
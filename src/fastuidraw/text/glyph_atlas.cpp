@@ -87,7 +87,10 @@ namespace
                       fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasGeometryBackingStoreBase> pgeometry_store):
       m_texel_store(ptexel_store),
       m_geometry_store(pgeometry_store),
-      m_geometry_data_allocator(pgeometry_store->size())
+      m_geometry_data_allocator(pgeometry_store->size()),
+      m_number_texels_allocated(0),
+      m_geometry_data_allocated(0),
+      m_number_failed_allocations(0)
     {
       FASTUIDRAWassert(m_texel_store);
       FASTUIDRAWassert(m_geometry_store);
@@ -113,6 +116,11 @@ namespace
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasGeometryBackingStoreBase> m_geometry_store;
     std::vector<fastuidraw::reference_counted_ptr<rect_atlas_layer> > m_private_data;
     fastuidraw::interval_allocator m_geometry_data_allocator;
+
+    /* fragmentation metrics */
+    unsigned int m_number_texels_allocated;
+    unsigned int m_geometry_data_allocated;
+    unsigned int m_number_failed_allocations;
   };
 }
 
@@ -323,10 +331,10 @@ allocate(fastuidraw::ivec2 size, c_array<const uint8_t> pdata,
     {
       int old_size;
 
-      /* TODO:
-       *   Should we reallocate on powers of 2, or one layer
-       *   at a time? [Right now we are doing one layer at
-       *   a time].
+      /* We add one layer at a time; a backing store is
+       * free to reserve more layers than requested so that
+       * adding layers one at a time is cheap (the GL backing
+       * stores grow their textures geometrically).
        */
       old_size = d->m_texel_store->dimensions().z();
       d->m_texel_store->resize(old_size + 1);
@@ -344,6 +352,11 @@ allocate(fastuidraw::ivec2 size, c_array<const uint8_t> pdata,
       return_value.m_opaque = r;
       d->m_texel_store->set_data(r->minX_minY().x(), r->minX_minY().y(), layer,
                                  size.x(), size.y(), pdata);
+      d->m_number_texels_allocated += r->size().x() * r->size().y();
+    }
+  else
+    {
+      ++d->m_number_failed_allocations;
     }
 
   return return_value;
@@ -353,12 +366,19 @@ void
 fastuidraw::GlyphAtlas::
 deallocate(fastuidraw::GlyphLocation G)
 {
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
   FASTUIDRAWassert(G.valid());
   const detail::RectAtlas::rectangle *r;
 
   r = static_cast<const detail::RectAtlas::rectangle*>(G.m_opaque);
   if (r != nullptr)
     {
+      autolock_mutex m(d->m_mutex);
+
+      FASTUIDRAWassert(d->m_number_texels_allocated >= static_cast<unsigned int>(r->size().x() * r->size().y()));
+      d->m_number_texels_allocated -= r->size().x() * r->size().y();
       detail::RectAtlas::delete_rectangle(r);
     }
 }
@@ -394,10 +414,12 @@ allocate_geometry_data(c_array<const generic_data> pdata)
         }
       else
         {
+          ++d->m_number_failed_allocations;
           return return_value;
         }
     }
 
+  d->m_geometry_data_allocated += block_count;
   d->m_geometry_store->set_values(return_value, pdata);
   return return_value;
 }
@@ -418,7 +440,9 @@ deallocate_geometry_data(int location, int count)
   autolock_mutex m(d->m_mutex);
 
   FASTUIDRAWassert(count > 0);
+  FASTUIDRAWassert(d->m_geometry_data_allocated >= static_cast<unsigned int>(count));
   d->m_geometry_data_allocator.free_interval(location, count);
+  d->m_geometry_data_allocated -= count;
 }
 
 
@@ -436,6 +460,63 @@ clear(void)
     {
       d->m_private_data[i]->clear();
     }
+  d->m_number_texels_allocated = 0;
+  d->m_geometry_data_allocated = 0;
+}
+
+unsigned int
+fastuidraw::GlyphAtlas::
+number_texels(void) const
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
+  ivec3 dims(d->m_texel_store->dimensions());
+  return dims.x() * dims.y() * dims.z();
+}
+
+unsigned int
+fastuidraw::GlyphAtlas::
+number_texels_allocated(void) const
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
+  autolock_mutex m(d->m_mutex);
+  return d->m_number_texels_allocated;
+}
+
+unsigned int
+fastuidraw::GlyphAtlas::
+geometry_data_allocated(void) const
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
+  autolock_mutex m(d->m_mutex);
+  return d->m_geometry_data_allocated;
+}
+
+unsigned int
+fastuidraw::GlyphAtlas::
+largest_free_geometry_data(void) const
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
+  autolock_mutex m(d->m_mutex);
+  return d->m_geometry_data_allocator.largest_free_interval();
+}
+
+unsigned int
+fastuidraw::GlyphAtlas::
+number_failed_allocations(void) const
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
+  autolock_mutex m(d->m_mutex);
+  return d->m_number_failed_allocations;
 }
 
 void
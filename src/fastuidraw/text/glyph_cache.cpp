@@ -17,10 +17,16 @@
  */
 
 
-#include <map>
+#include <unordered_map>
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <condition_variable>
 #include <fastuidraw/text/glyph_cache.hpp>
 #include <fastuidraw/text/glyph_render_data.hpp>
+#include <fastuidraw/text/glyph_disk_cache.hpp>
 #include "../private/util_private.hpp"
 
 
@@ -40,9 +46,24 @@ namespace
     void
     clear(void);
 
+    /* frees the allocations of the glyph on the atlas
+     * without touching the glyph data.
+     */
+    void
+    release_atlas_allocations(void);
+
     enum fastuidraw::return_code
     upload_to_atlas(void);
 
+    /* layout of the glyph that may be read by any thread */
+    const fastuidraw::GlyphLayoutData&
+    layout(void) const
+    {
+      return m_pending.load(std::memory_order_acquire) ?
+        m_pending_layout :
+        m_layout;
+    }
+
     /* owner
      */
     GlyphCachePrivate *m_cache;
@@ -62,9 +83,35 @@ namespace
     int m_geometry_offset, m_geometry_length;
     bool m_uploaded_to_atlas;
 
-    /* Path of the glyph
+    /* true if the glyph was uploaded to the atlas since it
+     * was created, i.e. an upload is a re-upload.
+     */
+    bool m_previously_uploaded;
+
+    /* value of GlyphCachePrivate::m_frame when the glyph was
+     * last fetched or uploaded; atomic because concurrent
+     * calls to fetch_glyph() update it.
+     */
+    std::atomic<uint64_t> m_last_use;
+
+    /* true while the glyph data is generated asynchronously,
+     * see GlyphCachePrivate::process_generated_glyphs().
+     */
+    std::atomic<bool> m_pending;
+
+    /* layout of a pending glyph, only the font and glyph code
+     * are set. It is set before the glyph is added to the cache
+     * and never changes afterwards, so that threads can read the
+     * layout of a pending glyph while m_layout is written.
+     */
+    fastuidraw::GlyphLayoutData m_pending_layout;
+
+    /* Path of the glyph; if the glyph data was loaded from
+     * a GlyphDiskCache, the path is only computed when first
+     * requested, under GlyphCachePrivate::m_path_mutex.
      */
     fastuidraw::Path m_path;
+    std::atomic<bool> m_path_pending;
 
     /* data to generate glyph data
      */
@@ -86,16 +133,95 @@ namespace
     {}
 
     bool
-    operator<(const GlyphSource &rhs) const
+    operator==(const GlyphSource &rhs) const
     {
-      return (m_font != rhs.m_font) ? m_font < rhs.m_font :
-        (m_glyph_code != rhs.m_glyph_code) ? m_glyph_code < rhs.m_glyph_code :
-        m_render < rhs.m_render;
+      return m_font == rhs.m_font
+        && m_glyph_code == rhs.m_glyph_code
+        && m_render == rhs.m_render;
+    }
+
+    /* hash value consistent with operator==, i.e. the pixel
+     * size only contributes for non-scalable glyph types.
+     */
+    size_t
+    hash(void) const
+    {
+      uint64_t v;
+
+      v = reinterpret_cast<uintptr_t>(m_font.get());
+      v = mix(v ^ m_glyph_code);
+      v = mix(v ^ m_render.m_type);
+      if (!fastuidraw::GlyphRender::scalable(m_render.m_type))
+        {
+          v = mix(v ^ static_cast<uint32_t>(m_render.m_pixel_size));
+        }
+      return static_cast<size_t>(v);
     }
 
     fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> m_font;
     uint32_t m_glyph_code;
     fastuidraw::GlyphRender m_render;
+
+  private:
+    /* 64-bit finalizer of MurmurHash3 */
+    static
+    uint64_t
+    mix(uint64_t v)
+    {
+      v ^= v >> 33u;
+      v *= 0xff51afd7ed558ccdull;
+      v ^= v >> 33u;
+      v *= 0xc4ceb9fe1a85ec53ull;
+      v ^= v >> 33u;
+      return v;
+    }
+  };
+
+  class GlyphSourceHash
+  {
+  public:
+    size_t
+    operator()(const GlyphSource &v) const
+    {
+      return v.hash();
+    }
+  };
+
+  /* The data of a glyph generated by a worker thread; the
+   * worker only writes to the job, the data is moved to the
+   * glyph by GlyphCachePrivate::process_generated_glyphs()
+   * so that the glyph is only modified by the thread that
+   * uploads glyphs.
+   */
+  class GenerationJob
+  {
+  public:
+    GenerationJob(GlyphDataPrivate *glyph, const GlyphSource &src):
+      m_glyph(glyph),
+      m_src(src),
+      m_path_pending(false),
+      m_glyph_data(nullptr)
+    {}
+
+    GlyphDataPrivate *m_glyph;
+    GlyphSource m_src;
+    fastuidraw::GlyphLayoutData m_layout;
+    fastuidraw::Path m_path;
+    bool m_path_pending;
+    fastuidraw::GlyphRenderData *m_glyph_data;
+  };
+
+  /* A shard of the hash table of GlyphCachePrivate,
+   * each shard has its own lock so that threads that
+   * fetch glyphs of different shards do not contend.
+   */
+  class GlyphCacheShard:fastuidraw::noncopyable
+  {
+  public:
+    typedef std::unordered_map<GlyphSource, GlyphDataPrivate*, GlyphSourceHash> map_type;
+
+    fastuidraw::mutex m_mutex;
+    map_type m_glyph_map;
   };
 
   class GlyphCachePrivate
@@ -113,14 +239,153 @@ namespace
      *   not have to regenerate data either.
      */
 
+    /* number of shards, a power of 2 */
+    enum { number_shards = 32 };
+
+    GlyphCacheShard&
+    shard(const GlyphSource &src)
+    {
+      /* the low bits of the hash select the bucket within
+       * the shard, use the high bits to select the shard.
+       */
+      return m_shards[(src.hash() >> 27u) & (number_shards - 1)];
+    }
+
+    /* Frees the atlas allocations of the least recently used
+     * glyphs that were not used in the current frame, until
+     * G can be uploaded. Returns routine_fail if G cannot be
+     * uploaded after evicting all such glyphs.
+     */
+    enum fastuidraw::return_code
+    evict_and_upload(GlyphDataPrivate *G);
+
+    /* generate the data of a glyph, using m_disk_cache */
+    fastuidraw::GlyphRenderData*
+    generate_glyph_data(const GlyphSource &src,
+                        fastuidraw::GlyphLayoutData &layout,
+                        fastuidraw::Path &path, bool &path_pending);
+
+    /* starts (or stops if number_threads is 0) the worker
+     * threads that generate glyph data asynchronously; the
+     * jobs already queued are completed first.
+     */
+    void
+    set_async_threads(unsigned int number_threads);
+
+    void
+    worker_loop(void);
+
+    /* waits until no job is queued or running */
+    void
+    wait_generation(void);
+
+    /* moves the data of the completed jobs to their glyphs
+     * and uploads the glyphs; returns the number of glyphs.
+     */
+    unsigned int
+    process_generated_glyphs(void);
+
+    /* deletes the completed job of G (or of all glyphs if
+     * G is nullptr) without moving the data to the glyph,
+     * wait_generation() must be called before.
+     */
+    void
+    discard_generated(GlyphDataPrivate *G);
+
+    /* returns a cleared GlyphDataPrivate of m_glyphs that is
+     * not in any shard, locks m_glyphs_mutex.
+     */
     GlyphDataPrivate*
-    fetch_or_allocate_glyph(GlyphSource src);
+    allocate_glyph(void);
+
+    /* clears the glyph and returns it to m_free_slots,
+     * locks m_glyphs_mutex.
+     */
+    void
+    free_glyph(GlyphDataPrivate *G);
 
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlas> m_atlas;
-    std::map<GlyphSource, GlyphDataPrivate*> m_glyph_map;
+    fastuidraw::reference_counted_ptr<fastuidraw::GlyphDiskCache> m_disk_cache;
+    GlyphCacheShard m_shards[number_shards];
+
+    fastuidraw::mutex m_glyphs_mutex;
     std::vector<GlyphDataPrivate*> m_glyphs;
+
+    /* Glyph::path() of a pending glyph */
+    fastuidraw::Path m_empty_path;
+
+    /* lock to compute a path requested by Glyph::path() */
+    fastuidraw::mutex m_path_mutex;
     std::vector<unsigned int> m_free_slots;
     fastuidraw::GlyphCache *m_p;
+
+    /* frame counter, see GlyphCache::begin_frame() */
+    std::atomic<uint64_t> m_frame;
+
+    /* statistics */
+    unsigned int m_number_evictions;
+    unsigned int m_number_reuploads;
+
+    /* work room for evict_and_upload() */
+    std::vector<GlyphDataPrivate*> m_eviction_candidates;
+
+    /* asynchronous generation; m_number_generating is the number
+     * of jobs queued or running.
+     */
+    fastuidraw::mutex m_async_mutex;
+    std::condition_variable_any m_job_available, m_job_done;
+    std::vector<std::thread> m_workers;
+    std::deque<GenerationJob*> m_queued_jobs;
+    std::vector<GenerationJob*> m_completed_jobs;
+    unsigned int m_number_generating;
+    bool m_stop_workers;
+  };
+
+  /* orders glyphs by decreasing size of their texel region,
+   * uploading the large regions first gives a tighter packing.
+   */
+  class CompareAtlasSize
+  {
+  public:
+    explicit
+    CompareAtlasSize(const std::vector<fastuidraw::ivec2> &sizes):
+      m_sizes(sizes)
+    {}
+
+    bool
+    operator()(const GlyphDataPrivate *lhs, const GlyphDataPrivate *rhs) const
+    {
+      const fastuidraw::ivec2 &l(m_sizes[lhs->m_cache_location]);
+      const fastuidraw::ivec2 &r(m_sizes[rhs->m_cache_location]);
+      int la(l.x() * l.y()), ra(r.x() * r.y());
+
+      if (la != ra)
+        {
+          return la > ra;
+        }
+      if (l.y() != r.y())
+        {
+          return l.y() > r.y();
+        }
+      return lhs->m_cache_location < rhs->m_cache_location;
+    }
+
+  private:
+    const std::vector<fastuidraw::ivec2> &m_sizes;
+  };
+
+  class CompareLastUse
+  {
+  public:
+    bool
+    operator()(const GlyphDataPrivate *lhs, const GlyphDataPrivate *rhs) const
+    {
+      uint64_t l, r;
+
+      l = lhs->m_last_use.load(std::memory_order_relaxed);
+      r = rhs->m_last_use.load(std::memory_order_relaxed);
+      return l < r || (l == r && lhs->m_cache_location < rhs->m_cache_location);
+    }
   };
 }
 
@@ -133,6 +398,10 @@ GlyphDataPrivate(GlyphCachePrivate *c, unsigned int I):
   m_geometry_offset(-1),
   m_geometry_length(0),
   m_uploaded_to_atlas(false),
+  m_previously_uploaded(false),
+  m_last_use(0),
+  m_pending(false),
+  m_path_pending(false),
   m_glyph_data(nullptr)
 {}
 
@@ -143,16 +412,17 @@ GlyphDataPrivate(void):
   m_geometry_offset(-1),
   m_geometry_length(0),
   m_uploaded_to_atlas(false),
+  m_previously_uploaded(false),
+  m_last_use(0),
+  m_pending(false),
+  m_path_pending(false),
   m_glyph_data(nullptr)
 {}
 
 void
 GlyphDataPrivate::
-clear(void)
+release_atlas_allocations(void)
 {
-  m_render = fastuidraw::GlyphRender();
-  FASTUIDRAWassert(!m_render.valid());
-
   if (m_cache)
     {
       if (m_atlas_location[0].valid())
@@ -174,14 +444,28 @@ clear(void)
           m_geometry_length = 0;
         }
     }
-
   m_uploaded_to_atlas = false;
+}
+
+void
+GlyphDataPrivate::
+clear(void)
+{
+  m_render = fastuidraw::GlyphRender();
+  FASTUIDRAWassert(!m_render.valid());
+
+  release_atlas_allocations();
+  m_previously_uploaded = false;
+  m_last_use.store(0, std::memory_order_relaxed);
+  m_pending.store(false, std::memory_order_relaxed);
+  m_pending_layout = fastuidraw::GlyphLayoutData();
   if (m_glyph_data)
     {
       FASTUIDRAWdelete(m_glyph_data);
       m_glyph_data = nullptr;
     }
   m_path.clear();
+  m_path_pending.store(false, std::memory_order_relaxed);
 }
 
 enum fastuidraw::return_code
@@ -196,12 +480,23 @@ upload_to_atlas(void)
    */
   enum fastuidraw::return_code return_value;
 
+  if (!m_cache)
+    {
+      return fastuidraw::routine_fail;
+    }
+
+  /* uploading a glyph marks it as used, see
+   * PainterGlyphRun::update_chunk().
+   */
+  m_last_use.store(m_cache->m_frame.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+
   if (m_uploaded_to_atlas)
     {
       return fastuidraw::routine_success;
     }
 
-  if (!m_cache)
+  if (m_pending.load(std::memory_order_acquire))
     {
       return fastuidraw::routine_fail;
     }
@@ -212,9 +507,19 @@ upload_to_atlas(void)
                                                m_atlas_location[1],
                                                m_geometry_offset,
                                                m_geometry_length);
+  if (return_value == fastuidraw::routine_fail)
+    {
+      return_value = m_cache->evict_and_upload(this);
+    }
+
   if (return_value == fastuidraw::routine_success)
     {
       m_uploaded_to_atlas = true;
+      if (m_previously_uploaded)
+        {
+          ++m_cache->m_number_reuploads;
+        }
+      m_previously_uploaded = true;
     }
 
   return return_value;
@@ -228,12 +533,20 @@ GlyphCachePrivate::
 GlyphCachePrivate(fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlas> patlas,
                   fastuidraw::GlyphCache *p):
   m_atlas(patlas),
-  m_p(p)
+  m_p(p),
+  m_frame(0),
+  m_number_evictions(0),
+  m_number_reuploads(0),
+  m_number_generating(0),
+  m_stop_workers(false)
 {}
 
 GlyphCachePrivate::
 ~GlyphCachePrivate()
 {
+  set_async_threads(0);
+  discard_generated(nullptr);
+
   for(unsigned int i = 0, endi = m_glyphs.size(); i < endi; ++i)
     {
       m_glyphs[i]->clear();
@@ -242,19 +555,229 @@ GlyphCachePrivate::
 }
 
 
-GlyphDataPrivate*
+enum fastuidraw::return_code
 GlyphCachePrivate::
-fetch_or_allocate_glyph(GlyphSource src)
+evict_and_upload(GlyphDataPrivate *G)
 {
-  std::map<GlyphSource, GlyphDataPrivate*>::iterator iter;
-  GlyphDataPrivate *G;
+  uint64_t frame(m_frame.load(std::memory_order_relaxed));
 
-  iter = m_glyph_map.find(src);
-  if (iter != m_glyph_map.end())
+  /* glyphs used in the current frame may already be referenced
+   * by attribute data of the frame, so their atlas locations
+   * must remain; the other uploaded glyphs are candidates.
+   */
+  m_eviction_candidates.clear();
+  m_glyphs_mutex.lock();
+  for(GlyphDataPrivate *q : m_glyphs)
+    {
+      if (q != G && q->m_uploaded_to_atlas
+          && q->m_last_use.load(std::memory_order_relaxed) < frame)
+        {
+          m_eviction_candidates.push_back(q);
+        }
+    }
+  m_glyphs_mutex.unlock();
+
+  std::sort(m_eviction_candidates.begin(), m_eviction_candidates.end(), CompareLastUse());
+
+  /* evict in batches of doubling size so that the number
+   * of upload attempts is logarithmic in the number of
+   * evicted glyphs.
+   */
+  for(unsigned int begin = 0, batch = 1, end = m_eviction_candidates.size();
+      begin < end; begin += batch, batch *= 2u)
+    {
+      enum fastuidraw::return_code R;
+
+      for(unsigned int i = begin, endi = fastuidraw::t_min(end, begin + batch); i < endi; ++i)
+        {
+          m_eviction_candidates[i]->release_atlas_allocations();
+          ++m_number_evictions;
+        }
+
+      R = G->m_glyph_data->upload_to_atlas(m_atlas,
+                                           G->m_atlas_location[0],
+                                           G->m_atlas_location[1],
+                                           G->m_geometry_offset,
+                                           G->m_geometry_length);
+      if (R == fastuidraw::routine_success)
+        {
+          return R;
+        }
+    }
+  return fastuidraw::routine_fail;
+}
+
+fastuidraw::GlyphRenderData*
+GlyphCachePrivate::
+generate_glyph_data(const GlyphSource &src,
+                    fastuidraw::GlyphLayoutData &layout,
+                    fastuidraw::Path &path, bool &path_pending)
+{
+  fastuidraw::GlyphRenderData *return_value(nullptr);
+
+  path_pending = false;
+  if (m_disk_cache)
+    {
+      return_value = m_disk_cache->fetch(src.m_render, src.m_font, src.m_glyph_code, layout);
+      path_pending = (return_value != nullptr);
+    }
+
+  if (!return_value)
+    {
+      fastuidraw::GlyphRender render(src.m_render);
+
+      return_value = src.m_font->compute_rendering_data(render, src.m_glyph_code, layout, path);
+      if (m_disk_cache && return_value && fastuidraw::GlyphRender::scalable(render.m_type))
+        {
+          m_disk_cache->store(render, src.m_font, src.m_glyph_code, layout, *return_value);
+        }
+    }
+  return return_value;
+}
+
+void
+GlyphCachePrivate::
+set_async_threads(unsigned int number_threads)
+{
+  if (number_threads == m_workers.size())
     {
-      return iter->second;
+      return;
     }
 
+  m_async_mutex.lock();
+  m_stop_workers = true;
+  m_async_mutex.unlock();
+  m_job_available.notify_all();
+
+  for(std::thread &t : m_workers)
+    {
+      t.join();
+    }
+  m_workers.clear();
+
+  FASTUIDRAWassert(m_queued_jobs.empty());
+  m_stop_workers = false;
+  for(unsigned int i = 0; i < number_threads; ++i)
+    {
+      m_workers.push_back(std::thread([this]() { worker_loop(); }));
+    }
+}
+
+void
+GlyphCachePrivate::
+worker_loop(void)
+{
+  m_async_mutex.lock();
+  for(;;)
+    {
+      GenerationJob *job;
+
+      /* the queue is drained before the workers stop */
+      while(m_queued_jobs.empty() && !m_stop_workers)
+        {
+          m_job_available.wait(m_async_mutex);
+        }
+
+      if (m_queued_jobs.empty())
+        {
+          break;
+        }
+
+      job = m_queued_jobs.front();
+      m_queued_jobs.pop_front();
+      m_async_mutex.unlock();
+
+      job->m_glyph_data = generate_glyph_data(job->m_src, job->m_layout,
+                                              job->m_path, job->m_path_pending);
+
+      m_async_mutex.lock();
+      m_completed_jobs.push_back(job);
+      --m_number_generating;
+      m_job_done.notify_all();
+    }
+  m_async_mutex.unlock();
+}
+
+void
+GlyphCachePrivate::
+wait_generation(void)
+{
+  m_async_mutex.lock();
+  while(m_number_generating > 0)
+    {
+      m_job_done.wait(m_async_mutex);
+    }
+  m_async_mutex.unlock();
+}
+
+unsigned int
+GlyphCachePrivate::
+process_generated_glyphs(void)
+{
+  std::vector<GenerationJob*> jobs;
+
+  m_async_mutex.lock();
+  std::swap(jobs, m_completed_jobs);
+  m_async_mutex.unlock();
+
+  for(GenerationJob *job : jobs)
+    {
+      GlyphDataPrivate *G(job->m_glyph);
+
+      FASTUIDRAWassert(G->m_pending);
+      FASTUIDRAWassert(!G->m_glyph_data);
+
+      /* other threads do not read m_layout and m_path of a
+       * pending glyph (see Glyph::layout() and Glyph::path()),
+       * the release of m_pending publishes them.
+       */
+      G->m_layout = job->m_layout;
+      G->m_path.swap(job->m_path);
+      G->m_path_pending.store(job->m_path_pending, std::memory_order_relaxed);
+      G->m_glyph_data = job->m_glyph_data;
+      G->m_pending.store(false, std::memory_order_release);
+
+      /* if the atlas is full, the upload is attempted again
+       * by PainterGlyphRun::update_chunk() when drawn.
+       */
+      G->upload_to_atlas();
+      FASTUIDRAWdelete(job);
+    }
+  return jobs.size();
+}
+
+void
+GlyphCachePrivate::
+discard_generated(GlyphDataPrivate *G)
+{
+  fastuidraw::autolock_mutex m(m_async_mutex);
+
+  for(unsigned int i = 0; i < m_completed_jobs.size();)
+    {
+      GenerationJob *job(m_completed_jobs[i]);
+      if (G == nullptr || job->m_glyph == G)
+        {
+          if (job->m_glyph_data)
+            {
+              FASTUIDRAWdelete(job->m_glyph_data);
+            }
+          FASTUIDRAWdelete(job);
+          m_completed_jobs[i] = m_completed_jobs.back();
+          m_completed_jobs.pop_back();
+        }
+      else
+        {
+          ++i;
+        }
+    }
+}
+
+GlyphDataPrivate*
+GlyphCachePrivate::
+allocate_glyph(void)
+{
+  fastuidraw::autolock_mutex m(m_glyphs_mutex);
+  GlyphDataPrivate *G;
 
   if (m_free_slots.empty())
     {
@@ -269,12 +792,31 @@ fetch_or_allocate_glyph(GlyphSource src)
       G = m_glyphs[v];
       FASTUIDRAWassert(!G->m_render.valid());
     }
-  m_glyph_map[src] = G;
   return G;
 }
 
+void
+GlyphCachePrivate::
+free_glyph(GlyphDataPrivate *G)
+{
+  G->clear();
+
+  fastuidraw::autolock_mutex m(m_glyphs_mutex);
+  m_free_slots.push_back(G->m_cache_location);
+}
+
 ///////////////////////////////////////////////////////
 // fastuidraw::Glyph methods
+bool
+fastuidraw::Glyph::
+pending(void) const
+{
+  GlyphDataPrivate *p;
+  p = static_cast<GlyphDataPrivate*>(m_opaque);
+  FASTUIDRAWassert(p != nullptr);
+  return p->m_pending.load(std::memory_order_acquire);
+}
+
 enum fastuidraw::glyph_type
 fastuidraw::Glyph::
 type(void) const
@@ -302,7 +844,7 @@ layout(void) const
   GlyphDataPrivate *p;
   p = static_cast<GlyphDataPrivate*>(m_opaque);
   FASTUIDRAWassert(p != nullptr && p->m_render.valid());
-  return p->m_layout;
+  return p->layout();
 }
 
 fastuidraw::reference_counted_ptr<fastuidraw::GlyphCache>
@@ -372,6 +914,20 @@ path(void) const
   GlyphDataPrivate *p;
   p = static_cast<GlyphDataPrivate*>(m_opaque);
   FASTUIDRAWassert(p != nullptr && p->m_render.valid());
+  if (p->m_pending.load(std::memory_order_acquire))
+    {
+      return p->m_cache->m_empty_path;
+    }
+
+  if (p->m_path_pending.load(std::memory_order_acquire))
+    {
+      autolock_mutex m(p->m_cache->m_path_mutex);
+      if (p->m_path_pending.load(std::memory_order_relaxed))
+        {
+          p->m_layout.m_font->compute_path(p->m_render, p->m_layout.m_glyph_code, p->m_path);
+          p->m_path_pending.store(false, std::memory_order_release);
+        }
+    }
   return p->m_path;
 }
 
@@ -437,17 +993,72 @@ fetch_glyph(GlyphRender render,
 
   GlyphDataPrivate *q;
   GlyphSource src(font, glyph_code, render);
+  GlyphCacheShard &shard(d->shard(src));
+  GlyphCacheShard::map_type::iterator iter;
 
-  q = d->fetch_or_allocate_glyph(src);
+  {
+    autolock_mutex m(shard.m_mutex);
+    iter = shard.m_glyph_map.find(src);
+    if (iter != shard.m_glyph_map.end())
+      {
+        iter->second->m_last_use.store(d->m_frame.load(std::memory_order_relaxed),
+                                       std::memory_order_relaxed);
+        return Glyph(iter->second);
+      }
+  }
+
+  /* generating the glyph data can be expensive, so it is done
+   * without holding the lock of the shard; if another thread
+   * added the same glyph in the meantime, its glyph is used.
+   */
+  q = d->allocate_glyph();
+  q->m_render = render;
+  q->m_last_use.store(d->m_frame.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+  FASTUIDRAWassert(!q->m_glyph_data);
 
-  if (!q->m_render.valid())
+  if (!d->m_workers.empty())
     {
-      q->m_render = render;
-      FASTUIDRAWassert(!q->m_glyph_data);
-      q->m_glyph_data = font->compute_rendering_data(q->m_render, glyph_code, q->m_layout, q->m_path);
+      /* asynchronous: the glyph is added pending and its
+       * data is generated by a worker thread.
+       */
+      std::pair<GlyphCacheShard::map_type::iterator, bool> R;
+
+      q->m_pending.store(true, std::memory_order_relaxed);
+      q->m_pending_layout.m_font = font;
+      q->m_pending_layout.m_glyph_code = glyph_code;
+      shard.m_mutex.lock();
+      R = shard.m_glyph_map.insert(std::make_pair(src, q));
+      shard.m_mutex.unlock();
+
+      if (!R.second)
+        {
+          d->free_glyph(q);
+          return Glyph(R.first->second);
+        }
+
+      d->m_async_mutex.lock();
+      d->m_queued_jobs.push_back(FASTUIDRAWnew GenerationJob(q, src));
+      ++d->m_number_generating;
+      d->m_async_mutex.unlock();
+      d->m_job_available.notify_one();
+      return Glyph(q);
     }
 
-  return Glyph(q);
+  bool path_pending;
+
+  q->m_glyph_data = d->generate_glyph_data(src, q->m_layout, q->m_path, path_pending);
+  q->m_path_pending.store(path_pending, std::memory_order_relaxed);
+
+  autolock_mutex m(shard.m_mutex);
+  std::pair<GlyphCacheShard::map_type::iterator, bool> R;
+
+  R = shard.m_glyph_map.insert(std::make_pair(src, q));
+  if (!R.second)
+    {
+      d->free_glyph(q);
+    }
+  return Glyph(R.first->second);
 }
 
 enum fastuidraw::return_code
@@ -468,11 +1079,17 @@ add_glyph(Glyph glyph)
 
   GlyphCachePrivate *d;
   d = static_cast<GlyphCachePrivate*>(m_d);
-  if (d->m_glyph_map.find(src) != d->m_glyph_map.end())
+
+  GlyphCacheShard &shard(d->shard(src));
+  autolock_mutex m(shard.m_mutex);
+  if (!shard.m_glyph_map.insert(std::make_pair(src, g)).second)
     {
       return routine_fail;
     }
 
+  autolock_mutex mg(d->m_glyphs_mutex);
+  g->m_last_use.store(d->m_frame.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
   g->m_cache = d;
   g->m_cache_location = d->m_glyphs.size();
   d->m_glyphs.push_back(g);
@@ -493,10 +1110,110 @@ delete_glyph(Glyph G)
   FASTUIDRAWassert(p->m_cache == d);
   FASTUIDRAWassert(p->m_render.valid());
 
-  GlyphSource src(p->m_layout.m_font, p->m_layout.m_glyph_code, p->m_render);
-  d->m_glyph_map.erase(src);
-  p->clear();
-  d->m_free_slots.push_back(p->m_cache_location);
+  if (p->m_pending)
+    {
+      d->wait_generation();
+      d->discard_generated(p);
+    }
+
+  GlyphSource src(p->layout().m_font, p->layout().m_glyph_code, p->m_render);
+  GlyphCacheShard &shard(d->shard(src));
+
+  shard.m_mutex.lock();
+  shard.m_glyph_map.erase(src);
+  shard.m_mutex.unlock();
+
+  d->free_glyph(p);
+}
+
+void
+fastuidraw::GlyphCache::
+disk_cache(const reference_counted_ptr<GlyphDiskCache> &v)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  d->m_disk_cache = v;
+}
+
+const fastuidraw::reference_counted_ptr<fastuidraw::GlyphDiskCache>&
+fastuidraw::GlyphCache::
+disk_cache(void) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  return d->m_disk_cache;
+}
+
+void
+fastuidraw::GlyphCache::
+async_generation_threads(unsigned int v)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  d->set_async_threads(v);
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+async_generation_threads(void) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  return d->m_workers.size();
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+process_generated_glyphs(void)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  return d->process_generated_glyphs();
+}
+
+void
+fastuidraw::GlyphCache::
+wait_generated_glyphs(void)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  d->wait_generation();
+}
+
+void
+fastuidraw::GlyphCache::
+begin_frame(void)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  d->m_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t
+fastuidraw::GlyphCache::
+current_frame(void) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  return d->m_frame.load(std::memory_order_relaxed);
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+number_evictions(void) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  return d->m_number_evictions;
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+number_reuploads(void) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  return d->m_number_reuploads;
 }
 
 void
@@ -506,6 +1223,8 @@ clear_atlas(void)
   GlyphCachePrivate *d;
   d = static_cast<GlyphCachePrivate*>(m_d);
 
+  /* fetch_glyph() may add to m_glyphs concurrently */
+  autolock_mutex m(d->m_glyphs_mutex);
   d->m_atlas->clear();
   for(unsigned int i = 0, endi = d->m_glyphs.size(); i < endi; ++i)
     {
@@ -518,6 +1237,67 @@ clear_atlas(void)
 }
 
 
+enum fastuidraw::return_code
+fastuidraw::GlyphCache::
+compact_atlas(void)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  std::vector<GlyphDataPrivate*> live;
+  std::vector<ivec2> sizes;
+  enum return_code return_value(routine_success);
+
+  /* fetch_glyph() may add to m_glyphs concurrently; a glyph
+   * added after the live glyphs are collected is not uploaded
+   * and thus not affected by the compaction.
+   */
+  d->m_glyphs_mutex.lock();
+  sizes.resize(d->m_glyphs.size(), ivec2(0, 0));
+  for(GlyphDataPrivate *p : d->m_glyphs)
+    {
+      if (p->m_uploaded_to_atlas)
+        {
+          if (p->m_atlas_location[0].valid())
+            {
+              sizes[p->m_cache_location] = p->m_atlas_location[0].size();
+            }
+          live.push_back(p);
+        }
+    }
+  d->m_glyphs_mutex.unlock();
+
+  /* the glyphs keep their data, so instead of moving the
+   * texels within the backing store, the atlas is emptied
+   * and the live glyphs are uploaded again, which also
+   * regenerates the geometry data that refers to the
+   * location of the texels.
+   */
+  clear_atlas();
+  std::sort(live.begin(), live.end(), CompareAtlasSize(sizes));
+  for(GlyphDataPrivate *p : live)
+    {
+      enum return_code R;
+
+      FASTUIDRAWassert(p->m_glyph_data);
+      R = p->m_glyph_data->upload_to_atlas(d->m_atlas,
+                                           p->m_atlas_location[0],
+                                           p->m_atlas_location[1],
+                                           p->m_geometry_offset,
+                                           p->m_geometry_length);
+      if (R == routine_success)
+        {
+          p->m_uploaded_to_atlas = true;
+        }
+      else
+        {
+          return_value = routine_fail;
+        }
+    }
+
+  return return_value;
+}
+
 void
 fastuidraw::GlyphCache::
 clear_cache(void)
@@ -525,8 +1305,13 @@ clear_cache(void)
   GlyphCachePrivate *d;
   d = static_cast<GlyphCachePrivate*>(m_d);
 
+  d->wait_generation();
+  d->discard_generated(nullptr);
   d->m_atlas->clear();
-  d->m_glyph_map.clear();
+  for(GlyphCacheShard &shard : d->m_shards)
+    {
+      shard.m_glyph_map.clear();
+    }
 
   for(unsigned int i = 0, endi = d->m_glyphs.size(); i < endi; ++i)
     {
@@ -0,0 +1,606 @@
+/*!
+ * \file glyph_disk_cache.cpp
+ * \brief file glyph_disk_cache.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include <fastuidraw/text/glyph_disk_cache.hpp>
+#include <fastuidraw/text/glyph_render_data_distance_field.hpp>
+#include <fastuidraw/text/glyph_render_data_curve_pair.hpp>
+#include "../private/util_private.hpp"
+
+namespace
+{
+  /* Layout of the header of a glyph file, in units of uint32_t;
+   * the texel data follows the header and the geometry data
+   * follows the texel data at an offset aligned to 16 bytes.
+   * Increment file_version whenever the layout of the file or
+   * the generation of the glyph data changes.
+   */
+  enum header_field
+    {
+      header_magic,
+      header_version,
+      header_size,
+      header_font_id_low,
+      header_font_id_high,
+      header_glyph_type,
+      header_glyph_code,
+      header_geometry_entry_size,
+      header_horizontal_layout_offset_x,
+      header_horizontal_layout_offset_y,
+      header_vertical_layout_offset_x,
+      header_vertical_layout_offset_y,
+      header_size_x,
+      header_size_y,
+      header_advance_x,
+      header_advance_y,
+      header_units_per_EM,
+      header_resolution_x,
+      header_resolution_y,
+      header_texel_offset,
+      header_texel_bytes,
+      header_geometry_offset,
+      header_geometry_count,
+      header_file_size,
+
+      header_number_fields
+    };
+
+  enum
+    {
+      file_magic = 0x47495546u, /* "FUIG" */
+      file_version = 1u,
+      geometry_alignment = 16u,
+    };
+
+  class GlyphFile
+  {
+  public:
+    std::string m_name;
+    uint64_t m_size;
+    uint64_t m_mtime_ns;
+
+    bool
+    operator<(const GlyphFile &rhs) const
+    {
+      return m_mtime_ns < rhs.m_mtime_ns;
+    }
+  };
+
+  class GlyphDiskCachePrivate
+  {
+  public:
+    GlyphDiskCachePrivate(fastuidraw::c_string directory, uint64_t max_size_bytes);
+
+    std::string
+    filename(fastuidraw::GlyphRender render, uint64_t font_id, uint32_t glyph_code) const;
+
+    static
+    bool
+    is_glyph_file(const char *name);
+
+    /* scans the directory, returns the total size of the glyph
+     * files and, if files is non-null, their names, sizes and
+     * last modification times.
+     */
+    uint64_t
+    scan_directory(std::vector<GlyphFile> *files) const;
+
+    /* removes the oldest glyph files until the total size is at
+     * most 3/4 of m_max_size_bytes, m_mutex must be locked.
+     */
+    void
+    evict(void);
+
+    fastuidraw::GlyphRenderData*
+    load(const uint8_t *bytes, uint64_t length,
+         fastuidraw::GlyphRender render, uint64_t font_id,
+         uint32_t glyph_code, fastuidraw::GlyphLayoutData &layout);
+
+    std::string m_directory;
+    uint64_t m_max_size_bytes;
+    std::atomic<unsigned int> m_temp_counter;
+
+    mutable fastuidraw::mutex m_mutex;
+    uint64_t m_current_size_bytes;
+    unsigned int m_number_hits, m_number_misses;
+    unsigned int m_number_stores, m_number_evictions;
+  };
+}
+
+////////////////////////////////////////
+// GlyphDiskCachePrivate methods
+GlyphDiskCachePrivate::
+GlyphDiskCachePrivate(fastuidraw::c_string directory, uint64_t max_size_bytes):
+  m_directory(directory ? directory : "."),
+  m_max_size_bytes(max_size_bytes),
+  m_temp_counter(0),
+  m_current_size_bytes(0),
+  m_number_hits(0),
+  m_number_misses(0),
+  m_number_stores(0),
+  m_number_evictions(0)
+{
+  ::mkdir(m_directory.c_str(), 0755);
+  m_current_size_bytes = scan_directory(nullptr);
+}
+
+std::string
+GlyphDiskCachePrivate::
+filename(fastuidraw::GlyphRender render, uint64_t font_id, uint32_t glyph_code) const
+{
+  std::ostringstream str;
+
+  str << m_directory << "/" << std::hex << std::setfill('0') << std::setw(16)
+      << font_id << std::dec << "-" << render.m_type << "-" << glyph_code
+      << ".glyph";
+  return str.str();
+}
+
+bool
+GlyphDiskCachePrivate::
+is_glyph_file(const char *name)
+{
+  const char *ext(".glyph");
+  size_t len(std::strlen(name)), ext_len(std::strlen(ext));
+
+  return len > ext_len && std::strcmp(name + len - ext_len, ext) == 0;
+}
+
+uint64_t
+GlyphDiskCachePrivate::
+scan_directory(std::vector<GlyphFile> *files) const
+{
+  DIR *dir;
+  struct dirent *entry;
+  uint64_t return_value(0);
+
+  dir = ::opendir(m_directory.c_str());
+  if (!dir)
+    {
+      return 0;
+    }
+
+  while((entry = ::readdir(dir)) != nullptr)
+    {
+      struct stat st;
+      GlyphFile F;
+
+      if (!is_glyph_file(entry->d_name))
+        {
+          continue;
+        }
+
+      F.m_name = m_directory + "/" + entry->d_name;
+      if (::stat(F.m_name.c_str(), &st) != 0)
+        {
+          continue;
+        }
+
+      F.m_size = st.st_size;
+      F.m_mtime_ns = uint64_t(st.st_mtim.tv_sec) * 1000000000u + st.st_mtim.tv_nsec;
+      return_value += F.m_size;
+      if (files)
+        {
+          files->push_back(F);
+        }
+    }
+  ::closedir(dir);
+
+  return return_value;
+}
+
+void
+GlyphDiskCachePrivate::
+evict(void)
+{
+  std::vector<GlyphFile> files;
+
+  /* other processes may share the directory, so
+   * get the actual sizes from the directory.
+   */
+  m_current_size_bytes = scan_directory(&files);
+  std::sort(files.begin(), files.end());
+  for(unsigned int i = 0, endi = files.size();
+      i < endi && 4u * m_current_size_bytes > 3u * m_max_size_bytes; ++i)
+    {
+      if (::unlink(files[i].m_name.c_str()) == 0)
+        {
+          m_current_size_bytes -= files[i].m_size;
+          ++m_number_evictions;
+        }
+    }
+}
+
+fastuidraw::GlyphRenderData*
+GlyphDiskCachePrivate::
+load(const uint8_t *bytes, uint64_t length,
+     fastuidraw::GlyphRender render, uint64_t font_id,
+     uint32_t glyph_code, fastuidraw::GlyphLayoutData &layout)
+{
+  uint32_t H[header_number_fields];
+  fastuidraw::ivec2 res;
+  uint64_t texel_end, geometry_end, element_size, geometry_bytes;
+
+  if (length < sizeof(H))
+    {
+      return nullptr;
+    }
+
+  std::memcpy(H, bytes, sizeof(H));
+  if (H[header_magic] != file_magic
+      || H[header_version] != file_version
+      || H[header_size] != header_number_fields
+      || H[header_font_id_low] != uint32_t(font_id & 0xFFFFFFFFu)
+      || H[header_font_id_high] != uint32_t(font_id >> 32u)
+      || H[header_glyph_type] != uint32_t(render.m_type)
+      || H[header_glyph_code] != glyph_code
+      || H[header_geometry_entry_size] != sizeof(fastuidraw::GlyphRenderDataCurvePair::entry)
+      || H[header_file_size] != length)
+    {
+      return nullptr;
+    }
+
+  res = fastuidraw::ivec2(H[header_resolution_x], H[header_resolution_y]);
+  element_size = (render.m_type == fastuidraw::distance_field_glyph) ?
+    sizeof(uint8_t) : sizeof(uint16_t);
+  geometry_bytes = uint64_t(H[header_geometry_count]) * H[header_geometry_entry_size];
+  texel_end = uint64_t(H[header_texel_offset]) + H[header_texel_bytes];
+  geometry_end = uint64_t(H[header_geometry_offset]) + geometry_bytes;
+  if (H[header_texel_bytes] != element_size * res.x() * res.y()
+      || texel_end > length || geometry_end > length
+      || (render.m_type == fastuidraw::distance_field_glyph && H[header_geometry_count] != 0))
+    {
+      return nullptr;
+    }
+
+  layout.m_glyph_code = glyph_code;
+  layout.m_horizontal_layout_offset.x() = fastuidraw::unpack_float(H[header_horizontal_layout_offset_x]);
+  layout.m_horizontal_layout_offset.y() = fastuidraw::unpack_float(H[header_horizontal_layout_offset_y]);
+  layout.m_vertical_layout_offset.x() = fastuidraw::unpack_float(H[header_vertical_layout_offset_x]);
+  layout.m_vertical_layout_offset.y() = fastuidraw::unpack_float(H[header_vertical_layout_offset_y]);
+  layout.m_size.x() = fastuidraw::unpack_float(H[header_size_x]);
+  layout.m_size.y() = fastuidraw::unpack_float(H[header_size_y]);
+  layout.m_advance.x() = fastuidraw::unpack_float(H[header_advance_x]);
+  layout.m_advance.y() = fastuidraw::unpack_float(H[header_advance_y]);
+  layout.m_units_per_EM = fastuidraw::unpack_float(H[header_units_per_EM]);
+
+  if (render.m_type == fastuidraw::distance_field_glyph)
+    {
+      fastuidraw::GlyphRenderDataDistanceField *data;
+
+      data = FASTUIDRAWnew fastuidraw::GlyphRenderDataDistanceField();
+      data->resize(res);
+      if (H[header_texel_bytes] > 0)
+        {
+          std::memcpy(data->distance_values().c_ptr(),
+                      bytes + H[header_texel_offset], H[header_texel_bytes]);
+        }
+      return data;
+    }
+  else
+    {
+      fastuidraw::GlyphRenderDataCurvePair *data;
+
+      data = FASTUIDRAWnew fastuidraw::GlyphRenderDataCurvePair();
+      data->resize_active_curve_pair(res);
+      data->resize_geometry_data(H[header_geometry_count]);
+      if (H[header_texel_bytes] > 0)
+        {
+          std::memcpy(data->active_curve_pair().c_ptr(),
+                      bytes + H[header_texel_offset], H[header_texel_bytes]);
+        }
+      if (geometry_bytes > 0)
+        {
+          std::memcpy(static_cast<void*>(data->geometry_data().c_ptr()),
+                      bytes + H[header_geometry_offset], geometry_bytes);
+        }
+      return data;
+    }
+}
+
+////////////////////////////////////////
+// fastuidraw::GlyphDiskCache methods
+fastuidraw::GlyphDiskCache::
+GlyphDiskCache(c_string directory, uint64_t max_size_bytes)
+{
+  m_d = FASTUIDRAWnew GlyphDiskCachePrivate(directory, max_size_bytes);
+}
+
+fastuidraw::GlyphDiskCache::
+~GlyphDiskCache()
+{
+  GlyphDiskCachePrivate *d;
+  d = static_cast<GlyphDiskCachePrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+fastuidraw::c_string
+fastuidraw::GlyphDiskCache::
+directory(void) const
+{
+  GlyphDiskCachePrivate *d;
+  d = static_cast<GlyphDiskCachePrivate*>(m_d);
+  return d->m_directory.c_str();
+}
+
+uint64_t
+fastuidraw::GlyphDiskCache::
+max_size_bytes(void) const
+{
+  GlyphDiskCachePrivate *d;
+  d = static_cast<GlyphDiskCachePrivate*>(m_d);
+  return d->m_max_size_bytes;
+}
+
+uint64_t
+fastuidraw::GlyphDiskCache::
+current_size_bytes(void) const
+{
+  GlyphDiskCachePrivate *d;
+  d = static_cast<GlyphDiskCachePrivate*>(m_d);
+  autolock_mutex m(d->m_mutex);
+  return d->m_current_size_bytes;
+}
+
+fastuidraw::GlyphRenderData*
+fastuidraw::GlyphDiskCache::
+fetch(GlyphRender render,
+      const reference_counted_ptr<const FontBase> &font,
+      uint32_t glyph_code, GlyphLayoutData &layout)
+{
+  GlyphDiskCachePrivate *d;
+  d = static_cast<GlyphDiskCachePrivate*>(m_d);
+
+  uint64_t font_id;
+  GlyphRenderData *return_value(nullptr);
+
+  font_id = (font && GlyphRender::scalable(render.m_type)) ?
+    font->persistent_id() : 0u;
+
+  if (font_id != 0)
+    {
+      std::string name(d->filename(render, font_id, glyph_code));
+      int fd;
+
+      fd = ::open(name.c_str(), O_RDONLY);
+      if (fd != -1)
+        {
+          struct stat st;
+
+          if (::fstat(fd, &st) == 0 && st.st_size > 0)
+            {
+              void *ptr;
+
+              ptr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+              if (ptr != MAP_FAILED)
+                {
+                  return_value = d->load(static_cast<const uint8_t*>(ptr), st.st_size,
+                                         render, font_id, glyph_code, layout);
+                  ::munmap(ptr, st.st_size);
+                }
+            }
+
+          /* mark the file as recently used so that
+           * eviction removes it after older files.
+           */
+          if (return_value)
+            {
+              ::futimens(fd, nullptr);
+            }
+          ::close(fd);
+        }
+    }
+
+  if (return_value)
+    {
+      layout.m_font = font;
+    }
+
+  autolock_mutex m(d->m_mutex);
+  if (return_value)
+    {
+      ++d->m_number_hits;
+    }
+  else
+    {
+      ++d->m_number_misses;
+    }
+  return return_value;
+}
+
+enum fastuidraw::return_code
+fastuidraw::GlyphDiskCache::
+store(GlyphRender render,
+      const reference_counted_ptr<const FontBase> &font,
+      uint32_t glyph_code, const GlyphLayoutData &layout,
+      const GlyphRenderData &data)
+{
+  GlyphDiskCachePrivate *d;
+  d = static_cast<GlyphDiskCachePrivate*>(m_d);
+
+  uint64_t font_id;
+  font_id = (font && GlyphRender::scalable(render.m_type)) ?
+    font->persistent_id() : 0u;
+
+  if (font_id == 0)
+    {
+      return routine_fail;
+    }
+
+  uint32_t H[header_number_fields];
+  c_array<const uint8_t> texels;
+  c_array<const uint8_t> geometry;
+  ivec2 res;
+
+  H[header_geometry_count] = 0;
+  if (render.m_type == distance_field_glyph)
+    {
+      const GlyphRenderDataDistanceField &df(static_cast<const GlyphRenderDataDistanceField&>(data));
+      res = df.resolution();
+      texels = df.distance_values();
+    }
+  else
+    {
+      const GlyphRenderDataCurvePair &cp(static_cast<const GlyphRenderDataCurvePair&>(data));
+      c_array<const uint16_t> t(cp.active_curve_pair());
+      c_array<const GlyphRenderDataCurvePair::entry> g(cp.geometry_data());
+
+      res = cp.resolution();
+      if (!t.empty())
+        {
+          texels = c_array<const uint8_t>(reinterpret_cast<const uint8_t*>(t.c_ptr()),
+                                          t.size() * sizeof(uint16_t));
+        }
+      if (!g.empty())
+        {
+          geometry = c_array<const uint8_t>(reinterpret_cast<const uint8_t*>(g.c_ptr()),
+                                            g.size() * sizeof(GlyphRenderDataCurvePair::entry));
+        }
+      H[header_geometry_count] = g.size();
+    }
+
+  H[header_magic] = file_magic;
+  H[header_version] = file_version;
+  H[header_size] = header_number_fields;
+  H[header_font_id_low] = uint32_t(font_id & 0xFFFFFFFFu);
+  H[header_font_id_high] = uint32_t(font_id >> 32u);
+  H[header_glyph_type] = render.m_type;
+  H[header_glyph_code] = glyph_code;
+  H[header_geometry_entry_size] = sizeof(GlyphRenderDataCurvePair::entry);
+  H[header_horizontal_layout_offset_x] = pack_float(layout.m_horizontal_layout_offset.x());
+  H[header_horizontal_layout_offset_y] = pack_float(layout.m_horizontal_layout_offset.y());
+  H[header_vertical_layout_offset_x] = pack_float(layout.m_vertical_layout_offset.x());
+  H[header_vertical_layout_offset_y] = pack_float(layout.m_vertical_layout_offset.y());
+  H[header_size_x] = pack_float(layout.m_size.x());
+  H[header_size_y] = pack_float(layout.m_size.y());
+  H[header_advance_x] = pack_float(layout.m_advance.x());
+  H[header_advance_y] = pack_float(layout.m_advance.y());
+  H[header_units_per_EM] = pack_float(layout.m_units_per_EM);
+  H[header_resolution_x] = res.x();
+  H[header_resolution_y] = res.y();
+  H[header_texel_offset] = sizeof(H);
+  H[header_texel_bytes] = texels.size();
+  H[header_geometry_offset] = (sizeof(H) + texels.size() + geometry_alignment - 1u) & ~(geometry_alignment - 1u);
+  H[header_file_size] = H[header_geometry_offset] + geometry.size();
+
+  std::vector<uint8_t> bytes(H[header_file_size], 0);
+  std::memcpy(&bytes[0], H, sizeof(H));
+  if (!texels.empty())
+    {
+      std::memcpy(&bytes[H[header_texel_offset]], texels.c_ptr(), texels.size());
+    }
+  if (!geometry.empty())
+    {
+      std::memcpy(&bytes[H[header_geometry_offset]], geometry.c_ptr(), geometry.size());
+    }
+
+  /* write to a temporary file which is then renamed so
+   * that readers never see a partially written file.
+   */
+  std::ostringstream tmp_name;
+  std::string name(d->filename(render, font_id, glyph_code));
+  struct stat st;
+  uint64_t replaced_size(0);
+  int fd;
+  bool ok;
+
+  tmp_name << d->m_directory << "/.tmp-" << ::getpid() << "-" << d->m_temp_counter++;
+  fd = ::open(tmp_name.str().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1)
+    {
+      return routine_fail;
+    }
+
+  ok = (::write(fd, &bytes[0], bytes.size()) == static_cast<ssize_t>(bytes.size()));
+  ok = (::close(fd) == 0) && ok;
+  if (ok && ::stat(name.c_str(), &st) == 0)
+    {
+      replaced_size = st.st_size;
+    }
+  ok = ok && (::rename(tmp_name.str().c_str(), name.c_str()) == 0);
+  if (!ok)
+    {
+      ::unlink(tmp_name.str().c_str());
+      return routine_fail;
+    }
+
+  autolock_mutex m(d->m_mutex);
+  ++d->m_number_stores;
+  d->m_current_size_bytes += bytes.size();
+  d->m_current_size_bytes -= t_min(replaced_size, d->m_current_size_bytes);
+  if (d->m_current_size_bytes > d->m_max_size_bytes)
+    {
+      d->evict();
+    }
+  return routine_success;
+}
+
+unsigned int
+fastuidraw::GlyphDiskCache::
+number_hits(void) const
+{
+  GlyphDiskCachePrivate *d;
+  d = static_cast<GlyphDiskCachePrivate*>(m_d);
+  autolock_mutex m(d->m_mutex);
+  return d->m_number_hits;
+}
+
+unsigned int
+fastuidraw::GlyphDiskCache::
+number_misses(void) const
+{
+  GlyphDiskCachePrivate *d;
+  d = static_cast<GlyphDiskCachePrivate*>(m_d);
+  autolock_mutex m(d->m_mutex);
+  return d->m_number_misses;
+}
+
+unsigned int
+fastuidraw::GlyphDiskCache::
+number_stores(void) const
+{
+  GlyphDiskCachePrivate *d;
+  d = static_cast<GlyphDiskCachePrivate*>(m_d);
+  autolock_mutex m(d->m_mutex);
+  return d->m_number_stores;
+}
+
+unsigned int
+fastuidraw::GlyphDiskCache::
+number_evictions(void) const
+{
+  GlyphDiskCachePrivate *d;
+  d = static_cast<GlyphDiskCachePrivate*>(m_d);
+  autolock_mutex m(d->m_mutex);
+  return d->m_number_evictions;
+}
@@ -19,52 +19,290 @@
 
 #include <set>
 #include <map>
+#include <atomic>
 
 #include <fastuidraw/text/glyph_selector.hpp>
 #include "../private/util_private.hpp"
 
+/* Thread safety of GlyphSelector: only adding fonts and loading
+ * fonts from FontGeneratorBase objects lock the mutex of the
+ * GlyphSelector, fetching fonts, groups and glyphs do not lock.
+ * For this,
+ *  - the maps from FontProperties to font_group are copied on
+ *    write; readers use an immutable copy published atomically.
+ *  - the fonts of a font_group are stored in append_only_array
+ *    objects which readers access without locking.
+ *  - the resolution of a character code within a font_group is
+ *    cached in a table whose entries are single atomic values.
+ * The font_group objects, the published maps and the storage
+ * of the append_only_array objects are only freed when the
+ * GlyphSelector is destroyed, so that a reader never sees
+ * freed memory.
+ */
+
 namespace
 {
+  /* An array to which a single writer (serialized by the caller)
+   * appends and which readers access without locking. Elements
+   * are never modified after being appended. When the storage is
+   * full, a storage of twice the size is made and the old storage
+   * is kept until the append_only_array is destroyed.
+   */
+  template<typename T>
+  class append_only_array:fastuidraw::noncopyable
+  {
+  public:
+    append_only_array(void):
+      m_current(nullptr)
+    {}
+
+    ~append_only_array()
+    {
+      for(storage *s : m_storages)
+        {
+          FASTUIDRAWdelete(s);
+        }
+    }
+
+    fastuidraw::c_array<const T>
+    elements(void) const
+    {
+      const storage *s;
+      unsigned int sz;
+
+      s = m_current.load(std::memory_order_acquire);
+      if (!s)
+        {
+          return fastuidraw::c_array<const T>();
+        }
+
+      sz = s->m_size.load(std::memory_order_acquire);
+      return fastuidraw::make_c_array(s->m_elements).sub_array(0, sz);
+    }
+
+    void
+    push_back(const T &v)
+    {
+      storage *s;
+      unsigned int sz;
+
+      s = m_current.load(std::memory_order_relaxed);
+      sz = (s) ? s->m_size.load(std::memory_order_relaxed) : 0u;
+      if (!s || sz == s->m_elements.size())
+        {
+          storage *n;
+
+          n = FASTUIDRAWnew storage(fastuidraw::t_max(4u, 2u * sz));
+          for(unsigned int i = 0; i < sz; ++i)
+            {
+              n->m_elements[i] = s->m_elements[i];
+            }
+          n->m_size.store(sz, std::memory_order_relaxed);
+          m_storages.push_back(n);
+          m_current.store(n, std::memory_order_release);
+          s = n;
+        }
+
+      s->m_elements[sz] = v;
+      s->m_size.store(sz + 1u, std::memory_order_release);
+    }
+
+  private:
+    class storage
+    {
+    public:
+      explicit
+      storage(unsigned int capacity):
+        m_elements(capacity),
+        m_size(0)
+      {}
+
+      std::vector<T> m_elements;
+      std::atomic<unsigned int> m_size;
+    };
+
+    std::atomic<storage*> m_current;
+    std::vector<storage*> m_storages;
+  };
+
+  /* the font of a glyph_source points into the storage of
+   * an append_only_array (or to the font passed by the caller),
+   * so that fetching a glyph does not modify the reference
+   * count of the font.
+   */
   class glyph_source
   {
   public:
     glyph_source(void):
-      m_font(),
+      m_font(nullptr),
       m_glyph_code(0)
     {}
 
-    glyph_source(const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &f,
+    glyph_source(const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> *f,
                  uint32_t g):
       m_font(f),
       m_glyph_code(g)
     {}
 
-    fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> m_font;
+    const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> *m_font;
     uint32_t m_glyph_code;
   };
 
-  class font_group:public fastuidraw::reference_counted<font_group>::non_concurrent
+  /* a font together with its CharacterCoverage, the coverage
+   * is nullptr if the font does not compute it.
+   */
+  class font_entry
+  {
+  public:
+    font_entry(void)
+    {}
+
+    explicit
+    font_entry(const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &f);
+
+    /* returns the glyph code of a character code, only calling
+     * into the font if the coverage has the character code.
+     */
+    uint32_t
+    glyph_code(uint32_t character_code) const
+    {
+      return (!m_coverage || m_coverage->contains(character_code)) ?
+        m_font->glyph_code(character_code) :
+        0u;
+    }
+
+    fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> m_font;
+    fastuidraw::reference_counted_ptr<const fastuidraw::CharacterCoverage> m_coverage;
+  };
+
+  /* A cache of the resolution of (character code, glyph_type)
+   * within the fonts of a font_group (not including its parent).
+   * Each entry is a single atomic value, packed as:
+   *  - bits  0-31: character code
+   *  - bits 32-33: glyph_type
+   *  - bit     34: 1 if a font of the group has the character
+   *  - bits 35-46: if found, the index of the font, otherwise
+   *                the number of fonts searched
+   *  - bits 47-62: glyph code
+   *  - bit     63: 1 if the entry is used
+   * Entries are read and written without locking; a write may
+   * replace the entry another thread wrote, which only means a
+   * later lookup is a miss. The fonts of a group are only ever
+   * appended, so an entry for a found character stays correct;
+   * an entry for a character not found is only used if the
+   * group has the same number of fonts and no unused generators.
+   */
+  class resolution_cache:fastuidraw::noncopyable
+  {
+  public:
+    enum
+      {
+        log2_number_entries = 10,
+        number_entries = 1u << log2_number_entries,
+        max_index = 0xFFFu,
+        max_glyph_code = 0xFFFFu,
+      };
+
+    resolution_cache(void)
+    {
+      for(auto &e : m_entries)
+        {
+          e.store(0u, std::memory_order_relaxed);
+        }
+    }
+
+    /* returns true if an entry for the character code
+     * is present, in which case writes its values.
+     */
+    bool
+    fetch(uint32_t character_code, enum fastuidraw::glyph_type tp,
+          bool &found, unsigned int &index, uint32_t &glyph_code) const
+    {
+      uint64_t v;
+
+      v = m_entries[slot(character_code, tp)].load(std::memory_order_acquire);
+      if ((v & valid_bit) == 0u
+          || uint32_t(v) != character_code
+          || ((v >> 32u) & 3u) != uint64_t(tp))
+        {
+          return false;
+        }
+
+      found = (v & found_bit) != 0u;
+      index = (v >> 35u) & max_index;
+      glyph_code = (v >> 47u) & max_glyph_code;
+      return true;
+    }
+
+    void
+    store(uint32_t character_code, enum fastuidraw::glyph_type tp,
+          bool found, unsigned int index, uint32_t glyph_code)
+    {
+      uint64_t v;
+
+      if (!cacheable(tp) || index > max_index || glyph_code > max_glyph_code)
+        {
+          return;
+        }
+
+      v = valid_bit
+        | uint64_t(character_code)
+        | (uint64_t(tp) << 32u)
+        | (found ? found_bit : 0u)
+        | (uint64_t(index) << 35u)
+        | (uint64_t(glyph_code) << 47u);
+      m_entries[slot(character_code, tp)].store(v, std::memory_order_release);
+    }
+
+    static
+    bool
+    cacheable(enum fastuidraw::glyph_type tp)
+    {
+      return uint32_t(tp) < 4u;
+    }
+
+  private:
+    static const uint64_t valid_bit = uint64_t(1u) << 63u;
+    static const uint64_t found_bit = uint64_t(1u) << 34u;
+
+    static
+    unsigned int
+    slot(uint32_t character_code, enum fastuidraw::glyph_type tp)
+    {
+      uint32_t h;
+
+      h = (character_code ^ (uint32_t(tp) << 24u)) * 2654435761u;
+      return h >> (32u - log2_number_entries);
+    }
+
+    std::atomic<uint64_t> m_entries[number_entries];
+  };
+
+  class font_group:fastuidraw::noncopyable
   {
   public:
     typedef fastuidraw::FontBase FontBase;
     typedef fastuidraw::GlyphSelector GlyphSelector;
     typedef GlyphSelector::FontGeneratorBase FontGeneratorBase;
 
-    explicit
-    font_group(fastuidraw::reference_counted_ptr<font_group> p);
+    font_group(font_group *parent, fastuidraw::mutex &mutex);
 
+    ~font_group();
+
+    /* to be called with the mutex locked */
     enum fastuidraw::return_code
-    add_font(fastuidraw::reference_counted_ptr<const FontBase> h);
+    add_font(const font_entry &h);
 
+    /* to be called with the mutex locked */
     enum fastuidraw::return_code
-    add_font(fastuidraw::reference_counted_ptr<const FontGeneratorBase> h);
+    add_font(const fastuidraw::reference_counted_ptr<const FontGeneratorBase> &h);
 
     glyph_source
     fetch_glyph(uint32_t character_code,
                 enum fastuidraw::glyph_type tp,
                 bool skip_parent);
 
-    const fastuidraw::reference_counted_ptr<font_group>&
+    font_group*
     parent(void) const
     {
       return m_parent;
@@ -76,7 +314,7 @@ namespace
     fastuidraw::c_array<const fastuidraw::reference_counted_ptr<const FontBase> >
     fonts(void) const
     {
-      return fastuidraw::make_c_array(m_fonts);
+      return m_fonts.elements();
     }
 
     fastuidraw::c_array<const fastuidraw::reference_counted_ptr<const FontGeneratorBase> >
@@ -86,35 +324,69 @@ namespace
     }
 
   private:
-    fastuidraw::reference_counted_ptr<const fastuidraw::FontBase>
+    /* to be called with the mutex locked */
+    const font_entry*
     use_unused_generator(void);
 
+    /* to be called with the mutex locked */
+    void
+    push_font(const font_entry &h);
+
+    /* searches the fonts of the group, returning in number_searched
+     * the number of fonts of the group searched if the character
+     * code is not found.
+     */
+    glyph_source
+    fetch_glyph_from_fonts(uint32_t character_code,
+                           enum fastuidraw::glyph_type tp,
+                           unsigned int &index,
+                           unsigned int &number_searched);
+
+    resolution_cache&
+    cache(void);
+
+    /* the mutex of the GlyphSelectorPrivate */
+    fastuidraw::mutex &m_mutex;
+
+    /* only accessed with the mutex locked */
     std::set<fastuidraw::reference_counted_ptr<const FontGeneratorBase> > m_gen_set;
     std::set<fastuidraw::reference_counted_ptr<const FontBase> > m_font_set;
-
     std::vector<fastuidraw::reference_counted_ptr<const FontGeneratorBase> > m_gens_unused;
-    std::vector<fastuidraw::reference_counted_ptr<const FontBase> > m_fonts;
-    fastuidraw::reference_counted_ptr<font_group> m_parent;
+
+    /* the size of m_gens_unused, readable without the lock */
+    std::atomic<unsigned int> m_number_gens_unused;
+
+    append_only_array<fastuidraw::reference_counted_ptr<const FontBase> > m_fonts;
+    append_only_array<font_entry> m_entries;
+    font_group *m_parent;
+
+    /* created on first use */
+    std::atomic<resolution_cache*> m_cache;
   };
 
   template<typename key_type>
   class font_group_map:
-    public std::map<key_type, fastuidraw::reference_counted_ptr<font_group> >
+    public std::map<key_type, font_group*>
   {
   public:
-    typedef std::map<key_type, fastuidraw::reference_counted_ptr<font_group> > base_class;
+    typedef std::map<key_type, font_group*> base_class;
 
-    fastuidraw::reference_counted_ptr<font_group>
-    get_create(const key_type &key, fastuidraw::reference_counted_ptr<font_group> parent)
+    /* to be called with the mutex locked */
+    font_group*
+    get_create(const key_type &key, font_group *parent,
+               std::vector<font_group*> &groups,
+               fastuidraw::mutex &mutex, bool &created)
     {
       typename base_class::iterator iter;
-      fastuidraw::reference_counted_ptr<font_group> return_value;
+      font_group *return_value;
 
       iter = this->find(key);
       if (iter == this->end())
         {
-          return_value = FASTUIDRAWnew font_group(parent);
+          return_value = FASTUIDRAWnew font_group(parent, mutex);
+          groups.push_back(return_value);
           this->operator[](key) = return_value;
+          created = true;
         }
       else
         {
@@ -124,17 +396,17 @@ namespace
       return return_value;
     }
 
-    fastuidraw::reference_counted_ptr<font_group>
-    fetch_group(const key_type &key)
+    font_group*
+    fetch_group(const key_type &key) const
     {
-      typename base_class::iterator iter;
+      typename base_class::const_iterator iter;
 
       iter = this->find(key);
       if (iter != this->end())
         {
           return iter->second;
         }
-      return fastuidraw::reference_counted_ptr<font_group>();
+      return nullptr;
     }
   };
 
@@ -182,68 +454,152 @@ namespace
     {}
   };
 
+  class group_maps
+  {
+  public:
+    font_group_map<style_bold_italic_key> m_style_bold_italic_groups;
+    font_group_map<family_style_bold_italic_key> m_family_style_bold_italic_groups;
+    font_group_map<foundry_family_style_bold_italic_key> m_foundry_family_style_bold_italic_groups;
+  };
+
   class GlyphSelectorPrivate
   {
   public:
     GlyphSelectorPrivate(fastuidraw::reference_counted_ptr<fastuidraw::GlyphCache> h);
 
-    fastuidraw::reference_counted_ptr<font_group>
-    fetch_font_group_no_lock(const fastuidraw::FontProperties &prop,
-                             bool exact_match);
+    ~GlyphSelectorPrivate();
+
+    /* returns the most recent copy of m_maps, making
+     * the copy if m_maps changed since the last copy.
+     */
+    const group_maps&
+    published_maps(void);
+
+    font_group*
+    fetch_font_group(const fastuidraw::FontProperties &prop,
+                     bool exact_match);
 
     glyph_source
-    fetch_glyph_helper(fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> h,
+    fetch_glyph_helper(const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &h,
                        uint32_t character_code, enum fastuidraw::glyph_type tp,
                        bool exact_match);
 
     fastuidraw::Glyph
-    fetch_glyph_no_lock(fastuidraw::GlyphRender tp,
-                        fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> h,
-                        uint32_t character_code, bool exact_match);
+    fetch_glyph(fastuidraw::GlyphRender tp,
+                const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &h,
+                uint32_t character_code, bool exact_match);
 
     fastuidraw::Glyph
-    fetch_glyph_no_lock(fastuidraw::GlyphRender tp,
-                        fastuidraw::reference_counted_ptr<font_group> group,
-                        uint32_t character_code, bool exact_match);
+    fetch_glyph(fastuidraw::GlyphRender tp, font_group *group,
+                uint32_t character_code, bool exact_match);
 
     fastuidraw::Glyph
-    fetch_glyph_no_merging_no_lock(fastuidraw::GlyphRender tp,
-                                   fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> h,
-                                   uint32_t character_code);
+    fetch_glyph_no_merging(fastuidraw::GlyphRender tp,
+                           const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &h,
+                           uint32_t character_code);
 
+    /* to be called with m_mutex locked */
     template<typename T>
     void
-    add_font_no_lock(const fastuidraw::FontProperties &props, const T &h);
+    add_font_locked(const fastuidraw::FontProperties &props, const T &h);
 
     fastuidraw::mutex m_mutex;
-    fastuidraw::reference_counted_ptr<font_group> m_master_group;
-    font_group_map<style_bold_italic_key> m_style_bold_italic_groups;
-    font_group_map<family_style_bold_italic_key> m_family_style_bold_italic_groups;
-    font_group_map<foundry_family_style_bold_italic_key> m_foundry_family_style_bold_italic_groups;
+    font_group *m_master_group;
+
+    /* every font_group made, freed at dtor */
+    std::vector<font_group*> m_groups;
+
+    /* only accessed with m_mutex locked */
+    group_maps m_maps;
+
+    /* copies of m_maps published to readers, all
+     * are kept until dtor; a copy is only made when
+     * m_maps changed and a reader fetches a group.
+     */
+    std::vector<group_maps*> m_published_maps;
+    std::atomic<const group_maps*> m_current_maps;
+    std::atomic<bool> m_maps_dirty;
 
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphCache> m_cache;
   };
 }
 
+///////////////////////////////////
+// font_entry methods
+font_entry::
+font_entry(const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &f):
+  m_font(f)
+{
+  fastuidraw::reference_counted_ptr<fastuidraw::CharacterCoverage> C;
+
+  C = FASTUIDRAWnew fastuidraw::CharacterCoverage();
+  if (m_font->compute_character_coverage(*C))
+    {
+      m_coverage = C;
+    }
+}
 
 ///////////////////////////////////
 // font_group methods
 font_group::
-font_group(fastuidraw::reference_counted_ptr<font_group> parent):
-  m_parent(parent)
+font_group(font_group *parent, fastuidraw::mutex &mutex):
+  m_mutex(mutex),
+  m_number_gens_unused(0),
+  m_parent(parent),
+  m_cache(nullptr)
 {
 }
 
-enum fastuidraw::return_code
 font_group::
-add_font(fastuidraw::reference_counted_ptr<const FontBase> h)
+~font_group()
 {
-  std::pair<std::set<fastuidraw::reference_counted_ptr<const FontBase> >::iterator, bool> R;
-  R = m_font_set.insert(h);
+  resolution_cache *c;
 
-  if (R.second)
+  c = m_cache.load(std::memory_order_relaxed);
+  if (c)
+    {
+      FASTUIDRAWdelete(c);
+    }
+}
+
+resolution_cache&
+font_group::
+cache(void)
+{
+  resolution_cache *c;
+
+  c = m_cache.load(std::memory_order_acquire);
+  if (!c)
+    {
+      resolution_cache *expected(nullptr);
+
+      c = FASTUIDRAWnew resolution_cache();
+      if (!m_cache.compare_exchange_strong(expected, c, std::memory_order_acq_rel))
+        {
+          /* another thread made the cache first */
+          FASTUIDRAWdelete(c);
+          c = expected;
+        }
+    }
+  return *c;
+}
+
+void
+font_group::
+push_font(const font_entry &h)
+{
+  m_font_set.insert(h.m_font);
+  m_entries.push_back(h);
+  m_fonts.push_back(h.m_font);
+}
+
+enum fastuidraw::return_code
+font_group::
+add_font(const font_entry &h)
+{
+  if (m_font_set.find(h.m_font) == m_font_set.end())
     {
-      m_fonts.push_back(h);
+      push_font(h);
       return fastuidraw::routine_success;
     }
   else
@@ -254,7 +610,7 @@ add_font(fastuidraw::reference_counted_ptr<const FontBase> h)
 
 enum fastuidraw::return_code
 font_group::
-add_font(fastuidraw::reference_counted_ptr<const FontGeneratorBase> h)
+add_font(const fastuidraw::reference_counted_ptr<const FontGeneratorBase> &h)
 {
   std::pair<std::set<fastuidraw::reference_counted_ptr<const FontGeneratorBase> >::iterator, bool> R;
   R = m_gen_set.insert(h);
@@ -262,6 +618,7 @@ add_font(fastuidraw::reference_counted_ptr<const FontGeneratorBase> h)
   if (R.second)
     {
       m_gens_unused.push_back(h);
+      m_number_gens_unused.store(m_gens_unused.size(), std::memory_order_release);
       return fastuidraw::routine_success;
     }
   else
@@ -274,17 +631,25 @@ fastuidraw::reference_counted_ptr<const fastuidraw::FontBase>
 font_group::
 first_font(void)
 {
-  while(m_fonts.empty() && !m_gens_unused.empty())
+  fastuidraw::c_array<const font_entry> entries;
+
+  entries = m_entries.elements();
+  if (entries.empty() && m_number_gens_unused.load(std::memory_order_acquire) != 0u)
     {
-      use_unused_generator();
+      fastuidraw::autolock_mutex m(m_mutex);
+      while(m_entries.elements().empty() && !m_gens_unused.empty())
+        {
+          use_unused_generator();
+        }
+      entries = m_entries.elements();
     }
 
-  return m_fonts.empty() ?
+  return entries.empty() ?
     fastuidraw::reference_counted_ptr<const fastuidraw::FontBase>() :
-    m_fonts.front();
+    entries.front().m_font;
 }
 
-fastuidraw::reference_counted_ptr<const fastuidraw::FontBase>
+const font_entry*
 font_group::
 use_unused_generator(void)
 {
@@ -298,84 +663,216 @@ use_unused_generator(void)
   f = g->generate_font();
   if (f)
     {
-      m_font_set.insert(f);
-      m_fonts.push_back(f);
+      push_font(font_entry(f));
     }
 
-  return f;
+  /* the font is added before the generator is no longer
+   * counted as unused, see fetch_glyph_from_fonts().
+   */
+  m_number_gens_unused.store(m_gens_unused.size(), std::memory_order_release);
+  return (f) ? &m_entries.elements().back() : nullptr;
 }
 
 glyph_source
 font_group::
-fetch_glyph(uint32_t character_code, enum fastuidraw::glyph_type tp,
-            bool skip_parent)
+fetch_glyph_from_fonts(uint32_t character_code, enum fastuidraw::glyph_type tp,
+                       unsigned int &index, unsigned int &number_searched)
 {
+  fastuidraw::c_array<const font_entry> entries;
+  unsigned int start(0), number_gens_unused;
   uint32_t r;
 
-  for(const auto &font : m_fonts)
+  /* the number of unused generators is read before the fonts;
+   * a generated font is added before the number is decremented,
+   * so if the number read is zero, the fonts read include every
+   * generated font.
+   */
+  number_gens_unused = m_number_gens_unused.load(std::memory_order_acquire);
+  entries = m_entries.elements();
+  for(unsigned int i = 0; i < entries.size(); ++i)
+    {
+      if (entries[i].m_font->can_create_rendering_data(tp))
+        {
+          r = entries[i].glyph_code(character_code);
+          if (r)
+            {
+              index = i;
+              return glyph_source(&entries[i].m_font, r);
+            }
+        }
+    }
+
+  if (number_gens_unused == 0u)
     {
-      if (font->can_create_rendering_data(tp))
+      number_searched = entries.size();
+      return glyph_source();
+    }
+
+  fastuidraw::autolock_mutex m(m_mutex);
+
+  /* fonts may have been added, or generated by another
+   * thread, since the fonts were searched.
+   */
+  start = entries.size();
+  entries = m_entries.elements();
+  for(unsigned int i = start; i < entries.size(); ++i)
+    {
+      if (entries[i].m_font->can_create_rendering_data(tp))
         {
-          r = font->glyph_code(character_code);
+          r = entries[i].glyph_code(character_code);
           if (r)
             {
-              return glyph_source(font, r);
+              index = i;
+              return glyph_source(&entries[i].m_font, r);
             }
         }
     }
 
   while(!m_gens_unused.empty())
     {
-      fastuidraw::reference_counted_ptr<const FontBase> f;
+      const font_entry *f;
 
       f = use_unused_generator();
-      if (f && f->can_create_rendering_data(tp))
+      if (f && f->m_font->can_create_rendering_data(tp))
         {
           r = f->glyph_code(character_code);
           if (r)
             {
-              return glyph_source(f, r);
+              index = m_entries.elements().size() - 1u;
+              return glyph_source(&f->m_font, r);
             }
         }
     }
 
-  if (m_parent && !skip_parent)
+  number_searched = m_entries.elements().size();
+  return glyph_source();
+}
+
+glyph_source
+font_group::
+fetch_glyph(uint32_t character_code, enum fastuidraw::glyph_type tp,
+            bool skip_parent)
+{
+  glyph_source return_value;
+  bool found, hit(false);
+  unsigned int index;
+  uint32_t glyph_code;
+
+  if (resolution_cache::cacheable(tp)
+      && cache().fetch(character_code, tp, found, index, glyph_code))
+    {
+      fastuidraw::c_array<const font_entry> entries;
+      unsigned int number_gens_unused;
+
+      /* same order of reads as in fetch_glyph_from_fonts() */
+      number_gens_unused = m_number_gens_unused.load(std::memory_order_acquire);
+      entries = m_entries.elements();
+      if (found)
+        {
+          FASTUIDRAWassert(index < entries.size());
+          return_value = glyph_source(&entries[index].m_font, glyph_code);
+          hit = true;
+        }
+      else
+        {
+          hit = (index == entries.size() && number_gens_unused == 0u);
+        }
+    }
+
+  if (!hit)
+    {
+      unsigned int number_searched(0);
+
+      index = 0;
+      return_value = fetch_glyph_from_fonts(character_code, tp, index, number_searched);
+      if (resolution_cache::cacheable(tp))
+        {
+          if (return_value.m_font)
+            {
+              cache().store(character_code, tp, true, index, return_value.m_glyph_code);
+            }
+          else
+            {
+              cache().store(character_code, tp, false, number_searched, 0);
+            }
+        }
+    }
+
+  if (!return_value.m_font && m_parent && !skip_parent)
     {
       return m_parent->fetch_glyph(character_code, tp, false);
     }
 
-  return glyph_source();
+  return return_value;
 }
 
 ////////////////////////////////////
 // GlyphSelectorPrivate methods
 GlyphSelectorPrivate::
 GlyphSelectorPrivate(fastuidraw::reference_counted_ptr<fastuidraw::GlyphCache> h):
+  m_current_maps(nullptr),
+  m_maps_dirty(true),
   m_cache(h)
 {
-  m_master_group = FASTUIDRAWnew font_group(fastuidraw::reference_counted_ptr<font_group>());
+  m_master_group = FASTUIDRAWnew font_group(nullptr, m_mutex);
+  m_groups.push_back(m_master_group);
+}
+
+GlyphSelectorPrivate::
+~GlyphSelectorPrivate()
+{
+  for(font_group *g : m_groups)
+    {
+      FASTUIDRAWdelete(g);
+    }
+
+  for(group_maps *m : m_published_maps)
+    {
+      FASTUIDRAWdelete(m);
+    }
+}
+
+const group_maps&
+GlyphSelectorPrivate::
+published_maps(void)
+{
+  if (m_maps_dirty.load(std::memory_order_acquire))
+    {
+      fastuidraw::autolock_mutex m(m_mutex);
+      if (m_maps_dirty.load(std::memory_order_relaxed))
+        {
+          group_maps *p;
+
+          p = FASTUIDRAWnew group_maps(m_maps);
+          m_published_maps.push_back(p);
+          m_current_maps.store(p, std::memory_order_release);
+          m_maps_dirty.store(false, std::memory_order_release);
+        }
+    }
+  return *m_current_maps.load(std::memory_order_acquire);
 }
 
-fastuidraw::reference_counted_ptr<font_group>
+font_group*
 GlyphSelectorPrivate::
-fetch_font_group_no_lock(const fastuidraw::FontProperties &prop,
-                         bool exact_match)
+fetch_font_group(const fastuidraw::FontProperties &prop,
+                 bool exact_match)
 {
-  fastuidraw::reference_counted_ptr<font_group> return_value;
+  const group_maps &maps(published_maps());
+  font_group *return_value;
 
-  return_value = m_foundry_family_style_bold_italic_groups.fetch_group(prop);
+  return_value = maps.m_foundry_family_style_bold_italic_groups.fetch_group(prop);
   if (return_value || exact_match)
     {
       return return_value;
     }
 
-  return_value = m_family_style_bold_italic_groups.fetch_group(prop);
+  return_value = maps.m_family_style_bold_italic_groups.fetch_group(prop);
   if (return_value)
     {
       return return_value;
     }
 
-  return_value = m_style_bold_italic_groups.fetch_group(prop);
+  return_value = maps.m_style_bold_italic_groups.fetch_group(prop);
   if (return_value)
     {
       return return_value;
@@ -387,7 +884,7 @@ fetch_font_group_no_lock(const fastuidraw::FontProperties &prop,
 
 glyph_source
 GlyphSelectorPrivate::
-fetch_glyph_helper(fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> h,
+fetch_glyph_helper(const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &h,
                    uint32_t character_code, enum fastuidraw::glyph_type tp, bool exact_match)
 {
   glyph_source return_value;
@@ -400,15 +897,16 @@ fetch_glyph_helper(fastuidraw::reference_counted_ptr<const fastuidraw::FontBase>
 
   if (r)
     {
-      return_value = glyph_source(h, r);
+      return_value = glyph_source(&h, r);
     }
   else
     {
-      font_group_map<foundry_family_style_bold_italic_key>::const_iterator iter;
-      iter = m_foundry_family_style_bold_italic_groups.find(h->properties());
-      if (iter != m_foundry_family_style_bold_italic_groups.end())
+      font_group *g;
+
+      g = published_maps().m_foundry_family_style_bold_italic_groups.fetch_group(h->properties());
+      if (g)
         {
-          return_value = iter->second->fetch_glyph(character_code, tp, exact_match);
+          return_value = g->fetch_glyph(character_code, tp, exact_match);
         }
     }
   return return_value;
@@ -416,9 +914,9 @@ fetch_glyph_helper(fastuidraw::reference_counted_ptr<const fastuidraw::FontBase>
 
 fastuidraw::Glyph
 GlyphSelectorPrivate::
-fetch_glyph_no_merging_no_lock(fastuidraw::GlyphRender tp,
-                               fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> h,
-                               uint32_t character_code)
+fetch_glyph_no_merging(fastuidraw::GlyphRender tp,
+                       const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &h,
+                       uint32_t character_code)
 {
   if (!h || !tp.valid())
     {
@@ -444,9 +942,9 @@ fetch_glyph_no_merging_no_lock(fastuidraw::GlyphRender tp,
 
 fastuidraw::Glyph
 GlyphSelectorPrivate::
-fetch_glyph_no_lock(fastuidraw::GlyphRender tp,
-                    fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> h,
-                    uint32_t character_code, bool exact_match)
+fetch_glyph(fastuidraw::GlyphRender tp,
+            const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &h,
+            uint32_t character_code, bool exact_match)
 {
   glyph_source src;
 
@@ -458,7 +956,7 @@ fetch_glyph_no_lock(fastuidraw::GlyphRender tp,
   src = fetch_glyph_helper(h, character_code, tp.m_type, exact_match);
   if (src.m_font)
     {
-      return m_cache->fetch_glyph(tp, src.m_font, src.m_glyph_code);
+      return m_cache->fetch_glyph(tp, *src.m_font, src.m_glyph_code);
     }
   else
     {
@@ -468,9 +966,8 @@ fetch_glyph_no_lock(fastuidraw::GlyphRender tp,
 
 fastuidraw::Glyph
 GlyphSelectorPrivate::
-fetch_glyph_no_lock(fastuidraw::GlyphRender tp,
-                    fastuidraw::reference_counted_ptr<font_group> group,
-                    uint32_t character_code, bool exact_match)
+fetch_glyph(fastuidraw::GlyphRender tp, font_group *group,
+            uint32_t character_code, bool exact_match)
 {
   glyph_source src;
 
@@ -478,7 +975,7 @@ fetch_glyph_no_lock(fastuidraw::GlyphRender tp,
   src = group->fetch_glyph(character_code, tp.m_type, exact_match);
   if (src.m_font)
     {
-      return m_cache->fetch_glyph(tp, src.m_font, src.m_glyph_code);
+      return m_cache->fetch_glyph(tp, *src.m_font, src.m_glyph_code);
     }
   else
     {
@@ -489,24 +986,33 @@ fetch_glyph_no_lock(fastuidraw::GlyphRender tp,
 template<typename T>
 void
 GlyphSelectorPrivate::
-add_font_no_lock(const fastuidraw::FontProperties &props, const T &h)
+add_font_locked(const fastuidraw::FontProperties &props, const T &h)
 {
   enum fastuidraw::return_code R;
+  bool created(false);
 
-  fastuidraw::reference_counted_ptr<font_group> parent;
+  font_group *parent;
   parent = m_master_group;
   R = parent->add_font(h);
   if (R == fastuidraw::routine_success)
     {
-      parent = m_style_bold_italic_groups.get_create(props, parent);
+      parent = m_maps.m_style_bold_italic_groups.get_create(props, parent, m_groups,
+                                                            m_mutex, created);
       parent->add_font(h);
 
-      parent = m_family_style_bold_italic_groups.get_create(props, parent);
+      parent = m_maps.m_family_style_bold_italic_groups.get_create(props, parent, m_groups,
+                                                                   m_mutex, created);
       parent->add_font(h);
 
-      parent = m_foundry_family_style_bold_italic_groups.get_create(props, parent);
+      parent = m_maps.m_foundry_family_style_bold_italic_groups.get_create(props, parent, m_groups,
+                                                                           m_mutex, created);
       parent->add_font(h);
     }
+
+  if (created)
+    {
+      m_maps_dirty.store(true, std::memory_order_release);
+    }
 }
 
 ///////////////////////////////////////////////
@@ -572,8 +1078,10 @@ add_font(reference_counted_ptr<const FontBase> h)
   GlyphSelectorPrivate *d;
   d = static_cast<GlyphSelectorPrivate*>(m_d);
 
+  /* compute the coverage of the font before taking the lock */
+  font_entry entry(h);
   autolock_mutex m(d->m_mutex);
-  d->add_font_no_lock(h->properties(), h);
+  d->add_font_locked(h->properties(), entry);
 }
 
 void
@@ -589,7 +1097,7 @@ add_font_generator(reference_counted_ptr<const FontGeneratorBase> h)
   d = static_cast<GlyphSelectorPrivate*>(m_d);
 
   autolock_mutex m(d->m_mutex);
-  d->add_font_no_lock(h->font_properties(), h);
+  d->add_font_locked(h->font_properties(), h);
 }
 
 fastuidraw::reference_counted_ptr<const fastuidraw::FontBase>
@@ -597,67 +1105,13 @@ fastuidraw::GlyphSelector::
 fetch_font(const FontProperties &prop, bool exact_match)
 {
   GlyphSelectorPrivate *d;
-  d = static_cast<GlyphSelectorPrivate*>(m_d);
-
-  autolock_mutex m(d->m_mutex);
-  return d->fetch_font_group_no_lock(prop, exact_match)->first_font();
-}
-
-fastuidraw::Glyph
-fastuidraw::GlyphSelector::
-fetch_glyph_no_merging_no_lock(GlyphRender tp,
-                               reference_counted_ptr<const FontBase> h,
-                               uint32_t character_code)
-{
-  GlyphSelectorPrivate *d;
-  d = static_cast<GlyphSelectorPrivate*>(m_d);
-  return d->fetch_glyph_no_merging_no_lock(tp, h, character_code);
-}
+  font_group *g;
 
-fastuidraw::Glyph
-fastuidraw::GlyphSelector::
-fetch_glyph_no_lock(GlyphRender tp,
-                    reference_counted_ptr<const FontBase> h,
-                    uint32_t character_code, bool exact_match)
-{
-  GlyphSelectorPrivate *d;
-  d = static_cast<GlyphSelectorPrivate*>(m_d);
-  return d->fetch_glyph_no_lock(tp, h, character_code, exact_match);
-}
-
-void
-fastuidraw::GlyphSelector::
-lock_mutex(void)
-{
-  GlyphSelectorPrivate *d;
   d = static_cast<GlyphSelectorPrivate*>(m_d);
-  d->m_mutex.lock();
-}
-
-void
-fastuidraw::GlyphSelector::
-unlock_mutex(void)
-{
-  GlyphSelectorPrivate *d;
-  d = static_cast<GlyphSelectorPrivate*>(m_d);
-  d->m_mutex.unlock();
-}
-
-fastuidraw::Glyph
-fastuidraw::GlyphSelector::
-fetch_glyph_no_lock(GlyphRender tp, FontGroup group,
-                    uint32_t character_code, bool exact_match)
-{
-  GlyphSelectorPrivate *d;
-  d = static_cast<GlyphSelectorPrivate*>(m_d);
-
-  reference_counted_ptr<font_group> p;
-  p = reference_counted_ptr<font_group>(static_cast<font_group*>(group.m_d));
-  if (!p)
-    {
-      p = d->m_master_group;
-    }
-  return d->fetch_glyph_no_lock(tp, p, character_code, exact_match);
+  g = d->fetch_font_group(prop, exact_match);
+  return (g) ?
+    g->first_font() :
+    reference_counted_ptr<const FontBase>();
 }
 
 fastuidraw::GlyphSelector::FontGroup
@@ -665,15 +1119,10 @@ fastuidraw::GlyphSelector::
 fetch_group(const FontProperties &props, bool exact_match)
 {
   FontGroup return_value;
-  reference_counted_ptr<font_group> h;
-
   GlyphSelectorPrivate *d;
-  d = static_cast<GlyphSelectorPrivate*>(m_d);
-
-  autolock_mutex m(d->m_mutex);
-  h = d->fetch_font_group_no_lock(props, exact_match);
-  return_value.m_d = h.get();
 
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  return_value.m_d = d->fetch_font_group(props, exact_match);
   return return_value;
 }
 
@@ -683,25 +1132,30 @@ fetch_glyph(GlyphRender tp, const FontProperties &props,
             uint32_t character_code, bool exact_match)
 {
   GlyphSelectorPrivate *d;
-  reference_counted_ptr<font_group> g;
+  font_group *g;
 
   d = static_cast<GlyphSelectorPrivate*>(m_d);
-
-  autolock_mutex m(d->m_mutex);
-  g = d->fetch_font_group_no_lock(props, exact_match);
-  return d->fetch_glyph_no_lock(tp, g, character_code, exact_match);
+  g = d->fetch_font_group(props, exact_match);
+  return (g) ?
+    d->fetch_glyph(tp, g, character_code, exact_match) :
+    Glyph();
 }
 
 fastuidraw::Glyph
 fastuidraw::GlyphSelector::
-fetch_glyph(GlyphRender tp, FontGroup h,
+fetch_glyph(GlyphRender tp, FontGroup group,
             uint32_t character_code, bool exact_match)
 {
-  Glyph G;
-  lock_mutex();
-  G = fetch_glyph_no_lock(tp, h, character_code, exact_match);
-  unlock_mutex();
-  return G;
+  GlyphSelectorPrivate *d;
+  font_group *g;
+
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  g = static_cast<font_group*>(group.m_d);
+  if (!g)
+    {
+      g = d->m_master_group;
+    }
+  return d->fetch_glyph(tp, g, character_code, exact_match);
 }
 
 fastuidraw::Glyph
@@ -709,20 +1163,16 @@ fastuidraw::GlyphSelector::
 fetch_glyph(GlyphRender tp, reference_counted_ptr<const FontBase> h,
             uint32_t character_code, bool exact_match)
 {
-  Glyph G;
-  lock_mutex();
-  G = fetch_glyph_no_lock(tp, h, character_code, exact_match);
-  unlock_mutex();
-  return G;
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  return d->fetch_glyph(tp, h, character_code, exact_match);
 }
 
 fastuidraw::Glyph
 fastuidraw::GlyphSelector::
 fetch_glyph_no_merging(GlyphRender tp, reference_counted_ptr<const FontBase> h, uint32_t character_code)
 {
-  Glyph G;
-  lock_mutex();
-  G = fetch_glyph_no_merging_no_lock(tp, h, character_code);
-  unlock_mutex();
-  return G;
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  return d->fetch_glyph_no_merging(tp, h, character_code);
 }